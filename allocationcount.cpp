@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------
+// ALLOCATIONCOUNT.CPP
+// Implementation for allocationCount
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// allocationCount: the number of blocks allocated so far by the program
+// and allows other features:
+//      --measuring the allocations of a piece of code as the difference of
+//        the count before and after it, as benchmark.cpp does
+//
+// Implementation and assumptions:
+//      --linking allocationcount.cpp replaces every form of the global
+//        operator new and operator delete, plain, array, nothrow, sized and
+//        aligned, so each allocation is counted and each block goes back
+//        to the allocator it came from
+//      --the replacements are kept out of the files that use containers,
+//        where the compiler would see malloc and free paired with new and
+//        delete
+//----------------------------------------------------------------------------
+
+#include "allocationcount.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// Blocks allocated through every form of operator new
+static atomic<long> allocations(0);
+
+//----------------------------------------------------------------------------
+// allocate
+// Preconditions:   Alignment is a power of 2
+// Postconditions:  Returns a counted block of at least the given bytes, or
+//                  nullptr if there is no memory
+static void* allocate(size_t bytes, size_t alignment) {
+    allocations++;
+    if(bytes == 0) {
+        bytes = 1;
+    }
+    if(alignment <= alignof(max_align_t)) {
+        return malloc(bytes);
+    }
+    // aligned_alloc needs a multiple of the alignment
+    return aligned_alloc(alignment, (bytes + alignment - 1) / alignment *
+                                    alignment);
+}
+
+//----------------------------------------------------------------------------
+// allocateOrThrow
+// Preconditions:   Alignment is a power of 2
+// Postconditions:  Returns a counted block of at least the given bytes,
+//                  throws bad_alloc if there is no memory
+static void* allocateOrThrow(size_t bytes, size_t alignment) {
+    void* block = allocate(bytes, alignment);
+    if(block == nullptr) {
+        throw bad_alloc();
+    }
+    return block;
+}
+
+//----------------------------------------------------------------------------
+// allocationCount
+// Preconditions:   allocationcount.cpp is linked into the program
+// Postconditions:  Returns the number of blocks allocated through operator
+//                  new since the program started
+long allocationCount() {
+    return allocations;
+}
+
+//----------------------------------------------------------------------------
+// operator new, operator new[]
+// Preconditions:   None
+// Postconditions:  Returns a counted block, throws bad_alloc or returns
+//                  nullptr for the nothrow forms if there is no memory
+void* operator new(size_t bytes) {
+    return allocateOrThrow(bytes, 0);
+}
+void* operator new[](size_t bytes) {
+    return allocateOrThrow(bytes, 0);
+}
+void* operator new(size_t bytes, const nothrow_t&) noexcept {
+    return allocate(bytes, 0);
+}
+void* operator new[](size_t bytes, const nothrow_t&) noexcept {
+    return allocate(bytes, 0);
+}
+void* operator new(size_t bytes, align_val_t alignment) {
+    return allocateOrThrow(bytes, (size_t)alignment);
+}
+void* operator new[](size_t bytes, align_val_t alignment) {
+    return allocateOrThrow(bytes, (size_t)alignment);
+}
+void* operator new(size_t bytes, align_val_t alignment,
+                   const nothrow_t&) noexcept {
+    return allocate(bytes, (size_t)alignment);
+}
+void* operator new[](size_t bytes, align_val_t alignment,
+                     const nothrow_t&) noexcept {
+    return allocate(bytes, (size_t)alignment);
+}
+
+//----------------------------------------------------------------------------
+// operator delete, operator delete[]
+// Preconditions:   Block came from the matching operator new, or is nullptr
+// Postconditions:  Block is freed
+void operator delete(void* block) noexcept {
+    free(block);
+}
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
+void operator delete(void* block, const nothrow_t&) noexcept {
+    free(block);
+}
+void operator delete[](void* block, const nothrow_t&) noexcept {
+    free(block);
+}
+void operator delete(void* block, align_val_t) noexcept {
+    free(block);
+}
+void operator delete[](void* block, align_val_t) noexcept {
+    free(block);
+}
+void operator delete(void* block, size_t, align_val_t) noexcept {
+    free(block);
+}
+void operator delete[](void* block, size_t, align_val_t) noexcept {
+    free(block);
+}
+void operator delete(void* block, align_val_t, const nothrow_t&) noexcept {
+    free(block);
+}
+void operator delete[](void* block, align_val_t,
+                       const nothrow_t&) noexcept {
+    free(block);
+}
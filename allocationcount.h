@@ -0,0 +1,31 @@
+//----------------------------------------------------------------------------
+// ALLOCATIONCOUNT.H
+// Function for counting the allocations made through operator new
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// allocationCount: the number of blocks allocated so far by the program
+// and allows other features:
+//      --measuring the allocations of a piece of code as the difference of
+//        the count before and after it, as benchmark.cpp does
+//
+// Implementation and assumptions:
+//      --linking allocationcount.cpp replaces every form of the global
+//        operator new and operator delete, plain, array, nothrow, sized and
+//        aligned, so each allocation is counted and each block goes back
+//        to the allocator it came from
+//      --the replacements are kept out of the files that use containers,
+//        where the compiler would see malloc and free paired with new and
+//        delete
+//----------------------------------------------------------------------------
+
+#ifndef ALLOCATIONCOUNT_H
+#define ALLOCATIONCOUNT_H
+
+//----------------------------------------------------------------------------
+// allocationCount
+// Preconditions:   allocationcount.cpp is linked into the program
+// Postconditions:  Returns the number of blocks allocated through operator
+//                  new since the program started
+long allocationCount();
+
+#endif
@@ -0,0 +1,193 @@
+//----------------------------------------------------------------------------
+// BATCHRUNNER.CPP
+// Implementation for BatchRunner Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BatchRunner: builds, solves and prints every graph of a file, as the lab3
+// loop does one graph at a time
+// and allows other features:
+//      --reading graphs from a GraphFile or an istream
+//      --choice of the work done on each graph, by default findShortestPath
+//        and displayAll
+//      --choice of the number of workers and of graphs in flight at once
+//
+// Implementation and assumptions:
+//      --a reader thread builds graph k + 1 while workers solve the graphs
+//        before it, and the calling thread writes their text in the order
+//        the graphs are in the file
+//      --each graph in flight has a slot in a ring, holding its GraphM and
+//        the text of its output, the reader waits for the slot of graph k to
+//        be written out before it builds graph k into it, so no more than
+//        the window of graphs are ever in flight
+//      --the reader hands built graphs to the workers through a
+//        BoundedQueue of one graph per worker, smaller than the ring, which
+//        holds back the reader when the workers fall behind, as the ring
+//        does when the writer falls behind
+//      --slots and their GraphM objects are reused from graph to graph and
+//        run to run, buildGraph resets each one as lab3's fresh GraphM
+//      --each graph is solved on one thread, the task must not throw and
+//        must only write to the buffer it is given
+//      --must be compiled with -pthread
+//----------------------------------------------------------------------------
+
+#include "batchrunner.h"
+#include "boundedqueue.h"
+#include "threadpool.h"
+#include <thread>
+
+// Graphs in flight per worker when no window is given, enough that a slow
+// graph does not leave the other workers idle while the writer waits on it
+static const int SLOTS_PER_WORKER = 4;
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   None
+// Postconditions:  Runner uses the given number of workers, 0 or less uses
+//                  the number of hardware threads, and holds the given
+//                  number of graphs in flight, 0 or less uses 4 per worker
+BatchRunner::BatchRunner(int count, int inFlight) {
+    workers = count > 0 ? count : ThreadPool::hardwareThreads();
+    int size = inFlight > 0 ? inFlight : workers * SLOTS_PER_WORKER;
+    for(int s = 0; s < size; s++) {
+        slots.emplace_back(new Slot());
+        slots.back()->state = FREE;
+    }
+    task = [](GraphM& G, OutputBuffer& out) {
+        G.findShortestPath();
+        G.displayAll(out);
+    };
+}
+
+//----------------------------------------------------------------------------
+// setTask
+// Preconditions:   None
+// Postconditions:  Each built graph is handed to the task with the buffer
+//                  its text goes into
+void BatchRunner::setTask(
+        const function<void(GraphM&, OutputBuffer&)>& work) {
+    task = work;
+}
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   Text held by the GraphFile is formatted as buildGraph
+//                  takes it
+// Postconditions:  Every graph left in the file is built and given to the
+//                  task, the text of each is written to the buffer in file
+//                  order and the buffer is flushed, returns the number of
+//                  graphs
+long BatchRunner::run(GraphFile& file, OutputBuffer& out) {
+    return pipeline([&file](GraphM& G) {
+        return G.buildGraph(file);
+    }, out);
+}
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   istream is formatted as buildGraph takes it
+// Postconditions:  Same as run on a GraphFile, graphs are read until the
+//                  stream ends, as the lab3 loop reads them
+long BatchRunner::run(istream& infile, OutputBuffer& out) {
+    return pipeline([&infile](GraphM& G) {
+        G.buildGraph(infile);
+        return !infile.eof();
+    }, out);
+}
+
+//----------------------------------------------------------------------------
+// workerCount, window
+// Preconditions:   None
+// Postconditions:  Returns the number of workers, and of graphs in flight
+int BatchRunner::workerCount() const {
+    return workers;
+}
+int BatchRunner::window() const {
+    return slots.size();
+}
+
+//----------------------------------------------------------------------------
+// pipeline
+// Preconditions:   Build function builds the next graph into the GraphM and
+//                  returns false once there are none
+// Postconditions:  Every graph is built, given to the task and its text
+//                  written to the buffer in order, returns the number of
+//                  graphs
+long BatchRunner::pipeline(const function<bool(GraphM&)>& build,
+                           OutputBuffer& out) {
+    long ring = slots.size();
+    long total = -1;                    // graphs in the file, once known
+    // Graphs waiting for a worker, one each is enough to keep them busy,
+    // more would only let the reader run ahead of the workers
+    BoundedQueue<long> built(workers);
+
+    // Reader, a slot is only touched by the stage its state names
+    thread reader([&] {
+        long k = 0;
+        for(;; k++) {
+            Slot& slot = *slots[k % ring];
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&slot] { return slot.state == FREE; });
+            }
+            if(!build(slot.graph)) {
+                break;
+            }
+            {
+                lock_guard<mutex> guard(lock);
+                slot.state = BUILT;
+            }
+            built.push(k);
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            total = k;
+        }
+        changed.notify_all();
+        built.close();
+    });
+
+    vector<thread> solvers;
+    for(int w = 0; w < workers; w++) {
+        solvers.emplace_back([&] {
+            long k;
+            while(built.pop(k)) {
+                Slot& slot = *slots[k % ring];
+                slot.text.clear();
+                task(slot.graph, slot.text);
+                {
+                    lock_guard<mutex> guard(lock);
+                    slot.state = SOLVED;
+                }
+                changed.notify_all();
+            }
+        });
+    }
+
+    // Writer, on the calling thread, takes the graphs back in file order
+    long next = 0;
+    for(;; next++) {
+        Slot& slot = *slots[next % ring];
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&] {
+                return slot.state == SOLVED || next == total;
+            });
+            if(slot.state != SOLVED) {
+                break;
+            }
+        }
+        out.append(slot.text);
+        {
+            lock_guard<mutex> guard(lock);
+            slot.state = FREE;
+        }
+        changed.notify_all();
+    }
+
+    reader.join();
+    for(thread& solver : solvers) {
+        solver.join();
+    }
+    out.flush();
+    return next;
+}
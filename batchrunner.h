@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+// BATCHRUNNER.H
+// Class for running a file of many graphs through a pipeline of threads
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BatchRunner: builds, solves and prints every graph of a file, as the lab3
+// loop does one graph at a time
+// and allows other features:
+//      --reading graphs from a GraphFile or an istream
+//      --choice of the work done on each graph, by default findShortestPath
+//        and displayAll
+//      --choice of the number of workers and of graphs in flight at once
+//
+// Implementation and assumptions:
+//      --a reader thread builds graph k + 1 while workers solve the graphs
+//        before it, and the calling thread writes their text in the order
+//        the graphs are in the file
+//      --each graph in flight has a slot in a ring, holding its GraphM and
+//        the text of its output, the reader waits for the slot of graph k to
+//        be written out before it builds graph k into it, so no more than
+//        the window of graphs are ever in flight
+//      --the reader hands built graphs to the workers through a
+//        BoundedQueue of one graph per worker, smaller than the ring, which
+//        holds back the reader when the workers fall behind, as the ring
+//        does when the writer falls behind
+//      --slots and their GraphM objects are reused from graph to graph and
+//        run to run, buildGraph resets each one as lab3's fresh GraphM
+//      --each graph is solved on one thread, the task must not throw and
+//        must only write to the buffer it is given
+//      --must be compiled with -pthread
+//----------------------------------------------------------------------------
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "graphm.h"
+#include "graphfile.h"
+#include "outputbuffer.h"
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+class BatchRunner {
+public:
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   None
+// Postconditions:  Runner uses the given number of workers, 0 or less uses
+//                  the number of hardware threads, and holds the given
+//                  number of graphs in flight, 0 or less uses 4 per worker
+    explicit BatchRunner(int = 0, int = 0);
+
+//----------------------------------------------------------------------------
+// setTask
+// Preconditions:   None
+// Postconditions:  Each built graph is handed to the task with the buffer
+//                  its text goes into
+    void setTask(const function<void(GraphM&, OutputBuffer&)>&);
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   Text held by the GraphFile is formatted as buildGraph
+//                  takes it
+// Postconditions:  Every graph left in the file is built and given to the
+//                  task, the text of each is written to the buffer in file
+//                  order and the buffer is flushed, returns the number of
+//                  graphs
+    long run(GraphFile&, OutputBuffer&);
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   istream is formatted as buildGraph takes it
+// Postconditions:  Same as run on a GraphFile, graphs are read until the
+//                  stream ends, as the lab3 loop reads them
+    long run(istream&, OutputBuffer&);
+
+//----------------------------------------------------------------------------
+// workerCount, window
+// Preconditions:   None
+// Postconditions:  Returns the number of workers, and of graphs in flight
+    int workerCount() const;
+    int window() const;
+
+private:
+    enum SlotState {
+        FREE,               // written out, can take the next graph
+        BUILT,              // graph built, waiting for a worker
+        SOLVED              // text ready, waiting for the writer
+    };
+
+    struct Slot {
+        GraphM graph;       // graph of the slot
+        OutputBuffer text;  // output of the task, grows in memory
+        SlotState state;    // stage the slot is at, guarded by lock
+    };
+
+    int workers;                            // threads running the task
+    vector<unique_ptr<Slot>> slots;         // ring of graphs in flight
+    function<void(GraphM&, OutputBuffer&)> task;    // work on each graph
+    mutex lock;                             // guards slot states and total
+    condition_variable changed;             // signals any slot state change
+
+//----------------------------------------------------------------------------
+// pipeline
+// Preconditions:   Build function builds the next graph into the GraphM and
+//                  returns false once there are none
+// Postconditions:  Every graph is built, given to the task and its text
+//                  written to the buffer in order, returns the number of
+//                  graphs
+    long pipeline(const function<bool(GraphM&)>&, OutputBuffer&);
+};
+
+#endif
@@ -0,0 +1,1959 @@
+//---------------------------------------------------------------------------
+// benchmark.cpp
+//---------------------------------------------------------------------------
+// This code times the shortest path engines of GraphM and the searches of
+// GraphL on generated graphs.
+// It is not a test of correctness, lab3.cpp and test.cpp cover the output.
+//
+// Run with no arguments for every section, or as "benchmark suite [nodes]
+// [json file]" for only benchSuite, whose JSON results can be diffed
+// between commits.
+//
+// Build (on one line):
+//   g++ -O2 -pthread benchmark.cpp graphm.cpp graphl.cpp nodedata.cpp
+//       csrgraph.cpp threadpool.cpp floydwarshall.cpp landmarks.cpp
+//       contractionhierarchy.cpp outputbuffer.cpp deltastepping.cpp
+//       graphfile.cpp graphsnapshot.cpp batchrunner.cpp labelstore.cpp
+//       pathtable.cpp breadthfirst.cpp components.cpp reachindex.cpp
+//       allocationcount.cpp
+//
+// Assumptions:
+//   -- graphs are generated in the same text format as data31.txt and are
+//      read through buildGraph, so the timings include no file I/O, but
+//      benchParse, benchSnapshot and benchTableFile, which write files in
+//      /tmp and read them back, benchSuite also writes the text of each of
+//      its graphs next to its JSON file
+//   -- each timing is the average of several repetitions, except the
+//      GraphM phases of benchSuite, which are too long to repeat
+//   -- peak memory is read from /proc, it is per phase where the kernel
+//      lets the peak be reset and since the start of the process otherwise
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include "graphm.h"
+#include "graphl.h"
+#include "breadthfirst.h"
+#include "components.h"
+#include "reachindex.h"
+#include "csrgraph.h"
+#include "dheap.h"
+#include "pathrow.h"
+#include "bitarray.h"
+#include "threadpool.h"
+#include "deltastepping.h"
+#include "outputbuffer.h"
+#include "graphfile.h"
+#include "batchrunner.h"
+#include "labelstore.h"
+#include "nodedata.h"
+#include "allocationcount.h"
+using namespace std;
+
+//---------------------------------------------------------------------------
+// NullBuffer
+// Stream buffer that drops everything written to it, so output can be
+// timed without a terminal or a growing string
+class NullBuffer : public streambuf {
+protected:
+   int overflow(int c) override {
+      return c;
+   }
+   streamsize xsputn(const char*, streamsize count) override {
+      return count;
+   }
+};
+
+//---------------------------------------------------------------------------
+// randomGraph
+// Returns the text of a graph with n nodes where each ordered pair of
+// different nodes has an edge with the given probability
+string randomGraph(int n, double density, unsigned seed) {
+   mt19937 rng(seed);
+   uniform_real_distribution<double> coin(0.0, 1.0);
+   uniform_int_distribution<int> length(1, 100);
+
+   ostringstream out;
+   out << n << endl;
+   for (int i = 1; i <= n; i++) {
+      out << "node " << i << endl;
+   }
+   for (int i = 1; i <= n; i++) {
+      for (int j = 1; j <= n; j++) {
+         if (i != j && coin(rng) < density) {
+            out << i << " " << j << " " << length(rng) << endl;
+         }
+      }
+   }
+   out << "0 0 0" << endl;
+   return out.str();
+}
+
+//---------------------------------------------------------------------------
+// gridEdges
+// Returns the edges of a road-like graph, a side x side grid where each node
+// has edges both ways to its neighbours in the 4 directions
+vector<Edge> gridEdges(int side, unsigned seed) {
+   mt19937 rng(seed);
+   uniform_int_distribution<int> length(1, 100);
+
+   vector<Edge> edges;
+   for (int r = 0; r < side; r++) {
+      for (int c = 0; c < side; c++) {
+         int v = r * side + c + 1;
+         if (c + 1 < side) {
+            int w = length(rng);
+            edges.push_back(Edge{v, v + 1, w});
+            edges.push_back(Edge{v + 1, v, w});
+         }
+         if (r + 1 < side) {
+            int w = length(rng);
+            edges.push_back(Edge{v, v + side, w});
+            edges.push_back(Edge{v + side, v, w});
+         }
+      }
+   }
+   return edges;
+}
+
+//---------------------------------------------------------------------------
+// gridGraph
+// Returns the text of the grid graph of gridEdges
+string gridGraph(int side, unsigned seed) {
+   ostringstream out;
+   out << side * side << endl;
+   for (int i = 1; i <= side * side; i++) {
+      out << "node " << i << endl;
+   }
+   for (const Edge& edge : gridEdges(side, seed)) {
+      out << edge.from << " " << edge.to << " " << edge.length << endl;
+   }
+   out << "0 0 0" << endl;
+   return out.str();
+}
+
+//---------------------------------------------------------------------------
+// timeShortestPath
+// Returns the average microseconds for findShortestPath on the graph text
+// using the given heap type, number of threads and engine
+double timeShortestPath(const string& text, GraphM::HeapType type, int reps,
+                        int threads = 1,
+                        GraphM::EngineType engine = GraphM::DIJKSTRA) {
+   GraphM G;
+   istringstream in(text);
+   G.buildGraph(in);
+   G.setHeapType(type);
+   G.setThreadCount(threads);
+   G.setEngine(engine);
+
+   auto start = chrono::steady_clock::now();
+   for (int r = 0; r < reps; r++) {
+      G.findShortestPath();
+   }
+   auto stop = chrono::steady_clock::now();
+   return chrono::duration<double, micro>(stop - start).count() / reps;
+}
+
+//---------------------------------------------------------------------------
+// benchHeaps
+// Prints findShortestPath times of every heap type against the linear scan
+void benchHeaps() {
+   const char* names[] = { "linear scan", "binary heap", "4-ary heap",
+                           "pairing heap" };
+   GraphM::HeapType types[] = { GraphM::LINEAR_SCAN, GraphM::BINARY_HEAP,
+                                GraphM::FOUR_ARY_HEAP, GraphM::PAIRING_HEAP };
+   double densities[] = { 0.01, 0.03, 0.10, 0.50, 0.90 };
+   const int nodes = 300;
+   const int reps = 5;
+
+   cout << "findShortestPath, " << nodes << " nodes (us per call)" << endl;
+   cout << setw(10) << left << "density";
+   for (const char* name : names) {
+      cout << setw(14) << left << name;
+   }
+   cout << endl;
+   for (double density : densities) {
+      string text = randomGraph(nodes, density, 343);
+      cout << setw(10) << left << fixed << setprecision(2) << density;
+      for (GraphM::HeapType type : types) {
+         cout << setw(14) << left << fixed << setprecision(1)
+              << timeShortestPath(text, type, reps);
+      }
+      cout << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchThreads
+// Prints all-pairs findShortestPath times for growing thread counts
+void benchThreads() {
+   const int nodes = 2000;
+   const int reps = 3;
+   string text = randomGraph(nodes, 4.0 / nodes, 343);
+
+   cout << "parallel findShortestPath, " << nodes << " nodes, "
+        << ThreadPool::hardwareThreads() << " hardware threads" << endl;
+   cout << setw(10) << left << "threads" << setw(14) << left << "ms per call"
+        << "speedup" << endl;
+   double serial = 0;
+   for (int threads = 1; threads <= 2 * ThreadPool::hardwareThreads();
+        threads *= 2) {
+      double ms = timeShortestPath(text, GraphM::BINARY_HEAP, reps, threads)
+                  / 1000;
+      if (threads == 1) {
+         serial = ms;
+      }
+      cout << setw(10) << left << threads << setw(14) << left << fixed
+           << setprecision(1) << ms << setprecision(2) << serial / ms << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchLazy
+// Prints the cost of answering a few distance queries on a fresh graph with
+// every row found up front against rows found on demand
+void benchLazy() {
+   const int nodes = 2000;
+   const int queries = 10;
+   string text = randomGraph(nodes, 4.0 / nodes, 343);
+
+   cout << "cold start, " << queries << " distance queries, " << nodes
+        << " nodes" << endl;
+   for (int lazy = 0; lazy <= 1; lazy++) {
+      GraphM G;
+      istringstream in(text);
+      G.buildGraph(in);
+      G.setLazy(lazy == 1);
+
+      auto start = chrono::steady_clock::now();
+      G.findShortestPath();
+      for (int q = 1; q <= queries; q++) {
+         G.distance(q * 7 % nodes + 1, q * 13 % nodes + 1);
+      }
+      auto stop = chrono::steady_clock::now();
+      cout << setw(10) << left << (lazy ? "lazy" : "eager") << setw(14)
+           << left << fixed << setprecision(2)
+           << chrono::duration<double, milli>(stop - start).count() << "ms"
+           << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchUpdates
+// Prints the cost of keeping all rows current through edge updates against
+// finding every row again
+void benchUpdates() {
+   const int nodes = 1000;
+   const int updates = 200;
+   string text = randomGraph(nodes, 4.0 / nodes, 343);
+
+   GraphM G;
+   istringstream in(text);
+   G.buildGraph(in);
+   auto start = chrono::steady_clock::now();
+   G.findShortestPath();
+   auto stop = chrono::steady_clock::now();
+   double full = chrono::duration<double, micro>(stop - start).count();
+
+   long rows = 0;
+   long entries = 0;
+   G.setUpdateHook([&](const GraphM::UpdateStats& stats) {
+      rows += stats.rowsTouched;
+      entries += stats.entriesTouched;
+   });
+   mt19937 rng(343);
+   start = chrono::steady_clock::now();
+   for (int u = 0; u < updates; u++) {
+      int from = rng() % nodes + 1;
+      int to = rng() % nodes + 1;
+      if (!G.removeEdge(from, to)) {
+         G.insertEdge(from, to, rng() % 100 + 1);
+      }
+   }
+   stop = chrono::steady_clock::now();
+   double each = chrono::duration<double, micro>(stop - start).count()
+                 / updates;
+
+   cout << "edge updates, " << nodes << " nodes" << endl;
+   cout << fixed << setprecision(1) << "full findShortestPath  " << full
+        << " us" << endl;
+   cout << "incremental update     " << each << " us, " << rows / updates
+        << " rows and " << entries / updates << " entries per update"
+        << endl << endl;
+}
+
+//---------------------------------------------------------------------------
+// randomEdges
+// Returns a CSRGraph of n nodes where each node has the given number of
+// edges to random nodes
+CSRGraph randomEdges(int n, int degree, unsigned seed) {
+   mt19937 rng(seed);
+   vector<Edge> edges;
+   for (int i = 1; i <= n; i++) {
+      for (int d = 0; d < degree; d++) {
+         edges.push_back(Edge{i, (int)(rng() % n) + 1, (int)(rng() % 100) + 1});
+      }
+   }
+   CSRGraph graph;
+   graph.build(n, edges);
+   return graph;
+}
+
+//---------------------------------------------------------------------------
+// Entry
+// One entry of the array of structs table layout GraphM used to have
+struct Entry {
+   bool visited;
+   int dist;
+   int path;
+};
+
+//---------------------------------------------------------------------------
+// structSearch
+// Dijkstra from the source into a row of Entry structs
+void structSearch(const CSRGraph& g, int source, vector<Entry>& row,
+                  BinaryHeap& heap) {
+   row.assign(g.nodeCount() + 1, Entry{false, INT_MAX, 0});
+   row[source].dist = 0;
+   heap.reset(g.nodeCount());
+   heap.update(source, 0);
+   while (!heap.empty()) {
+      int v = heap.pop();
+      row[v].visited = true;
+      for (int e = g.begin(v); e < g.end(v); e++) {
+         int k = g.target(e);
+         int through = row[v].dist + g.weight(e);
+         if (!row[k].visited && through <= row[k].dist) {
+            if (through < row[k].dist) {
+               heap.update(k, through);
+            }
+            row[k].dist = through;
+            row[k].path = v;
+         }
+      }
+   }
+}
+
+//---------------------------------------------------------------------------
+// arraySearch
+// Dijkstra from the source into a PathRow and a visited BitArray
+void arraySearch(const CSRGraph& g, int source, PathRow& row,
+                 BitArray& visited, BinaryHeap& heap) {
+   row.reset(g.nodeCount(), source);
+   visited.resize(g.nodeCount());
+   heap.reset(g.nodeCount());
+   heap.update(source, 0);
+   while (!heap.empty()) {
+      int v = heap.pop();
+      visited.set(v);
+      for (int e = g.begin(v); e < g.end(v); e++) {
+         int k = g.target(e);
+         int through = row.dist(v) + g.weight(e);
+         if (!visited.test(k) && through <= row.dist(k)) {
+            if (through < row.dist(k)) {
+               heap.update(k, through);
+            }
+            row.setDist(k, through);
+            row.setPath(k, v);
+         }
+      }
+   }
+}
+
+//---------------------------------------------------------------------------
+// benchLayout
+// Prints all-pairs table memory and search time of the array of structs
+// layout against the structure of arrays layout GraphM uses now
+void benchLayout() {
+   const int nodes = 2000;
+   CSRGraph g = randomEdges(nodes, 8, 343);
+   BinaryHeap heap;
+
+   vector<vector<Entry>> structTable(nodes + 1);
+   auto start = chrono::steady_clock::now();
+   for (int i = 1; i <= nodes; i++) {
+      structSearch(g, i, structTable[i], heap);
+   }
+   auto stop = chrono::steady_clock::now();
+   double structMs = chrono::duration<double, milli>(stop - start).count();
+   size_t structBytes = 0;
+   for (const vector<Entry>& row : structTable) {
+      structBytes += row.capacity() * sizeof(Entry);
+   }
+   structTable.clear();
+
+   vector<PathRow> arrayTable(nodes + 1);
+   BitArray visited;
+   start = chrono::steady_clock::now();
+   for (int i = 1; i <= nodes; i++) {
+      arraySearch(g, i, arrayTable[i], visited, heap);
+   }
+   stop = chrono::steady_clock::now();
+   double arrayMs = chrono::duration<double, milli>(stop - start).count();
+   size_t arrayBytes = visited.memoryBytes();
+   for (const PathRow& row : arrayTable) {
+      arrayBytes += row.memoryBytes();
+   }
+
+   cout << "table layout, all pairs, " << nodes << " nodes" << endl;
+   cout << setw(20) << left << "layout" << setw(14) << left << "table MB"
+        << "ms" << endl;
+   cout << fixed << setprecision(1);
+   cout << setw(20) << left << "array of structs" << setw(14) << left
+        << structBytes / 1048576.0 << structMs << endl;
+   cout << setw(20) << left << "structure of arrays" << setw(14) << left
+        << arrayBytes / 1048576.0 << arrayMs << endl << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchEngines
+// Prints findShortestPath times of Dijkstra's algorithm against blocked
+// Floyd-Warshall over a range of densities, and which one AUTO picks
+void benchEngines() {
+   double densities[] = { 0.002, 0.005, 0.01, 0.02, 0.05, 0.20, 1.00 };
+   const int nodes = 512;
+   const int reps = 2;
+
+   cout << "all pairs engines, " << nodes << " nodes, Floyd-Warshall kernel "
+        << FloydWarshall().kernelName() << " (ms per call)" << endl;
+   cout << setw(10) << left << "density" << setw(14) << left << "dijkstra"
+        << setw(16) << left << "floyd-warshall" << "auto" << endl;
+   for (double density : densities) {
+      string text = randomGraph(nodes, density, 343);
+      double dijkstra = timeShortestPath(text, GraphM::BINARY_HEAP, reps, 1,
+                                         GraphM::DIJKSTRA) / 1000;
+      double floyd = timeShortestPath(text, GraphM::BINARY_HEAP, reps, 1,
+                                      GraphM::FLOYD_WARSHALL) / 1000;
+      double picked = timeShortestPath(text, GraphM::BINARY_HEAP, reps, 1,
+                                       GraphM::AUTO) / 1000;
+      cout << setw(10) << left << fixed << setprecision(2) << density
+           << setprecision(1) << setw(14) << left << dijkstra << setw(16)
+           << left << floyd << picked << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchPairs
+// Prints the cost of single pair display queries on a grid answered by the
+// bidirectional search against finding the source's whole row
+void benchPairs() {
+   const int side = 100;
+   const int queries = 200;
+   const int nodes = side * side;
+   string text = gridGraph(side, 343);
+   mt19937 rng(343);
+   vector<int> from, to;
+   for (int q = 0; q < queries; q++) {
+      from.push_back(rng() % nodes + 1);
+      to.push_back(rng() % nodes + 1);
+   }
+
+   // display prints every path, keep it out of the timings
+   ostringstream sink;
+   streambuf* console = cout.rdbuf(sink.rdbuf());
+
+   // Row per query, through lazy mode with room for a single row
+   GraphM rows;
+   istringstream in(text);
+   rows.buildGraph(in);
+   rows.setLazy(true, 1);
+   rows.findShortestPath();
+   auto start = chrono::steady_clock::now();
+   for (int q = 0; q < queries; q++) {
+      rows.distance(from[q], to[q]);
+   }
+   auto stop = chrono::steady_clock::now();
+   double rowMs = chrono::duration<double, milli>(stop - start).count();
+
+   // Bidirectional search per query, no table at all
+   GraphM pairs;
+   istringstream in2(text);
+   pairs.buildGraph(in2);
+   long settled = 0;
+   start = chrono::steady_clock::now();
+   for (int q = 0; q < queries; q++) {
+      pairs.display(from[q], to[q]);
+      settled += pairs.settledCount();
+   }
+   stop = chrono::steady_clock::now();
+   double pairMs = chrono::duration<double, milli>(stop - start).count();
+   cout.rdbuf(console);
+
+   cout << "single pair queries, " << side << " x " << side << " grid, "
+        << queries << " queries" << endl;
+   cout << setw(20) << left << "search" << setw(18) << left
+        << "settled per query" << "ms per query" << endl;
+   cout << fixed << setprecision(3);
+   cout << setw(20) << left << "whole row" << setw(18) << left << nodes
+        << rowMs / queries << endl;
+   cout << setw(20) << left << "bidirectional" << setw(18) << left
+        << settled / queries << pairMs / queries << endl << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchLandmarks
+// Prints the nodes settled per display query with A* on landmarks for a
+// growing number of landmarks, 0 landmarks is plain Dijkstra stopped at the
+// destination, and the cost of building against loading the landmarks
+void benchLandmarks() {
+   const int side = 100;
+   const int queries = 200;
+   const int nodes = side * side;
+   const char* methods[] = { "farthest", "avoid" };
+   int counts[] = { 0, 1, 2, 4, 8, 16 };
+   string text = gridGraph(side, 343);
+   mt19937 rng(343);
+   vector<int> from, to;
+   for (int q = 0; q < queries; q++) {
+      from.push_back(rng() % nodes + 1);
+      to.push_back(rng() % nodes + 1);
+   }
+
+   GraphM G;
+   istringstream in(text);
+   G.buildGraph(in);
+   G.setPairSearch(GraphM::LANDMARKS);
+
+   cout << "A* with landmarks, " << side << " x " << side << " grid, "
+        << queries << " queries" << endl;
+   cout << setw(10) << left << "method" << setw(11) << left << "landmarks"
+        << setw(18) << left << "settled per query" << setw(15) << left
+        << "ms per query" << "build ms" << endl;
+   ostringstream sink;
+   for (int m = 0; m < 2; m++) {
+      for (int count : counts) {
+         if (m == 1 && count == 0) {
+            continue;
+         }
+         auto start = chrono::steady_clock::now();
+         G.buildLandmarks(count, (Landmarks::Method)m);
+         auto stop = chrono::steady_clock::now();
+         double buildMs = chrono::duration<double, milli>(stop - start)
+                          .count();
+
+         // display prints every path, keep it out of the timings
+         streambuf* console = cout.rdbuf(sink.rdbuf());
+         long settled = 0;
+         start = chrono::steady_clock::now();
+         for (int q = 0; q < queries; q++) {
+            G.display(from[q], to[q]);
+            settled += G.settledCount();
+         }
+         stop = chrono::steady_clock::now();
+         cout.rdbuf(console);
+         sink.str("");
+
+         double queryMs = chrono::duration<double, milli>(stop - start)
+                          .count() / queries;
+         cout << setw(10) << left << (count == 0 ? "none" : methods[m])
+              << setw(11) << left << count << setw(18) << left
+              << settled / queries << setw(15) << left << fixed
+              << setprecision(3) << queryMs << setprecision(1) << buildMs
+              << endl;
+      }
+   }
+
+   // Saved landmarks are loaded instead of found again
+   stringstream saved;
+   G.buildLandmarks(16, Landmarks::AVOID);
+   G.saveLandmarks(saved);
+   auto start = chrono::steady_clock::now();
+   bool loaded = G.loadLandmarks(saved);
+   auto stop = chrono::steady_clock::now();
+   cout << "loading 16 saved landmarks: " << fixed << setprecision(1)
+        << chrono::duration<double, milli>(stop - start).count() << " ms"
+        << (loaded ? "" : " (failed)") << endl << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchHierarchy
+// Prints the preprocessing time and index size of a contraction hierarchy,
+// and its display query times against plain Dijkstra stopped at the
+// destination
+void benchHierarchy() {
+   const int side = 200;
+   const int queries = 200;
+   const int nodes = side * side;
+   CSRGraph graph;
+   graph.build(nodes, gridEdges(side, 343));
+
+   cout << "contraction hierarchy, " << side << " x " << side << " grid, "
+        << graph.edgeCount() << " edges" << endl;
+   cout << setw(10) << left << "threads" << setw(14) << left << "build ms"
+        << setw(12) << left << "rounds" << setw(12) << left << "shortcuts"
+        << "index MB" << endl;
+   for (int threads = 1; threads <= ThreadPool::hardwareThreads();
+        threads *= 2) {
+      ThreadPool pool(threads);
+      ContractionHierarchy index;
+      auto start = chrono::steady_clock::now();
+      index.build(graph, threads == 1 ? nullptr : &pool);
+      auto stop = chrono::steady_clock::now();
+      cout << setw(10) << left << threads << setw(14) << left << fixed
+           << setprecision(1)
+           << chrono::duration<double, milli>(stop - start).count()
+           << setw(12) << left << index.rounds() << setw(12) << left
+           << index.shortcutCount() << setprecision(2)
+           << index.memoryBytes() / 1048576.0 << endl;
+   }
+
+   mt19937 rng(343);
+   vector<int> from, to;
+   for (int q = 0; q < queries; q++) {
+      from.push_back(rng() % nodes + 1);
+      to.push_back(rng() % nodes + 1);
+   }
+   GraphM G;
+   istringstream in(gridGraph(side, 343));
+   G.buildGraph(in);
+   G.buildHierarchy();
+
+   cout << setw(20) << left << "search" << setw(18) << left
+        << "settled per query" << "ms per query" << endl;
+   GraphM::PairType types[] = { GraphM::LANDMARKS, GraphM::CONTRACTION };
+   const char* names[] = { "dijkstra", "hierarchy" };
+   ostringstream sink;
+   for (int t = 0; t < 2; t++) {
+      G.setPairSearch(types[t]);
+
+      // display prints every path, keep it out of the timings
+      streambuf* console = cout.rdbuf(sink.rdbuf());
+      long settled = 0;
+      auto start = chrono::steady_clock::now();
+      for (int q = 0; q < queries; q++) {
+         G.display(from[q], to[q]);
+         settled += G.settledCount();
+      }
+      auto stop = chrono::steady_clock::now();
+      cout.rdbuf(console);
+      sink.str("");
+      cout << setw(20) << left << names[t] << setw(18) << left
+           << settled / queries << fixed << setprecision(3)
+           << chrono::duration<double, milli>(stop - start).count() / queries
+           << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchBatch
+// Prints the time of a batch of pairs with few distinct origins answered
+// one display at a time against findPairs, which searches once per origin
+void benchBatch() {
+   const int side = 100;
+   const int origins = 50;
+   const int perOrigin = 40;
+   const int nodes = side * side;
+   string text = gridGraph(side, 343);
+   mt19937 rng(343);
+   vector<GraphM::PairQuery> pairs;
+   for (int o = 0; o < origins; o++) {
+      int from = rng() % nodes + 1;
+      for (int q = 0; q < perOrigin; q++) {
+         pairs.push_back(GraphM::PairQuery{ from, (int)(rng() % nodes) + 1 });
+      }
+   }
+   shuffle(pairs.begin(), pairs.end(), rng);
+   int count = pairs.size();
+
+   GraphM G;
+   istringstream in(text);
+   G.buildGraph(in);
+
+   cout << "batch of " << count << " pairs, " << origins << " origins, "
+        << side << " x " << side << " grid" << endl;
+   cout << setw(24) << left << "method" << "ms per pair" << endl;
+
+   // display prints every path, keep it out of the timings
+   ostringstream sink;
+   streambuf* console = cout.rdbuf(sink.rdbuf());
+   auto start = chrono::steady_clock::now();
+   for (int q = 0; q < count; q++) {
+      G.display(pairs[q].from, pairs[q].to);
+   }
+   auto stop = chrono::steady_clock::now();
+   cout.rdbuf(console);
+   cout << setw(24) << left << "display each" << fixed << setprecision(4)
+        << chrono::duration<double, milli>(stop - start).count() / count
+        << endl;
+
+   GraphM::PairResults results;
+   for (int threads = 1; threads <= ThreadPool::hardwareThreads();
+        threads *= 2) {
+      G.setThreadCount(threads);
+      G.findPairs(pairs.data(), count, results, threads > 1);
+      start = chrono::steady_clock::now();
+      G.findPairs(pairs.data(), count, results, threads > 1);
+      stop = chrono::steady_clock::now();
+      cout << setw(24) << left
+           << ("findPairs, " + to_string(threads) + " thread"
+               + (threads > 1 ? "s" : ""))
+           << chrono::duration<double, milli>(stop - start).count() / count
+           << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchOutput
+// Prints the time and the allocations of displayAll on a random graph,
+// through cout with the output dropped, through an OutputBuffer on
+// /dev/null, and with the rows rendered on more threads
+void benchOutput() {
+   const int nodes = 1000;
+   GraphM G;
+   istringstream in(randomGraph(nodes, 0.01, 343));
+   G.buildGraph(in);
+   G.findShortestPath();
+   long pairs = (long)nodes * (nodes - 1);
+   cout << "displayAll, " << nodes << " nodes, " << pairs << " pairs" << endl;
+   cout << setw(26) << left << "output" << setw(12) << left << "ms"
+        << setw(14) << left << "allocations" << "per pair" << endl;
+
+   NullBuffer drop;
+   int devNull = open("/dev/null", O_WRONLY);
+   for (int threads = 0; threads <= ThreadPool::hardwareThreads();
+        threads = threads == 0 ? 1 : threads * 2) {
+      G.setThreadCount(max(threads, 1));
+      OutputBuffer file(devNull);
+      streambuf* console = cout.rdbuf(&drop);
+
+      // First call sizes the vectors paths are walked into
+      if (threads == 0) {
+         G.displayAll();
+      }
+      else {
+         G.displayAll(file, threads > 1);
+      }
+      long before = allocationCount();
+      auto start = chrono::steady_clock::now();
+      if (threads == 0) {
+         G.displayAll();
+      }
+      else {
+         G.displayAll(file, threads > 1);
+      }
+      auto stop = chrono::steady_clock::now();
+      long made = allocationCount() - before;
+      cout.rdbuf(console);
+
+      string name = threads == 0 ? "cout"
+                    : "/dev/null, " + to_string(threads) + " thread"
+                      + (threads > 1 ? "s" : "");
+      cout << setw(26) << left << name << setw(12) << left << fixed
+           << setprecision(1)
+           << chrono::duration<double, milli>(stop - start).count()
+           << setw(14) << left << made << setprecision(4)
+           << (double)made / pairs << endl;
+   }
+   close(devNull);
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchDeltaStepping
+// Prints single source times of Dijkstra's algorithm against delta-stepping
+// on a large sparse graph, for a few bucket widths and thread counts
+void benchDeltaStepping() {
+   const int nodes = 250000;
+   const int sources = 4;
+   CSRGraph g = randomEdges(nodes, 8, 343);
+   mt19937 rng(343);
+   vector<int> from;
+   for (int s = 0; s < sources; s++) {
+      from.push_back(rng() % nodes + 1);
+   }
+
+   PathRow row;
+   BitArray visited;
+   BinaryHeap heap;
+   auto start = chrono::steady_clock::now();
+   for (int source : from) {
+      arraySearch(g, source, row, visited, heap);
+   }
+   auto stop = chrono::steady_clock::now();
+   int suggested = DeltaStepping::suggestDelta(g);
+
+   cout << "single source, " << nodes << " nodes, " << g.edgeCount()
+        << " edges, suggested delta " << suggested << " (ms per source)"
+        << endl;
+   cout << setw(20) << left << "dijkstra" << fixed << setprecision(1)
+        << chrono::duration<double, milli>(stop - start).count() / sources
+        << endl;
+   cout << setw(10) << left << "delta" << setw(10) << left << "threads"
+        << setw(10) << left << "phases" << "ms" << endl;
+   int widths[] = { suggested / 4 + 1, suggested, suggested * 4 };
+   for (int width : widths) {
+      for (int threads = 1; threads <= ThreadPool::hardwareThreads();
+           threads *= 2) {
+         ThreadPool pool(threads);
+         DeltaStepping solver;
+         solver.setDelta(width);
+         long phases = 0;
+         start = chrono::steady_clock::now();
+         for (int source : from) {
+            solver.solve(g, source, threads == 1 ? nullptr : &pool);
+            phases += solver.phases();
+         }
+         stop = chrono::steady_clock::now();
+         cout << setw(10) << left << width << setw(10) << left << threads
+              << setw(10) << left << phases / sources
+              << chrono::duration<double, milli>(stop - start).count()
+                 / sources << endl;
+      }
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchParse
+// Prints the speed of reading a file of several graphs, one after another as
+// lab3 does, through an ifstream and through a GraphFile, and of the
+// GraphFile's scanning alone
+void benchParse() {
+   const int graphs = 6;
+   string path = "/tmp/benchparse.txt";
+   {
+      ofstream out(path);
+      for (int g = 0; g < graphs; g++) {
+         out << randomGraph(2000, 0.05, 343 + g);
+      }
+   }
+   GraphFile file;
+   file.open(path);
+   double megabytes = file.size() / 1e6;
+   cout << "reading " << graphs << " graphs, " << fixed << setprecision(1)
+        << megabytes << " MB" << endl;
+   cout << setw(26) << left << "reader" << setw(12) << left << "ms"
+        << "MB/s" << endl;
+
+   for (int kind = 0; kind < 3; kind++) {
+      auto start = chrono::steady_clock::now();
+      if (kind == 0) {
+         ifstream in(path);
+         for (;;) {
+            GraphM G;
+            G.buildGraph(in);
+            if (in.eof()) break;
+         }
+      }
+      else if (kind == 1) {
+         file.open(path);
+         for (;;) {
+            GraphM G;
+            if (!G.buildGraph(file)) break;
+         }
+      }
+      else {
+         file.open(path);
+         int count, from, to, length;
+         while (file.readCount(count)) {
+            for (int i = 1; i <= count; i++) {
+               file.readLabel();
+            }
+            while (file.readEdge(from, to, length)) {
+            }
+         }
+      }
+      auto stop = chrono::steady_clock::now();
+      double ms = chrono::duration<double, milli>(stop - start).count();
+      string name = kind == 0 ? "ifstream, buildGraph"
+                    : kind == 1 ? "GraphFile, buildGraph"
+                    : "GraphFile, scan only";
+      cout << setw(26) << left << name << setw(12) << left << ms
+           << megabytes / (ms / 1000) << endl;
+   }
+   remove(path.c_str());
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchSnapshot
+// Prints the time to load a large graph from its text, through an ifstream
+// and through a GraphFile, against loading a binary snapshot of it with and
+// without checking the whole file
+void benchSnapshot() {
+   const int nodes = 1250000;
+   string textPath = "/tmp/benchsnapshot.txt";
+   string snapshotPath = "/tmp/benchsnapshot.bin";
+   {
+      CSRGraph g = randomEdges(nodes, 8, 343);
+      int fd = open(textPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      OutputBuffer out(fd);
+      out.putInt(nodes);
+      out.put('\n');
+      for (int i = 1; i <= nodes; i++) {
+         out.putText("node ");
+         out.putInt(i);
+         out.put('\n');
+      }
+      for (int v = 1; v <= nodes; v++) {
+         for (int e = g.begin(v); e < g.end(v); e++) {
+            out.putInt(v);
+            out.put(' ');
+            out.putInt(g.target(e));
+            out.put(' ');
+            out.putInt(g.weight(e));
+            out.put('\n');
+         }
+      }
+      out.putText("0 0 0\n");
+      out.flush();
+      close(fd);
+   }
+
+   GraphFile file;
+   file.open(textPath);
+   cout << "loading " << nodes << " nodes, text of " << fixed
+        << setprecision(1) << file.size() / 1e6 << " MB" << endl;
+   file.close();
+   cout << setw(26) << left << "load" << "ms" << endl;
+
+   for (int kind = 0; kind < 4; kind++) {
+      GraphM G;
+      auto start = chrono::steady_clock::now();
+      if (kind == 0) {
+         ifstream in(textPath);
+         G.buildGraph(in);
+      }
+      else if (kind == 1) {
+         file.open(textPath);
+         G.buildGraph(file);
+         file.close();
+      }
+      else {
+         G.loadSnapshot(snapshotPath, kind == 2);
+      }
+      auto stop = chrono::steady_clock::now();
+      string name = kind == 0 ? "ifstream, buildGraph"
+                    : kind == 1 ? "GraphFile, buildGraph"
+                    : kind == 2 ? "snapshot, checked"
+                    : "snapshot, unchecked";
+      cout << setw(26) << left << name
+           << chrono::duration<double, milli>(stop - start).count() << endl;
+
+      if (kind == 1) {
+         start = chrono::steady_clock::now();
+         G.saveSnapshot(snapshotPath);
+         stop = chrono::steady_clock::now();
+         cout << setw(26) << left << "(saving the snapshot)"
+              << chrono::duration<double, milli>(stop - start).count()
+              << endl;
+      }
+   }
+   remove(textPath.c_str());
+   remove(snapshotPath.c_str());
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchPipeline
+// Prints graphs per second for a file of many small graphs, solved and
+// printed one at a time as lab3 does, and by a BatchRunner with growing
+// numbers of workers, the output goes to /dev/null
+void benchPipeline() {
+   const int graphs = 2000;
+   string text;
+   for (int g = 0; g < graphs; g++) {
+      text += randomGraph(60, 0.1, 343 + g);
+   }
+   int devNull = open("/dev/null", O_WRONLY);
+   cout << "pipeline, " << graphs << " graphs of 60 nodes" << endl;
+   cout << setw(26) << left << "runner" << setw(12) << left << "ms"
+        << "graphs/s" << endl;
+
+   for (int workers = 0; workers <= ThreadPool::hardwareThreads();
+        workers = workers == 0 ? 1 : workers * 2) {
+      GraphFile file;
+      file.attach(text.data(), text.size());
+      OutputBuffer out(devNull);
+      auto start = chrono::steady_clock::now();
+      if (workers == 0) {
+         for (;;) {
+            GraphM G;
+            if (!G.buildGraph(file)) break;
+            G.findShortestPath();
+            G.displayAll(out);
+         }
+      }
+      else {
+         BatchRunner runner(workers);
+         runner.run(file, out);
+      }
+      auto stop = chrono::steady_clock::now();
+      double ms = chrono::duration<double, milli>(stop - start).count();
+      string name = workers == 0 ? "one at a time"
+                    : to_string(workers) + " worker"
+                      + (workers > 1 ? "s" : "");
+      cout << setw(26) << left << name << setw(12) << left << fixed
+           << setprecision(1) << ms << graphs / (ms / 1000) << endl;
+   }
+   close(devNull);
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchLabels
+// Prints the time, allocations and bytes to copy a million labels held one
+// string each in NodeData objects, against one LabelStore, and the time to
+// find a label by a linear scan against the LabelStore index
+void benchLabels() {
+   const int count = 1000000;
+   vector<NodeData> nodes;
+   LabelStore store;
+   size_t stringBytes = 0;
+   for (int i = 1; i <= count; i++) {
+      string name = "Intersection of street " + to_string(i) + " and avenue "
+                    + to_string(i % 97);
+      nodes.emplace_back(name);
+      store.add(name);
+      stringBytes += sizeof(NodeData) +
+                     (name.size() > 15 ? name.size() + 1 : 0);
+   }
+   cout << "labels, " << count << " of about "
+        << store.textBytes() / count << " chars" << endl;
+   cout << setw(26) << left << "copy" << setw(12) << left << "ms"
+        << setw(14) << left << "allocations" << "MB" << endl;
+
+   for (int kind = 0; kind < 2; kind++) {
+      long before = allocationCount();
+      auto start = chrono::steady_clock::now();
+      size_t held = 0;
+      size_t bytes = stringBytes;
+      if (kind == 0) {
+         vector<NodeData> copy(nodes);
+         held = copy.size();
+      }
+      else {
+         LabelStore copy(store);
+         held = copy.count();
+         bytes = copy.memoryBytes();
+      }
+      auto stop = chrono::steady_clock::now();
+      long made = allocationCount() - before;
+      double mb = bytes / 1e6;
+      cout << setw(26) << left
+           << (kind == 0 ? "vector<NodeData>" : "LabelStore")
+           << setw(12) << left << fixed << setprecision(1)
+           << chrono::duration<double, milli>(stop - start).count()
+           << setw(14) << left << made << mb
+           << (held == (size_t)count ? "" : " (short)") << endl;
+   }
+
+   // The index is built by the first find, labels near the end are the
+   // worst case for a scan
+   const int finds = 20;
+   auto start = chrono::steady_clock::now();
+   store.find("");
+   auto stop = chrono::steady_clock::now();
+   cout << setw(26) << left << "(building the index)" << fixed
+        << setprecision(1) << chrono::duration<double, milli>(stop - start)
+        .count() << " ms, " << store.memoryBytes() / 1e6 << " MB" << endl;
+   cout << setw(26) << left << "find" << "us per label" << endl;
+   for (int kind = 0; kind < 2; kind++) {
+      long found = 0;
+      auto start = chrono::steady_clock::now();
+      for (int q = 0; q < finds; q++) {
+         NodeData target = nodes[count - 1 - q];
+         if (kind == 0) {
+            for (int i = 0; i < count; i++) {
+               if (nodes[i] == target) {
+                  found += i + 1;
+                  break;
+               }
+            }
+         }
+         else {
+            found += store.find(store.label(count - q));
+         }
+      }
+      auto stop = chrono::steady_clock::now();
+      cout << setw(26) << left << (kind == 0 ? "linear scan" : "index")
+           << fixed << setprecision(2)
+           << chrono::duration<double, micro>(stop - start).count() / finds
+           << (found > 0 ? "" : " (missing)") << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// sparseGraph
+// Returns the text of a GraphL graph with n nodes and the given number of
+// edges, each between 2 nodes picked at random
+string sparseGraph(int n, int edges, unsigned seed) {
+   mt19937 rng(seed);
+   uniform_int_distribution<int> pick(1, n);
+   ostringstream out;
+   out << n << "\n";
+   for (int i = 1; i <= n; i++) {
+      out << "node " << i << "\n";
+   }
+   for (int e = 0; e < edges; e++) {
+      int from = pick(rng);
+      out << from << " " << pick(rng) << "\n";
+   }
+   out << "0 0\n";
+   return out.str();
+}
+
+//---------------------------------------------------------------------------
+// benchAdjacency
+// Prints the time to build a large sparse GraphL, search it depth first and
+// print it with displayGraph, and the bytes per edge, for the adjacency
+// lists GraphL used to hold (a list node per edge, added to the front)
+// against its edge arrays, and checks that both give the same ordering
+void benchAdjacency() {
+   const int nodes = 1000000;
+   const int edges = 8000000;
+   string text = sparseGraph(nodes, edges, 343);
+   cout << "adjacency, " << nodes << " nodes, " << edges << " edges" << endl;
+   cout << setw(26) << left << "layout" << setw(12) << left << "build ms"
+        << setw(12) << left << "search ms" << setw(12) << left << "print ms"
+        << "B per edge" << endl;
+
+   int devNull = open("/dev/null", O_WRONLY);
+   vector<int> listOrder;
+   for (int kind = 0; kind < 2; kind++) {
+      GraphFile file;
+      vector<list<int>> lists;
+      LabelStore labels;
+      GraphL L;
+      double bytes = 0;
+
+      file.attach(text.data(), text.size());
+      auto start = chrono::steady_clock::now();
+      if (kind == 0) {
+         int count, from, to;
+         file.readCount(count);
+         lists.assign(count + 1, list<int>());
+         for (int i = 1; i <= count; i++) {
+            labels.add(file.readLabel());
+         }
+         while (file.readPair(from, to)) {
+            lists[from].push_front(to);
+         }
+         // A list node holds 2 links and the int, padded to a link
+         bytes = (double)edges * 3 * sizeof(void*) +
+                 lists.size() * sizeof(list<int>);
+      }
+      else {
+         L.buildGraph(file);
+         bytes = L.memoryBytes();
+      }
+      auto built = chrono::steady_clock::now();
+
+      // The lists are searched the way depthFirstOrder searches the arrays
+      const vector<int>* order = &listOrder;
+      if (kind == 0) {
+         vector<bool> seen(nodes + 1, false);
+         vector<pair<int, list<int>::const_iterator>> stack;
+         for (int i = 1; i <= nodes; i++) {
+            if (seen[i]) continue;
+            seen[i] = true;
+            listOrder.push_back(i);
+            stack.push_back(make_pair(i, lists[i].cbegin()));
+            while (!stack.empty()) {
+               auto& top = stack.back();
+               while (top.second != lists[top.first].cend() &&
+                      seen[*top.second]) {
+                  ++top.second;
+               }
+               if (top.second == lists[top.first].cend()) {
+                  stack.pop_back();
+                  continue;
+               }
+               int w = *top.second++;
+               seen[w] = true;
+               listOrder.push_back(w);
+               stack.push_back(make_pair(w, lists[w].cbegin()));
+            }
+         }
+      }
+      else {
+         order = &L.depthFirstOrder();
+      }
+      auto searched = chrono::steady_clock::now();
+
+      // The lists are printed as displayGraph printed them
+      OutputBuffer out(devNull);
+      if (kind == 0) {
+         out.putText("Graph:\n");
+         for (int v = 1; v <= nodes; v++) {
+            out.putText("Node ");
+            out.putInt(v);
+            out.putText("\t\t");
+            out.putText(labels.label(v));
+            out.put('\n');
+            for (int w : lists[v]) {
+               out.putText("    edge ");
+               out.putInt(v);
+               out.put(' ');
+               out.putInt(w);
+               out.put('\n');
+            }
+         }
+         out.put('\n');
+         out.flush();
+      }
+      else {
+         L.displayGraph(out);
+      }
+      auto stop = chrono::steady_clock::now();
+
+      auto ms = [](chrono::steady_clock::duration d) {
+         return chrono::duration<double, milli>(d).count();
+      };
+      cout << setw(26) << left
+           << (kind == 0 ? "list<int> per node" : "GraphL edge arrays")
+           << fixed << setprecision(1) << setw(12) << left
+           << ms(built - start) << setw(12) << left << ms(searched - built)
+           << setw(12) << left << ms(stop - searched) << bytes / edges
+           << (kind == 1 && *order != listOrder ? " (differs)" : "")
+           << endl;
+   }
+   close(devNull);
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchGraphCopy
+// Prints the time and allocations to copy and to move a built GraphM with
+// its table filled and a large sparse GraphL, a move only hands over the
+// arrays the graph holds
+void benchGraphCopy() {
+   const int matrixNodes = 1000;
+   const int listNodes = 1000000;
+   GraphM M;
+   {
+      istringstream in(randomGraph(matrixNodes, 0.01, 345));
+      M.buildGraph(in);
+   }
+   M.findShortestPath();
+   GraphL L;
+   {
+      string text = sparseGraph(listNodes, 2 * listNodes, 345);
+      GraphFile file;
+      file.attach(text.data(), text.size());
+      L.buildGraph(file);
+   }
+   cout << "graph copy, GraphM of " << matrixNodes << " nodes, GraphL of "
+        << listNodes << " nodes" << endl;
+   cout << setw(26) << left << "graph" << setw(12) << left << "ms"
+        << "allocations" << endl;
+
+   for (int kind = 0; kind < 4; kind++) {
+      long before = allocationCount();
+      auto start = chrono::steady_clock::now();
+      if (kind == 0) {
+         GraphM copy(M);
+      }
+      else if (kind == 1) {
+         GraphM moved(move(M));
+         M = move(moved);
+      }
+      else if (kind == 2) {
+         GraphL copy(L);
+      }
+      else {
+         GraphL moved(move(L));
+         L = move(moved);
+      }
+      auto stop = chrono::steady_clock::now();
+      long made = allocationCount() - before;
+      const char* names[4] = { "GraphM copy", "GraphM move and back",
+                               "GraphL copy", "GraphL move and back" };
+      cout << setw(26) << left << names[kind] << setw(12) << left << fixed
+           << setprecision(3)
+           << chrono::duration<double, milli>(stop - start).count() << made
+           << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchTableFile
+// Prints the time to fill the table and print it with displayAll, and the
+// bytes of table held in memory and on disk, for a table in memory against
+// one in a file with 4, 2 and 1 byte distances, then the time to finish a
+// table file left half done by a process that was killed
+void benchTableFile() {
+   const int nodes = 3000;
+   string text = randomGraph(nodes, 4.0 / nodes, 343);
+   string tablePath = "/tmp/benchtable.bin";
+   int devNull = open("/dev/null", O_WRONLY);
+   cout << "table of " << nodes << " nodes" << endl;
+   cout << setw(16) << left << "table" << setw(12) << left << "fill ms"
+        << setw(14) << left << "display ms" << setw(14) << left
+        << "memory MB" << "file MB" << endl;
+
+   // Width 0 keeps the table in memory
+   const int widths[] = { 0, 4, 2, 1 };
+   double fullMs = 0;
+   for (int width : widths) {
+      remove(tablePath.c_str());
+      GraphM G;
+      istringstream in(text);
+      G.buildGraph(in);
+      if (width > 0) {
+         G.setTableFile(tablePath, width);
+      }
+      auto start = chrono::steady_clock::now();
+      G.findShortestPath();
+      auto filled = chrono::steady_clock::now();
+      OutputBuffer out(devNull);
+      G.displayAll(out);
+      auto stop = chrono::steady_clock::now();
+
+      // A file table holds one row per worker in memory while it fills
+      size_t held = (width == 0 ? nodes + 1 : 1) * PathRow::bytesFor(nodes);
+      struct stat info;
+      double fileMb = width > 0 && stat(tablePath.c_str(), &info) == 0
+                      ? info.st_blocks * 512 / 1e6 : 0;
+      double fillMs = chrono::duration<double, milli>(filled - start)
+                      .count();
+      if (width == 2) {
+         fullMs = fillMs;
+      }
+      cout << setw(16) << left
+           << (width == 0 ? string("memory")
+                          : "file, " + to_string(width) + " byte")
+           << setw(12) << left << fixed << setprecision(1) << fillMs
+           << setw(14) << left
+           << chrono::duration<double, milli>(stop - filled).count()
+           << setw(14) << left << setprecision(2) << held / 1e6 << fileMb
+           << endl;
+   }
+
+   // A child fills the table and is killed about half way through
+   remove(tablePath.c_str());
+   pid_t child = fork();
+   if (child == 0) {
+      GraphM G;
+      istringstream in(text);
+      G.buildGraph(in);
+      G.setTableFile(tablePath, 2);
+      G.findShortestPath();
+      _exit(0);
+   }
+   usleep((useconds_t)(fullMs * 500));
+   kill(child, SIGKILL);
+   waitpid(child, nullptr, 0);
+
+   GraphM G;
+   istringstream in(text);
+   G.buildGraph(in);
+   G.setTableFile(tablePath, 2);
+   auto start = chrono::steady_clock::now();
+   G.findShortestPath();
+   auto stop = chrono::steady_clock::now();
+   cout << "after a kill, " << G.resumedRows() << " rows kept, the rest "
+        << "filled in " << fixed << setprecision(1)
+        << chrono::duration<double, milli>(stop - start).count() << " ms"
+        << endl;
+   remove(tablePath.c_str());
+   close(devNull);
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchBreadthFirst
+// Prints the time of a breadth-first search from several sources of a large
+// sparse GraphL, and the edges out of the nodes reached per second, keeping
+// to top-down against going bottom-up when the frontier is large, on one
+// thread and on every hardware thread, and checks the levels all agree
+void benchBreadthFirst() {
+   const int nodes = 1000000;
+   const int edges = 10000000;
+   const int sources = 8;
+   GraphL L;
+   {
+      string text = sparseGraph(nodes, edges, 343);
+      GraphFile file;
+      file.attach(text.data(), text.size());
+      L.buildGraph(file);
+   }
+   int threads = ThreadPool::hardwareThreads();
+   cout << "breadth-first, " << nodes << " nodes, " << edges << " edges, "
+        << sources << " sources" << endl;
+   cout << setw(30) << left << "search" << setw(12) << left << "ms"
+        << setw(12) << left << "MTEPS" << "steps down/up" << endl;
+
+   // The first search also makes the reverse edges, it is not timed
+   BreadthFirst first;
+   L.breadthFirstSearch(1, first);
+   mt19937 rng(343);
+   vector<int> starts;
+   for (int q = 0; q < sources; q++) {
+      starts.push_back(uniform_int_distribution<int>(1, nodes)(rng));
+   }
+
+   vector<vector<int>> expected(sources);
+   for (int kind = 0; kind < 3; kind++) {
+      BreadthFirst search;
+      search.setBottomUp(kind > 0);
+      L.setThreadCount(kind == 2 ? threads : 1);
+      double ms = 0;
+      double traversed = 0;
+      bool same = true;
+      for (int q = 0; q < sources; q++) {
+         auto start = chrono::steady_clock::now();
+         L.breadthFirstSearch(starts[q], search);
+         auto stop = chrono::steady_clock::now();
+         ms += chrono::duration<double, milli>(stop - start).count();
+
+         // Each node reached has edges / nodes edges out, on average
+         traversed += (double)search.reachedCount() * edges / nodes;
+         vector<int> levels(nodes + 1);
+         for (int v = 1; v <= nodes; v++) {
+            levels[v] = search.level(v);
+         }
+         if (kind == 0) {
+            expected[q] = levels;
+         }
+         same = same && levels == expected[q];
+      }
+      string name = kind == 0 ? "top-down, 1 thread"
+                    : kind == 1 ? "direction-optimizing, 1"
+                    : "direction-optimizing, " + to_string(threads);
+      cout << setw(30) << left << name << setw(12) << left << fixed
+           << setprecision(1) << ms / sources << setw(12) << left
+           << traversed / (ms / 1000) / 1e6 << search.topDownSteps() << "/"
+           << search.bottomUpSteps() << (same ? "" : " (differs)") << endl;
+   }
+   L.setThreadCount(1);
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchComponents
+// Prints the time to find the strongly connected components of a large
+// sparse GraphL with Tarjan's algorithm and with forward-backward and
+// coloring, on one thread and on every hardware thread, the size of the
+// condensation, then the time of a reachability query answered through the
+// condensation against a breadth-first search of the whole graph
+void benchComponents() {
+   const int nodes = 1000000;
+   const int edges = 1500000;
+   const int queries = 200;
+   GraphL L;
+   {
+      string text = sparseGraph(nodes, edges, 343);
+      GraphFile file;
+      file.attach(text.data(), text.size());
+      L.buildGraph(file);
+   }
+   int threads = ThreadPool::hardwareThreads();
+   cout << "components, " << nodes << " nodes, " << edges << " edges"
+        << endl;
+   cout << setw(30) << left << "method" << setw(12) << left << "ms"
+        << setw(14) << left << "components" << setw(12) << left
+        << "largest" << "DAG edges" << endl;
+
+   // The first call also makes the reverse edges, it is not timed
+   Components C;
+   L.strongComponents(C);
+   vector<int> expected(nodes + 1);
+   for (int kind = 0; kind < 3; kind++) {
+      C.setMethod(kind == 0 ? Components::TARJAN
+                            : Components::FORWARD_BACKWARD);
+      L.setThreadCount(kind == 2 ? threads : 1);
+      auto start = chrono::steady_clock::now();
+      L.strongComponents(C);
+      auto stop = chrono::steady_clock::now();
+
+      // Numbers differ between methods, nodes sharing one must not
+      int largest = 0;
+      bool same = true;
+      vector<int> first(C.componentCount() + 1, 0);
+      for (int v = 1; v <= nodes; v++) {
+         int c = C.component(v);
+         if (first[c] == 0) {
+            first[c] = v;
+         }
+         if (kind == 0) {
+            expected[v] = first[c];
+         }
+         same = same && expected[v] == first[c];
+      }
+      for (int c = 1; c <= C.componentCount(); c++) {
+         largest = max(largest, C.componentSize(c));
+      }
+      string name = kind == 0 ? "Tarjan"
+                    : kind == 1 ? "forward-backward, 1"
+                    : "forward-backward, " + to_string(threads);
+      cout << setw(30) << left << name << setw(12) << left << fixed
+           << setprecision(1)
+           << chrono::duration<double, milli>(stop - start).count()
+           << setw(14) << left << C.componentCount() << setw(12) << left
+           << largest << C.condensation().edgeCount()
+           << (same ? "" : " (differs)") << endl;
+   }
+   L.setThreadCount(1);
+
+   mt19937 rng(343);
+   uniform_int_distribution<int> pick(1, nodes);
+   vector<pair<int, int>> pairs;
+   for (int q = 0; q < queries; q++) {
+      pairs.push_back(make_pair(pick(rng), pick(rng)));
+   }
+   cout << setw(30) << left << "query" << "us per query" << endl;
+   int answers[2] = { 0, 0 };
+   for (int kind = 0; kind < 2; kind++) {
+      BreadthFirst search;
+      auto start = chrono::steady_clock::now();
+      for (const pair<int, int>& q : pairs) {
+         if (kind == 0) {
+            L.breadthFirstSearch(q.first, search);
+            answers[kind] += search.level(q.second) != INT_MAX;
+         }
+         else {
+            answers[kind] += C.reaches(q.first, q.second);
+         }
+      }
+      auto stop = chrono::steady_clock::now();
+      cout << setw(30) << left
+           << (kind == 0 ? "breadth-first search" : "condensation")
+           << fixed << setprecision(1)
+           << chrono::duration<double, micro>(stop - start).count() / queries
+           << (kind == 1 && answers[1] != answers[0] ? " (differs)" : "")
+           << endl;
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchReachIndex
+// Prints the time to build a reachability index over the condensation of a
+// medium and a large sparse GraphL, with each method that fits, the memory
+// it holds and the time of a query, against a search of the condensation
+void benchReachIndex() {
+   const int sizes[2][2] = { { 20000, 30000 }, { 1000000, 1500000 } };
+   const int queries = 100000;
+   cout << "reachability index" << endl;
+   cout << setw(30) << left << "graph, method" << setw(12) << left
+        << "build ms" << setw(12) << left << "MB" << setw(16) << left
+        << "us per query" << "search us" << endl;
+   for (int g = 0; g < 2; g++) {
+      int nodes = sizes[g][0];
+      GraphL L;
+      {
+         string text = sparseGraph(nodes, sizes[g][1], 344 + g);
+         GraphFile file;
+         file.attach(text.data(), text.size());
+         L.buildGraph(file);
+      }
+      Components C;
+      L.strongComponents(C);
+
+      mt19937 rng(344 + g);
+      uniform_int_distribution<int> pick(1, nodes);
+      vector<pair<int, int>> pairs;
+      for (int q = 0; q < queries; q++) {
+         pairs.push_back(make_pair(pick(rng), pick(rng)));
+      }
+      int expected = 0;
+      auto start = chrono::steady_clock::now();
+      for (const pair<int, int>& q : pairs) {
+         expected += C.reaches(q.first, q.second);
+      }
+      auto stop = chrono::steady_clock::now();
+      double searchUs =
+         chrono::duration<double, micro>(stop - start).count() / queries;
+
+      // The closure of the large graph would not fit in memory
+      for (int kind = 0; kind < (g == 0 ? 2 : 1); kind++) {
+         ReachIndex index;
+         index.setMethod(kind == 0 ? ReachIndex::TWO_HOP
+                                   : ReachIndex::CLOSURE);
+         index.build(C);
+         int answers = 0;
+         start = chrono::steady_clock::now();
+         for (const pair<int, int>& q : pairs) {
+            answers += index.reaches(q.first, q.second);
+         }
+         stop = chrono::steady_clock::now();
+         string name = to_string(nodes) + ", " +
+                       (kind == 0 ? "2-hop labels" : "closure");
+         cout << setw(30) << left << name << setw(12) << left << fixed
+              << setprecision(1) << index.buildMs() << setw(12) << left
+              << index.memoryBytes() / 1048576.0 << setw(16) << left
+              << setprecision(3)
+              << chrono::duration<double, micro>(stop - start).count() /
+                    queries
+              << searchUs << (answers != expected ? " (differs)" : "")
+              << endl;
+      }
+   }
+   cout << endl;
+}
+
+//---------------------------------------------------------------------------
+// SuiteGraph
+// Nodes and edges of a generated graph, for the suite
+struct SuiteGraph {
+   string family;          // generator that made it
+   int nodes;              // node count
+   vector<Edge> edges;     // every edge, lengths 1 and up
+};
+
+//---------------------------------------------------------------------------
+// SuiteResult
+// One timed phase of the suite, a line of its JSON results
+struct SuiteResult {
+   string family;          // generator of the graph
+   string graph;           // GraphM or GraphL
+   string phase;           // function timed
+   int nodes;              // nodes of the graph
+   long edges;             // edges of the graph
+   double ms;              // time per call
+   long peakKb;            // peak resident memory during the phase
+};
+
+//---------------------------------------------------------------------------
+// distinctEdges
+// Drops self loops and repeated origin, destination pairs, keeping the
+// first of each, and sorts the edges by origin then destination
+void distinctEdges(vector<Edge>& edges) {
+   stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+      return a.from != b.from ? a.from < b.from : a.to < b.to;
+   });
+   vector<Edge> kept;
+   for (const Edge& edge : edges) {
+      if (edge.from != edge.to && (kept.empty() ||
+          kept.back().from != edge.from || kept.back().to != edge.to)) {
+         kept.push_back(edge);
+      }
+   }
+   edges.swap(kept);
+}
+
+//---------------------------------------------------------------------------
+// gridSuite
+// Returns a side x side grid of about n nodes, as gridEdges makes it
+SuiteGraph gridSuite(int n, unsigned seed) {
+   int side = max(2, (int)sqrt((double)n));
+   return SuiteGraph{"grid", side * side, gridEdges(side, seed)};
+}
+
+//---------------------------------------------------------------------------
+// erdosRenyiSuite
+// Returns an Erdos-Renyi graph of n nodes with about degree times n edges,
+// each between a uniformly random ordered pair of nodes
+SuiteGraph erdosRenyiSuite(int n, int degree, unsigned seed) {
+   mt19937 rng(seed);
+   SuiteGraph g{"erdos-renyi", n, {}};
+   for (long e = 0; e < (long)n * degree; e++) {
+      g.edges.push_back(Edge{(int)(rng() % n) + 1, (int)(rng() % n) + 1,
+                             (int)(rng() % 100) + 1});
+   }
+   distinctEdges(g.edges);
+   return g;
+}
+
+//---------------------------------------------------------------------------
+// powerLawSuite
+// Returns a preferential attachment (Barabasi-Albert) graph of n nodes,
+// each new node links both ways to degree nodes picked in proportion to
+// the edges they already have, so a few hubs hold many edges
+SuiteGraph powerLawSuite(int n, int degree, unsigned seed) {
+   mt19937 rng(seed);
+   SuiteGraph g{"power-law", n, {}};
+   vector<int> ends;       // each node once per edge it has
+   for (int v = 1; v <= n; v++) {
+      for (int d = 0; d < degree && v > 1; d++) {
+         int u = ends.empty() ? 1 : ends[rng() % ends.size()];
+         int length = rng() % 100 + 1;
+         g.edges.push_back(Edge{v, u, length});
+         g.edges.push_back(Edge{u, v, length});
+         ends.push_back(u);
+         ends.push_back(v);
+      }
+   }
+   distinctEdges(g.edges);
+   return g;
+}
+
+//---------------------------------------------------------------------------
+// roadSuite
+// Returns a road-like graph of about n nodes: points jittered off a grid,
+// most grid neighbours joined both ways and a few diagonals, each edge as
+// long as the straight line between its ends
+SuiteGraph roadSuite(int n, unsigned seed) {
+   mt19937 rng(seed);
+   uniform_real_distribution<double> jitter(-0.3, 0.3);
+   uniform_real_distribution<double> coin(0.0, 1.0);
+   int side = max(2, (int)sqrt((double)n));
+   SuiteGraph g{"road", side * side, {}};
+   vector<double> x(side * side + 1), y(side * side + 1);
+   for (int v = 1; v <= side * side; v++) {
+      x[v] = (v - 1) % side + jitter(rng);
+      y[v] = (v - 1) / side + jitter(rng);
+   }
+   auto join = [&](int a, int b) {
+      int length = (int)(100 * hypot(x[a] - x[b], y[a] - y[b])) + 1;
+      g.edges.push_back(Edge{a, b, length});
+      g.edges.push_back(Edge{b, a, length});
+   };
+   for (int r = 0; r < side; r++) {
+      for (int c = 0; c < side; c++) {
+         int v = r * side + c + 1;
+         if (c + 1 < side && coin(rng) < 0.85) {
+            join(v, v + 1);
+         }
+         if (r + 1 < side && coin(rng) < 0.85) {
+            join(v, v + side);
+         }
+         if (c + 1 < side && r + 1 < side && coin(rng) < 0.1) {
+            join(v, v + side + 1);
+         }
+      }
+   }
+   distinctEdges(g.edges);
+   return g;
+}
+
+//---------------------------------------------------------------------------
+// suiteGraphs
+// Returns one graph of about n nodes from each generator
+vector<SuiteGraph> suiteGraphs(int n, unsigned seed) {
+   return { gridSuite(n, seed), erdosRenyiSuite(n, 4, seed),
+            powerLawSuite(n, 3, seed), roadSuite(n, seed) };
+}
+
+//---------------------------------------------------------------------------
+// suiteText
+// Returns the graph in the data31.txt format GraphM reads, or with the
+// lengths left out in the format GraphL reads
+string suiteText(const SuiteGraph& g, bool lengths) {
+   OutputBuffer out;
+   out.putInt(g.nodes);
+   out.put('\n');
+   for (int v = 1; v <= g.nodes; v++) {
+      out.putText(g.family.c_str());
+      out.put(' ');
+      out.putInt(v);
+      out.put('\n');
+   }
+   for (const Edge& edge : g.edges) {
+      out.putInt(edge.from);
+      out.put(' ');
+      out.putInt(edge.to);
+      if (lengths) {
+         out.put(' ');
+         out.putInt(edge.length);
+      }
+      out.put('\n');
+   }
+   out.putText(lengths ? "0 0 0\n" : "0 0\n");
+   return string(out.data(), out.size());
+}
+
+//---------------------------------------------------------------------------
+// writeSuiteFile
+// Writes the text of the graph to the file, returns false if it could not
+bool writeSuiteFile(const string& path, const SuiteGraph& g, bool lengths) {
+   ofstream file(path, ios::binary);
+   string text = suiteText(g, lengths);
+   file.write(text.data(), text.size());
+   return file.good();
+}
+
+//---------------------------------------------------------------------------
+// resetPeak
+// Starts a new peak resident memory count by writing 5 to
+// /proc/self/clear_refs, returns false if the kernel does not allow it, the
+// peak is then the process's since it started
+bool resetPeak() {
+   int fd = open("/proc/self/clear_refs", O_WRONLY);
+   if (fd < 0) {
+      return false;
+   }
+   bool reset = write(fd, "5", 1) == 1;
+   close(fd);
+   return reset;
+}
+
+//---------------------------------------------------------------------------
+// peakKb
+// Returns the peak resident memory in KB since the last resetPeak, read
+// from VmHWM in /proc/self/status, or from getrusage if that is missing
+long peakKb() {
+   ifstream status("/proc/self/status");
+   string line;
+   while (getline(status, line)) {
+      if (line.compare(0, 6, "VmHWM:") == 0) {
+         return atol(line.c_str() + 6);
+      }
+   }
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+//---------------------------------------------------------------------------
+// timePhase
+// Runs the work the given number of times and adds its time per call and
+// peak memory to the results, the graph's memory before the phase counts
+// toward its peak
+void timePhase(vector<SuiteResult>& results, const SuiteGraph& g,
+               const string& graph, const string& phase, int reps,
+               const function<void()>& work) {
+   resetPeak();
+   auto start = chrono::steady_clock::now();
+   for (int r = 0; r < reps; r++) {
+      work();
+   }
+   auto stop = chrono::steady_clock::now();
+   results.push_back(SuiteResult{g.family, graph, phase, g.nodes,
+                                 (long)g.edges.size(),
+                                 chrono::duration<double, milli>(stop - start)
+                                 .count() / reps, peakKb()});
+}
+
+//---------------------------------------------------------------------------
+// writeSuiteJson
+// Writes the results to the file as JSON, one object per phase with its
+// time in ms and in ns per edge, returns false if it could not be written
+bool writeSuiteJson(const string& path, int scale,
+                    const vector<SuiteResult>& results) {
+   ofstream out(path);
+   out << "{\n  \"scale\": " << scale << ",\n  \"results\": [\n";
+   for (size_t k = 0; k < results.size(); k++) {
+      const SuiteResult& r = results[k];
+      out << "    {\"family\": \"" << r.family << "\", \"graph\": \""
+          << r.graph << "\", \"phase\": \"" << r.phase << "\", \"nodes\": "
+          << r.nodes << ", \"edges\": " << r.edges << ", \"ms\": " << fixed
+          << setprecision(3) << r.ms << ", \"ns_per_edge\": "
+          << setprecision(1) << r.ms * 1e6 / max(r.edges, 1L)
+          << ", \"peak_rss_kb\": " << r.peakKb << "}"
+          << (k + 1 < results.size() ? "," : "") << "\n";
+   }
+   out << "  ]\n}\n";
+   return out.good();
+}
+
+//---------------------------------------------------------------------------
+// benchSuite
+// Times buildGraph, findShortestPath and displayAll of GraphM and
+// buildGraph, displayGraph and depthFirstSearch of GraphL on a graph from
+// each generator, prints a table and writes the results as JSON, the text
+// of each graph is also written next to the JSON file
+void benchSuite(int scale = 2000,
+                const string& jsonPath = "/tmp/benchsuite.json") {
+   const int listReps = 20;
+   string folder = jsonPath.substr(0, jsonPath.find_last_of('/') + 1);
+   int devNull = open("/dev/null", O_WRONLY);
+   vector<SuiteResult> results;
+
+   vector<SuiteGraph> graphs = suiteGraphs(scale, 343);
+   for (size_t k = 0; k < graphs.size(); k++) {
+      const SuiteGraph& g = graphs[k];
+      string text = suiteText(g, true);
+      writeSuiteFile(folder + "suite-" + g.family + ".txt", g, true);
+
+      GraphM G;
+      timePhase(results, g, "GraphM", "buildGraph", 1, [&] {
+         istringstream in(text);
+         G.buildGraph(in);
+      });
+      timePhase(results, g, "GraphM", "findShortestPath", 1, [&] {
+         G.findShortestPath();
+      });
+      timePhase(results, g, "GraphM", "displayAll", 1, [&] {
+         OutputBuffer out(devNull);
+         G.displayAll(out);
+      });
+
+      // GraphL only prints, the text goes nowhere
+      string listText = suiteText(g, false);
+      GraphL L;
+      timePhase(results, g, "GraphL", "buildGraph", listReps, [&] {
+         istringstream in(listText);
+         L.buildGraph(in);
+      });
+      timePhase(results, g, "GraphL", "displayGraph", listReps, [&] {
+         OutputBuffer out(devNull);
+         L.displayGraph(out);
+      });
+      NullBuffer sink;
+      streambuf* console = cout.rdbuf(&sink);
+      timePhase(results, g, "GraphL", "depthFirstSearch", listReps, [&] {
+         L.depthFirstSearch();
+      });
+      cout.rdbuf(console);
+   }
+   close(devNull);
+
+   cout << "suite, about " << scale << " nodes, results in " << jsonPath
+        << endl;
+   cout << setw(13) << left << "family" << setw(8) << left << "graph"
+        << setw(18) << left << "phase" << setw(10) << left << "edges"
+        << setw(12) << left << "ms" << setw(12) << left << "ns/edge"
+        << "peak MB" << endl;
+   for (const SuiteResult& r : results) {
+      cout << setw(13) << left << r.family << setw(8) << left << r.graph
+           << setw(18) << left << r.phase << setw(10) << left << r.edges
+           << setw(12) << left << fixed << setprecision(3) << r.ms
+           << setw(12) << left << setprecision(1)
+           << r.ms * 1e6 / max(r.edges, 1L) << r.peakKb / 1024.0 << endl;
+   }
+   if (!writeSuiteJson(jsonPath, scale, results)) {
+      cout << "could not write " << jsonPath << endl;
+   }
+   cout << endl;
+}
+
+int main(int argc, char** argv) {
+   // "suite [nodes] [json file]" runs only the suite
+   if (argc > 1 && string(argv[1]) == "suite") {
+      benchSuite(argc > 2 ? atoi(argv[2]) : 2000,
+                 argc > 3 ? argv[3] : "/tmp/benchsuite.json");
+      return 0;
+   }
+   benchHeaps();
+   benchThreads();
+   benchLazy();
+   benchUpdates();
+   benchLayout();
+   benchEngines();
+   benchPairs();
+   benchLandmarks();
+   benchHierarchy();
+   benchBatch();
+   benchOutput();
+   benchDeltaStepping();
+   benchParse();
+   benchSnapshot();
+   benchPipeline();
+   benchLabels();
+   benchGraphCopy();
+   benchTableFile();
+   benchAdjacency();
+   benchBreadthFirst();
+   benchComponents();
+   benchReachIndex();
+   benchSuite();
+   return 0;
+}
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------
+// BITARRAY.H
+// Class for a packed array of bits
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BitArray: one bit of true or false per index
+// and allows other features:
+//      --setting, clearing and testing the bit of an index
+//      --clearing every bit at once
+//
+// Implementation and assumptions:
+//      --bits are packed 64 to a word, so n flags take n / 8 bytes instead of
+//        the n bytes of an array of bool
+//      --indices are assumed to be in the range 0 to n given to resize
+//----------------------------------------------------------------------------
+
+#ifndef BITARRAY_H
+#define BITARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class BitArray {
+public:
+//----------------------------------------------------------------------------
+// resize
+// Preconditions:   None
+// Postconditions:  Array holds bits 0 to n, every bit is false
+    void resize(int n) {
+        words.assign(n / 64 + 1, 0);
+    }
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Every bit is false, the size stays the same
+    void clear() {
+        words.assign(words.size(), 0);
+    }
+
+//----------------------------------------------------------------------------
+// test
+// Preconditions:   i is in range
+// Postconditions:  Returns the bit of index i
+    bool test(int i) const {
+        return (words[i >> 6] >> (i & 63)) & 1;
+    }
+
+//----------------------------------------------------------------------------
+// set, reset
+// Preconditions:   i is in range
+// Postconditions:  Bit of index i is true, or false
+    void set(int i) {
+        words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    void reset(int i) {
+        words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the bits
+    size_t memoryBytes() const {
+        return words.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    vector<uint64_t> words;     // bits, 64 per word
+};
+
+#endif
@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------------
+// BOUNDEDQUEUE.H
+// Template class for a blocking first-in first-out queue of bounded size
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BoundedQueue: passes values from the threads of one stage of a pipeline
+// to the threads of the next
+// and allows other features:
+//      --push waits while the queue is full, so a fast stage is held back
+//        to the pace of the stage after it
+//      --pop waits while the queue is empty
+//      --closing the queue, after which pop drains what is left and then
+//        returns false
+//
+// Implementation and assumptions:
+//      --values are kept in a deque guarded by one mutex, with a condition
+//        variable for each side to wait on
+//      --any number of threads can push and pop at once
+//      --must be compiled with -pthread
+//----------------------------------------------------------------------------
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+using namespace std;
+
+template <class T>
+class BoundedQueue {
+public:
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   None
+// Postconditions:  Queue is empty, open and holds at most the given number
+//                  of values, at least 1
+    explicit BoundedQueue(size_t most) : capacity(most < 1 ? 1 : most),
+                                         closed(false) {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+//----------------------------------------------------------------------------
+// push
+// Preconditions:   None
+// Postconditions:  Waits while the queue is full, then adds the value to the
+//                  back and returns true, returns false if the queue is
+//                  closed
+    bool push(T value) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] {
+            return closed || items.size() < capacity;
+        });
+        if(closed) {
+            return false;
+        }
+        items.push_back(move(value));
+        guard.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+//----------------------------------------------------------------------------
+// pop
+// Preconditions:   None
+// Postconditions:  Waits while the queue is empty and open, then takes the
+//                  value at the front and returns true, returns false once
+//                  the queue is closed and empty
+    bool pop(T& value) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] {
+            return closed || !items.empty();
+        });
+        if(items.empty()) {
+            return false;
+        }
+        value = move(items.front());
+        items.pop_front();
+        guard.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No more values can be pushed, threads waiting on either
+//                  side are woken
+    void close() {
+        {
+            lock_guard<mutex> guard(lock);
+            closed = true;
+        }
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    mutex lock;                     // guards items and closed
+    condition_variable notFull;     // signals pushers that a value left
+    condition_variable notEmpty;    // signals poppers that a value arrived
+    deque<T> items;                 // values waiting, oldest first
+    size_t capacity;                // most values held at once
+    bool closed;                    // whether push is refused
+};
+
+#endif
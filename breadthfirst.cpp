@@ -0,0 +1,288 @@
+//----------------------------------------------------------------------------
+// BREADTHFIRST.CPP
+// Implementation for BreadthFirst Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BreadthFirst: hop level and parent of every node reached from a source
+// and allows other features:
+//      --running one search on several threads through a ThreadPool
+//      --counts of the steps run top-down and bottom-up by the last search
+//      --keeping to top-down, to measure what going bottom-up saves
+//
+// Implementation and assumptions:
+//      --the search goes one level at a time, each level is found either
+//        top-down, following the edges out of every node of the frontier,
+//        or bottom-up, where every node not yet reached looks through its
+//        edges in for one from the frontier and stops at the first (Beamer,
+//        Asanovic and Patterson)
+//      --it starts top-down and goes bottom-up once the edges out of the
+//        frontier are more than 1 / ALPHA of the edges out of the nodes not
+//        yet reached, it goes back once the frontier holds fewer than
+//        1 / BETA of the nodes and is shrinking
+//      --the frontier is always kept as a list of nodes, and bottom-up also
+//        as a bitmap, which is made from the list when the search turns
+//        bottom-up
+//      --reached nodes are kept in a bitmap of atomic words, top-down a node
+//        is claimed with fetch_or and the worker that set its bit writes its
+//        level and parent, bottom-up the nodes of a word are all looked at
+//        by one worker, node 0 and the bits past the last node start set
+//      --levels are the same whatever the threads, with more than one
+//        thread the parent of a node may be any node of the level before
+//        with an edge to it
+//      --a level of INT_MAX means the node cannot be reached, a parent of 0
+//        means there is none, as for the source
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "breadthfirst.h"
+#include <algorithm>
+
+// Frontier nodes handed to a worker at a time top-down, and bitmap words
+// bottom-up, a level of only one piece runs on the calling thread alone
+static const int TOP_DOWN_NODES = 256;
+static const int BOTTOM_UP_WORDS = 16;
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is searched
+BreadthFirst::BreadthFirst()
+    : mayGoUp(true), nodes(0), reachedNodes(0), downSteps(0), upSteps(0) {
+}
+
+//----------------------------------------------------------------------------
+// Copy constructor, operator=
+// Preconditions:   None
+// Postconditions:  Search holds the levels, parents and setting of the
+//                  parameter
+BreadthFirst::BreadthFirst(const BreadthFirst& other) : BreadthFirst() {
+    *this = other;
+}
+BreadthFirst& BreadthFirst::operator=(const BreadthFirst& other) {
+    // The bitmaps and lists are only used while solving, solve makes them
+    if(this != &other) {
+        mayGoUp = other.mayGoUp;
+        nodes = 0;
+        reached.reset();
+        levels = other.levels;
+        parents = other.parents;
+        reachedNodes = other.reachedNodes;
+        downSteps = other.downSteps;
+        upSteps = other.upSteps;
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// setBottomUp
+// Preconditions:   None
+// Postconditions:  Later calls to solve may go bottom-up if true, and only
+//                  go top-down if false, the default is true
+void BreadthFirst::setBottomUp(bool allowed) {
+    mayGoUp = allowed;
+}
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Edges in are the reverse of edges out, source is in the
+//                  graph
+// Postconditions:  Hop level and parent of every node from the source are
+//                  found, the work of each level is spread over the pool
+//                  when one is given
+void BreadthFirst::solve(const EdgeRows& out, const EdgeRows& in, int source,
+                         ThreadPool* pool) {
+    if(!reached || nodes != out.nodes) {
+        nodes = out.nodes;
+        reached.reset(new atomic<uint64_t>[words()]);
+    }
+    for(int w = 0; w < words(); w++) {
+        reached[w].store(0, memory_order_relaxed);
+    }
+
+    // Node 0 and the bits past the last node are never looked at bottom-up
+    reached[0].fetch_or(1, memory_order_relaxed);
+    for(int v = nodes + 1; v < words() * 64; v++) {
+        reached[v >> 6].fetch_or(uint64_t(1) << (v & 63),
+                                 memory_order_relaxed);
+    }
+    levels.assign(nodes + 1, INT_MAX);
+    parents.assign(nodes + 1, 0);
+    workers.resize(pool == nullptr ? 1 : pool->threadCount());
+    downSteps = 0;
+    upSteps = 0;
+
+    reached[source >> 6].fetch_or(uint64_t(1) << (source & 63),
+                                  memory_order_relaxed);
+    levels[source] = 0;
+    reachedNodes = 1;
+    frontier.assign(1, source);
+    long frontierEdges = out.degree(source);
+    long unexplored = out.edgeCount() - frontierEdges;
+    int previous = 0;               // nodes of the level before
+    bool up = false;
+    for(int depth = 0; !frontier.empty(); depth++) {
+        int count = frontier.size();
+        if(!up && mayGoUp && frontierEdges > unexplored / ALPHA) {
+            up = true;
+            inFrontier.assign(words(), 0);
+            for(int v : frontier) {
+                inFrontier[v >> 6] |= uint64_t(1) << (v & 63);
+            }
+        }
+        else if(up && count < nodes / BETA && count < previous) {
+            up = false;
+        }
+        previous = count;
+
+        if(up) {
+            frontierEdges = bottomUp(out, in, depth, pool);
+            upSteps++;
+        }
+        else {
+            frontierEdges = topDown(out, depth, pool);
+            downSteps++;
+        }
+        unexplored -= frontierEdges;
+        reachedNodes += frontier.size();
+    }
+}
+
+//----------------------------------------------------------------------------
+// reachedCount
+// Preconditions:   None
+// Postconditions:  Returns the nodes reached by the last search, the source
+//                  included
+int BreadthFirst::reachedCount() const {
+    return reachedNodes;
+}
+
+//----------------------------------------------------------------------------
+// topDownSteps, bottomUpSteps
+// Preconditions:   None
+// Postconditions:  Returns the levels of the last search found top-down,
+//                  and bottom-up
+int BreadthFirst::topDownSteps() const {
+    return downSteps;
+}
+int BreadthFirst::bottomUpSteps() const {
+    return upSteps;
+}
+
+//----------------------------------------------------------------------------
+// topDown
+// Preconditions:   Frontier list holds the nodes of the level
+// Postconditions:  Nodes of the next level are reached through the edges
+//                  out, the frontier list holds them, returns the number of
+//                  edges out of them
+long BreadthFirst::topDown(const EdgeRows& out, int depth, ThreadPool* pool) {
+    int count = frontier.size();
+    auto step = [&](int piece, int worker) {
+        Worker& mine = workers[worker];
+        int last = min(count, (piece + 1) * TOP_DOWN_NODES);
+        for(int i = piece * TOP_DOWN_NODES; i < last; i++) {
+            int v = frontier[i];
+            for(int e = out.begin(v); e < out.end(v); e++) {
+                int k = out.targets[e];
+                uint64_t bit = uint64_t(1) << (k & 63);
+                atomic<uint64_t>& word = reached[k >> 6];
+
+                // Reading first keeps reached nodes off the fetch_or
+                if((word.load(memory_order_relaxed) & bit) != 0 ||
+                   (word.fetch_or(bit, memory_order_relaxed) & bit) != 0) {
+                    continue;
+                }
+                levels[k] = depth + 1;
+                parents[k] = v;
+                mine.found.push_back(k);
+                mine.edges += out.degree(k);
+            }
+        }
+    };
+    run((count + TOP_DOWN_NODES - 1) / TOP_DOWN_NODES, step, pool);
+    return gather();
+}
+
+//----------------------------------------------------------------------------
+// bottomUp
+// Preconditions:   Frontier list and bitmap hold the nodes of the level
+// Postconditions:  Nodes of the next level are reached through the edges
+//                  in, the frontier list and bitmap hold them, returns the
+//                  number of edges out of them
+long BreadthFirst::bottomUp(const EdgeRows& out, const EdgeRows& in,
+                            int depth, ThreadPool* pool) {
+    int total = words();
+    inNext.assign(total, 0);
+    auto step = [&](int piece, int worker) {
+        Worker& mine = workers[worker];
+        int last = min(total, (piece + 1) * BOTTOM_UP_WORDS);
+        for(int w = piece * BOTTOM_UP_WORDS; w < last; w++) {
+            uint64_t left = ~reached[w].load(memory_order_relaxed);
+            uint64_t found = 0;
+            for(; left != 0; left &= left - 1) {
+                int v = w * 64 + __builtin_ctzll(left);
+                for(int e = in.begin(v); e < in.end(v); e++) {
+                    int u = in.targets[e];
+                    if((inFrontier[u >> 6] >> (u & 63)) & 1) {
+                        levels[v] = depth + 1;
+                        parents[v] = u;
+                        found |= left & -left;
+                        mine.found.push_back(v);
+                        mine.edges += out.degree(v);
+                        break;
+                    }
+                }
+            }
+
+            // Only this worker looks at the nodes of the word
+            if(found != 0) {
+                reached[w].fetch_or(found, memory_order_relaxed);
+                inNext[w] = found;
+            }
+        }
+    };
+    run((total + BOTTOM_UP_WORDS - 1) / BOTTOM_UP_WORDS, step, pool);
+    inFrontier.swap(inNext);
+    return gather();
+}
+
+//----------------------------------------------------------------------------
+// gather
+// Preconditions:   No step is running
+// Postconditions:  Frontier list holds the nodes in the workers' lists, the
+//                  lists are empty, returns the edges out of them
+long BreadthFirst::gather() {
+    long edges = 0;
+    frontier.clear();
+    for(Worker& worker : workers) {
+        frontier.insert(frontier.end(), worker.found.begin(),
+                        worker.found.end());
+        edges += worker.edges;
+        worker.found.clear();
+        worker.edges = 0;
+    }
+    return edges;
+}
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index up to the
+//                  count, spread over the pool when one is given
+void BreadthFirst::run(int count, const function<void(int, int)>& task,
+                       ThreadPool* pool) {
+    if(pool == nullptr || count < 2) {
+        for(int i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    pool->parallelFor(0, count, 1, task);
+}
+
+//----------------------------------------------------------------------------
+// words
+// Preconditions:   None
+// Postconditions:  Returns the number of 64 bit words of a node bitmap
+int BreadthFirst::words() const {
+    return nodes / 64 + 1;
+}
@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+// BREADTHFIRST.H
+// Class for a direction-optimizing parallel breadth-first search
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// BreadthFirst: hop level and parent of every node reached from a source
+// and allows other features:
+//      --running one search on several threads through a ThreadPool
+//      --counts of the steps run top-down and bottom-up by the last search
+//      --keeping to top-down, to measure what going bottom-up saves
+//
+// Implementation and assumptions:
+//      --the search goes one level at a time, each level is found either
+//        top-down, following the edges out of every node of the frontier,
+//        or bottom-up, where every node not yet reached looks through its
+//        edges in for one from the frontier and stops at the first (Beamer,
+//        Asanovic and Patterson)
+//      --it starts top-down and goes bottom-up once the edges out of the
+//        frontier are more than 1 / ALPHA of the edges out of the nodes not
+//        yet reached, it goes back once the frontier holds fewer than
+//        1 / BETA of the nodes and is shrinking
+//      --the frontier is always kept as a list of nodes, and bottom-up also
+//        as a bitmap, which is made from the list when the search turns
+//        bottom-up
+//      --reached nodes are kept in a bitmap of atomic words, top-down a node
+//        is claimed with fetch_or and the worker that set its bit writes its
+//        level and parent, bottom-up the nodes of a word are all looked at
+//        by one worker, node 0 and the bits past the last node start set
+//      --levels are the same whatever the threads, with more than one
+//        thread the parent of a node may be any node of the level before
+//        with an edge to it
+//      --a level of INT_MAX means the node cannot be reached, a parent of 0
+//        means there is none, as for the source
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef BREADTHFIRST_H
+#define BREADTHFIRST_H
+
+#include "edgerows.h"
+#include "threadpool.h"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class BreadthFirst {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is searched
+    BreadthFirst();
+
+//----------------------------------------------------------------------------
+// Copy constructor, operator=
+// Preconditions:   None
+// Postconditions:  Search holds the levels, parents and setting of the
+//                  parameter
+    BreadthFirst(const BreadthFirst&);
+    BreadthFirst& operator=(const BreadthFirst&);
+
+//----------------------------------------------------------------------------
+// setBottomUp
+// Preconditions:   None
+// Postconditions:  Later calls to solve may go bottom-up if true, and only
+//                  go top-down if false, the default is true
+    void setBottomUp(bool);
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Edges in are the reverse of edges out, source is in the
+//                  graph
+// Postconditions:  Hop level and parent of every node from the source are
+//                  found, the work of each level is spread over the pool
+//                  when one is given
+    void solve(const EdgeRows&, const EdgeRows&, int, ThreadPool* = nullptr);
+
+//----------------------------------------------------------------------------
+// level, parent
+// Preconditions:   solve has been called, node is in range
+// Postconditions:  Returns the number of edges on a shortest path from the
+//                  source to the node, INT_MAX if there is none, and the
+//                  node before it on such a path, 0 if there is none
+    int level(int v) const { return levels[v]; }
+    int parent(int v) const { return parents[v]; }
+
+//----------------------------------------------------------------------------
+// reachedCount
+// Preconditions:   None
+// Postconditions:  Returns the nodes reached by the last search, the source
+//                  included
+    int reachedCount() const;
+
+//----------------------------------------------------------------------------
+// topDownSteps, bottomUpSteps
+// Preconditions:   None
+// Postconditions:  Returns the levels of the last search found top-down,
+//                  and bottom-up
+    int topDownSteps() const;
+    int bottomUpSteps() const;
+
+private:
+    static const int ALPHA = 14;    // frontier edges to go bottom-up
+    static const int BETA = 24;     // frontier nodes to go top-down
+
+    struct alignas(64) Worker {
+        vector<int> found;          // nodes it reached this level
+        long edges = 0;             // edges out of the nodes it reached
+    };
+
+    bool mayGoUp;                       // bottom-up steps are allowed
+    int nodes;                          // number of nodes of the graph
+    vector<int> levels;                 // hops from the source
+    vector<int> parents;                // node before on a shortest path
+    unique_ptr<atomic<uint64_t>[]> reached;  // nodes reached, 64 per word
+    vector<uint64_t> inFrontier;        // frontier as a bitmap, bottom-up
+    vector<uint64_t> inNext;            // next frontier as a bitmap
+    vector<int> frontier;               // frontier as a list
+    vector<Worker> workers;             // per-worker lists
+    int reachedNodes;                   // nodes reached so far
+    int downSteps;                      // levels found top-down
+    int upSteps;                        // levels found bottom-up
+
+//----------------------------------------------------------------------------
+// topDown
+// Preconditions:   Frontier list holds the nodes of the level
+// Postconditions:  Nodes of the next level are reached through the edges
+//                  out, the frontier list holds them, returns the number of
+//                  edges out of them
+    long topDown(const EdgeRows&, int, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// bottomUp
+// Preconditions:   Frontier list and bitmap hold the nodes of the level
+// Postconditions:  Nodes of the next level are reached through the edges
+//                  in, the frontier list and bitmap hold them, returns the
+//                  number of edges out of them
+    long bottomUp(const EdgeRows&, const EdgeRows&, int, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// gather
+// Preconditions:   No step is running
+// Postconditions:  Frontier list holds the nodes in the workers' lists, the
+//                  lists are empty, returns the edges out of them
+    long gather();
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index up to the
+//                  count, spread over the pool when one is given
+    void run(int, const function<void(int, int)>&, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// words
+// Preconditions:   None
+// Postconditions:  Returns the number of 64 bit words of a node bitmap
+    int words() const;
+};
+
+#endif
@@ -0,0 +1,593 @@
+//----------------------------------------------------------------------------
+// COMPONENTS.CPP
+// Implementation for Components Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// Components: the component of every node, the nodes of each component all
+// reach one another, and the graph of the components
+// and allows other features:
+//      --finding the components with Tarjan's algorithm on one thread, or
+//        with forward-backward search and coloring spread over a ThreadPool
+//      --the condensation, a graph with a node per component and an edge
+//        where an edge of the graph joins 2 components, held in the same
+//        compressed sparse rows as a GraphL's edges
+//      --asking whether one node can reach another through the condensation
+//
+// Implementation and assumptions:
+//      --Tarjan's algorithm keeps an explicit stack of (node, next edge)
+//        frames instead of recursing, so deep graphs cannot overflow the
+//        call stack
+//      --the parallel method first trims nodes with no edges in or no
+//        edges out among the nodes left, each is a component of its own,
+//        then takes the component of the node with the most edges in times
+//        edges out by searching forward and backward from it (the component
+//        is what both searches reach), which on large graphs is usually the
+//        one giant component, trims again, then colors the rest
+//      --coloring gives every node left its own id as its color and passes
+//        the larger color along every edge until nothing changes, a node
+//        whose color is its own id is then the root of a component, which
+//        is what it reaches backward among the nodes of its color, the
+//        roots are searched at once on the workers and the rounds repeat
+//        until every node has a component
+//      --components are numbered 1 to the count in an order where every
+//        edge of the condensation goes from a lower number to a higher one,
+//        which order depends on the method
+//      --the condensation has no loops and no edge twice, its edges are in
+//        increasing order of the component they go to
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "components.h"
+#include <algorithm>
+
+// Graphs with fewer nodes than this are solved with TARJAN by AUTO, the
+// parallel method costs more than it saves on them
+static const int PARALLEL_NODES = 1 << 17;
+
+// Nodes handed to a worker at a time, a step of only one piece runs on the
+// calling thread alone
+static const int PIECE_NODES = 256;
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No graph has been solved, the method is AUTO
+Components::Components()
+    : chosen(AUTO), nodes(0), count(0), dagOffsets(2, 0), nextId(0) {
+}
+
+//----------------------------------------------------------------------------
+// setMethod
+// Preconditions:   None
+// Postconditions:  Later calls to solve use the given method, the default is
+//                  AUTO
+void Components::setMethod(Method method) {
+    chosen = method;
+}
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Edges in are the reverse of edges out
+// Postconditions:  Component of every node and the condensation are found,
+//                  FORWARD_BACKWARD spreads its work over the pool when one
+//                  is given
+void Components::solve(const EdgeRows& out, const EdgeRows& in,
+                       ThreadPool* pool) {
+    nodes = out.nodes;
+    Method method = chosen;
+    if(method == AUTO) {
+        method = pool != nullptr && nodes >= PARALLEL_NODES
+                 ? FORWARD_BACKWARD : TARJAN;
+    }
+    if(method == TARJAN) {
+        tarjan(out);
+    }
+    else {
+        forwardBackward(out, in, pool);
+    }
+    condense(out);
+}
+
+//----------------------------------------------------------------------------
+// nodeCount, componentCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes of the graph, and of
+//                  components, found by the last solve
+int Components::nodeCount() const {
+    return nodes;
+}
+int Components::componentCount() const {
+    return count;
+}
+
+//----------------------------------------------------------------------------
+// componentSize
+// Preconditions:   Component is in the range 1 to the count
+// Postconditions:  Returns the number of nodes in the component
+int Components::componentSize(int c) const {
+    return sizes[c];
+}
+
+//----------------------------------------------------------------------------
+// condensation
+// Preconditions:   None
+// Postconditions:  Returns the edges between components, valid until the
+//                  next solve
+EdgeRows Components::condensation() const {
+    EdgeRows dag = { count, dagOffsets.data(), dagTargets.data() };
+    return dag;
+}
+
+//----------------------------------------------------------------------------
+// reaches
+// Preconditions:   solve has been called, nodes are in range
+// Postconditions:  Returns true if there is a path from the first node to
+//                  the second, found by a search of the condensation
+bool Components::reaches(int from, int to) {
+    int start = ids[from], goal = ids[to];
+    if(start == goal) {
+        return true;
+    }
+
+    // Edges only go to higher numbers, so nothing past the goal can lead
+    // back to it, and each row is in increasing order
+    bool found = false;
+    pending.assign(1, start);
+    touched.assign(1, start);
+    seen.set(start);
+    while(!pending.empty() && !found) {
+        int c = pending.back();
+        pending.pop_back();
+        for(int e = dagOffsets[c]; e < dagOffsets[c + 1]; e++) {
+            int next = dagTargets[e];
+            if(next >= goal) {
+                found = next == goal;
+                break;
+            }
+            if(!seen.test(next)) {
+                seen.set(next);
+                touched.push_back(next);
+                pending.push_back(next);
+            }
+        }
+    }
+    for(int c : touched) {
+        seen.reset(c);
+    }
+    return found;
+}
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the component numbers and the
+//                  condensation
+size_t Components::memoryBytes() const {
+    return (ids.capacity() + sizes.capacity() + dagOffsets.capacity() +
+            dagTargets.capacity()) * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// tarjan
+// Preconditions:   None
+// Postconditions:  Each node's component is in ids, numbered in the order
+//                  the components were finished
+void Components::tarjan(const EdgeRows& out) {
+    // index is the order a node was found in, low the lowest index it
+    // reaches among the nodes still on the stack, 0 once it has left it
+    vector<int> index(nodes + 1, 0);
+    vector<int> low(nodes + 1, 0);
+    vector<int> stack;
+    vector<SearchFrame> frames;
+    ids.assign(nodes + 1, 0);
+    count = 0;
+    int found = 0;
+
+    for(int s = 1; s <= nodes; s++) {
+        if(index[s] != 0) {
+            continue;
+        }
+        index[s] = low[s] = ++found;
+        stack.push_back(s);
+        frames.push_back(SearchFrame{s, out.begin(s)});
+        while(!frames.empty()) {
+            SearchFrame& top = frames.back();
+            int v = top.node;
+            if(top.next < out.end(v)) {
+                int w = out.targets[top.next++];
+                if(index[w] == 0) {
+                    index[w] = low[w] = ++found;
+                    stack.push_back(w);
+                    frames.push_back(SearchFrame{w, out.begin(w)});
+                }
+                else if(ids[w] == 0) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            // Every edge of v is done, as the recursive call would return
+            frames.pop_back();
+            if(!frames.empty()) {
+                int u = frames.back().node;
+                low[u] = min(low[u], low[v]);
+            }
+            if(low[v] == index[v]) {
+                count++;
+                int w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    ids[w] = count;
+                } while(w != v);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// forwardBackward
+// Preconditions:   Edges in are the reverse of edges out
+// Postconditions:  Each node's component is in ids, numbered in the order
+//                  they were found
+void Components::forwardBackward(const EdgeRows& out, const EdgeRows& in,
+                                 ThreadPool* pool) {
+    int words = nodes / 64 + 1;
+    owner.reset(new atomic<int>[nodes + 1]);
+    color.reset(new atomic<int>[nodes + 1]);
+    ahead.reset(new atomic<uint64_t>[words]);
+    behind.reset(new atomic<uint64_t>[words]);
+    workers.resize(pool == nullptr ? 1 : pool->threadCount());
+    nextId.store(0, memory_order_relaxed);
+    owner[0].store(-1, memory_order_relaxed);
+    active.clear();
+    for(int v = 1; v <= nodes; v++) {
+        owner[v].store(0, memory_order_relaxed);
+        color[v].store(0, memory_order_relaxed);
+        active.push_back(v);
+    }
+    trim(out, in, pool);
+
+    // The component of the node with the most edges through it, searched
+    // forward and backward with every node left the same color
+    int pivot = 0;
+    long best = -1;
+    for(int v : active) {
+        long through = (long)out.degree(v) * in.degree(v);
+        if(through > best) {
+            best = through;
+            pivot = v;
+        }
+    }
+    if(pivot != 0) {
+        for(int w = 0; w < words; w++) {
+            ahead[w].store(0, memory_order_relaxed);
+            behind[w].store(0, memory_order_relaxed);
+        }
+        uint64_t bit = uint64_t(1) << (pivot & 63);
+        ahead[pivot >> 6].fetch_or(bit, memory_order_relaxed);
+        behind[pivot >> 6].fetch_or(bit, memory_order_relaxed);
+        vector<int> start(1, pivot);
+        reach(out, start, ahead.get(), pool);
+        start.assign(1, pivot);
+        reach(in, start, behind.get(), pool);
+
+        int id = ++nextId;
+        int total = active.size();
+        run((total + PIECE_NODES - 1) / PIECE_NODES, [&](int piece, int) {
+            int last = min(total, (piece + 1) * PIECE_NODES);
+            for(int i = piece * PIECE_NODES; i < last; i++) {
+                int v = active[i];
+                uint64_t both = ahead[v >> 6].load(memory_order_relaxed) &
+                                behind[v >> 6].load(memory_order_relaxed);
+                if((both >> (v & 63)) & 1) {
+                    owner[v].store(id, memory_order_relaxed);
+                }
+            }
+        }, pool);
+        compact();
+        trim(out, in, pool);
+    }
+
+    // Coloring rounds, each finds at least the component of the largest
+    // node left
+    while(!active.empty()) {
+        int total = active.size();
+        int pieces = (total + PIECE_NODES - 1) / PIECE_NODES;
+        run(pieces, [&](int piece, int) {
+            int last = min(total, (piece + 1) * PIECE_NODES);
+            for(int i = piece * PIECE_NODES; i < last; i++) {
+                color[active[i]].store(active[i], memory_order_relaxed);
+            }
+        }, pool);
+
+        // A color only ever goes up, so the passes settle
+        atomic<bool> changed(true);
+        while(changed.load(memory_order_relaxed)) {
+            changed.store(false, memory_order_relaxed);
+            run(pieces, [&](int piece, int) {
+                int last = min(total, (piece + 1) * PIECE_NODES);
+                for(int i = piece * PIECE_NODES; i < last; i++) {
+                    int v = active[i];
+                    int c = color[v].load(memory_order_relaxed);
+                    for(int e = out.begin(v); e < out.end(v); e++) {
+                        int w = out.targets[e];
+                        if(owner[w].load(memory_order_relaxed) != 0) {
+                            continue;
+                        }
+                        int was = color[w].load(memory_order_relaxed);
+                        while(c > was) {
+                            if(color[w].compare_exchange_weak(was, c,
+                                    memory_order_relaxed)) {
+                                changed.store(true, memory_order_relaxed);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }, pool);
+        }
+
+        // Roots take a component each and mark what they reach backward
+        vector<int> roots;
+        for(int v : active) {
+            if(color[v].load(memory_order_relaxed) == v) {
+                roots.push_back(v);
+            }
+        }
+        for(int w = 0; w < words; w++) {
+            behind[w].store(0, memory_order_relaxed);
+        }
+        for(int r : roots) {
+            behind[r >> 6].fetch_or(uint64_t(1) << (r & 63),
+                                    memory_order_relaxed);
+        }
+        vector<int> list(roots);
+        reach(in, list, behind.get(), pool);
+        for(int r : roots) {
+            owner[r].store(++nextId, memory_order_relaxed);
+        }
+        run(pieces, [&](int piece, int) {
+            int last = min(total, (piece + 1) * PIECE_NODES);
+            for(int i = piece * PIECE_NODES; i < last; i++) {
+                int v = active[i];
+                int c = color[v].load(memory_order_relaxed);
+                if(c != v && ((behind[v >> 6].load(memory_order_relaxed)
+                               >> (v & 63)) & 1)) {
+                    owner[v].store(owner[c].load(memory_order_relaxed),
+                                   memory_order_relaxed);
+                }
+            }
+        }, pool);
+        compact();
+    }
+
+    count = nextId.load(memory_order_relaxed);
+    ids.resize(nodes + 1);
+    ids[0] = 0;
+    for(int v = 1; v <= nodes; v++) {
+        ids[v] = owner[v].load(memory_order_relaxed);
+    }
+    owner.reset();
+    color.reset();
+    ahead.reset();
+    behind.reset();
+}
+
+//----------------------------------------------------------------------------
+// trim
+// Preconditions:   Active list holds the nodes without a component
+// Postconditions:  Nodes with no edges out or no edges in among the active
+//                  nodes are each given a component, until none is left,
+//                  active list holds the rest
+void Components::trim(const EdgeRows& out, const EdgeRows& in,
+                      ThreadPool* pool) {
+    // A node with no other active node on one side cannot be on a cycle
+    auto alone = [&](const EdgeRows& rows, int v) {
+        for(int e = rows.begin(v); e < rows.end(v); e++) {
+            int w = rows.targets[e];
+            if(w != v && owner[w].load(memory_order_relaxed) == 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // After the first pass only the neighbours of trimmed nodes can change
+    vector<int> check(active);
+    while(!check.empty()) {
+        int total = check.size();
+        run((total + PIECE_NODES - 1) / PIECE_NODES, [&](int piece,
+                                                        int worker) {
+            int last = min(total, (piece + 1) * PIECE_NODES);
+            for(int i = piece * PIECE_NODES; i < last; i++) {
+                int v = check[i];
+                if(owner[v].load(memory_order_relaxed) == 0 &&
+                   (alone(out, v) || alone(in, v)) && claim(v)) {
+                    workers[worker].found.push_back(v);
+                }
+            }
+        }, pool);
+        vector<int> trimmed;
+        gather(trimmed);
+        check.clear();
+        for(int v : trimmed) {
+            for(int e = out.begin(v); e < out.end(v); e++) {
+                check.push_back(out.targets[e]);
+            }
+            for(int e = in.begin(v); e < in.end(v); e++) {
+                check.push_back(in.targets[e]);
+            }
+        }
+    }
+    compact();
+}
+
+//----------------------------------------------------------------------------
+// reach
+// Preconditions:   Nodes of the list are marked
+// Postconditions:  Every node without a component reached from the list
+//                  along edges between nodes of the same color is marked,
+//                  the list is left empty
+void Components::reach(const EdgeRows& rows, vector<int>& list,
+                       atomic<uint64_t>* marks, ThreadPool* pool) {
+    while(!list.empty()) {
+        int total = list.size();
+        run((total + PIECE_NODES - 1) / PIECE_NODES, [&](int piece,
+                                                        int worker) {
+            int last = min(total, (piece + 1) * PIECE_NODES);
+            for(int i = piece * PIECE_NODES; i < last; i++) {
+                int v = list[i];
+                int c = color[v].load(memory_order_relaxed);
+                for(int e = rows.begin(v); e < rows.end(v); e++) {
+                    int w = rows.targets[e];
+                    uint64_t bit = uint64_t(1) << (w & 63);
+                    atomic<uint64_t>& word = marks[w >> 6];
+                    if(owner[w].load(memory_order_relaxed) != 0 ||
+                       color[w].load(memory_order_relaxed) != c ||
+                       (word.load(memory_order_relaxed) & bit) != 0 ||
+                       (word.fetch_or(bit, memory_order_relaxed) & bit) != 0) {
+                        continue;
+                    }
+                    workers[worker].found.push_back(w);
+                }
+            }
+        }, pool);
+        gather(list);
+    }
+}
+
+//----------------------------------------------------------------------------
+// claim
+// Preconditions:   None
+// Postconditions:  Returns true and gives the node a component of its own
+//                  if it had none, returns false otherwise
+bool Components::claim(int v) {
+    int none = 0;
+    if(!owner[v].compare_exchange_strong(none, -1, memory_order_relaxed)) {
+        return false;
+    }
+    owner[v].store(++nextId, memory_order_relaxed);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// gather
+// Preconditions:   No step is running
+// Postconditions:  List holds the nodes in the workers' lists, the lists
+//                  are empty
+void Components::gather(vector<int>& list) {
+    list.clear();
+    for(Worker& worker : workers) {
+        list.insert(list.end(), worker.found.begin(), worker.found.end());
+        worker.found.clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+// compact
+// Preconditions:   No step is running
+// Postconditions:  Active list holds only the nodes still without a
+//                  component
+void Components::compact() {
+    size_t kept = 0;
+    for(int v : active) {
+        if(owner[v].load(memory_order_relaxed) == 0) {
+            active[kept++] = v;
+        }
+    }
+    active.resize(kept);
+}
+
+//----------------------------------------------------------------------------
+// condense
+// Preconditions:   ids holds a component between 1 and the count for every
+//                  node
+// Postconditions:  Components are renumbered in topological order, sizes
+//                  and the condensation are made
+void Components::condense(const EdgeRows& out) {
+    // Edges between components by the old numbers, counted then placed
+    vector<int> starts(count + 2, 0);
+    for(int v = 1; v <= nodes; v++) {
+        for(int e = out.begin(v); e < out.end(v); e++) {
+            starts[ids[v]] += ids[out.targets[e]] != ids[v];
+        }
+    }
+    for(int c = 1; c <= count + 1; c++) {
+        starts[c] += starts[c - 1];
+    }
+    vector<int> across(starts[count + 1]);
+    for(int v = 1; v <= nodes; v++) {
+        for(int e = out.begin(v); e < out.end(v); e++) {
+            int to = ids[out.targets[e]];
+            if(to != ids[v]) {
+                across[--starts[ids[v]]] = to;
+            }
+        }
+    }
+
+    // Kahn's algorithm, a component is numbered once all before it are
+    vector<int> waiting(count + 1, 0);
+    for(int to : across) {
+        waiting[to]++;
+    }
+    vector<int> order;
+    order.reserve(count);
+    for(int c = 1; c <= count; c++) {
+        if(waiting[c] == 0) {
+            order.push_back(c);
+        }
+    }
+    for(size_t k = 0; k < order.size(); k++) {
+        int c = order[k];
+        for(int e = starts[c]; e < starts[c + 1]; e++) {
+            if(--waiting[across[e]] == 0) {
+                order.push_back(across[e]);
+            }
+        }
+    }
+    vector<int> number(count + 1, 0);
+    for(int k = 0; k < count; k++) {
+        number[order[k]] = k + 1;
+    }
+
+    sizes.assign(count + 1, 0);
+    for(int v = 1; v <= nodes; v++) {
+        ids[v] = number[ids[v]];
+        sizes[ids[v]]++;
+    }
+
+    // Rows in the new numbers, each sorted with repeats dropped
+    dagOffsets.assign(count + 2, 0);
+    dagTargets.clear();
+    vector<int> row;
+    for(int k = 0; k < count; k++) {
+        int c = order[k];
+        row.clear();
+        for(int e = starts[c]; e < starts[c + 1]; e++) {
+            row.push_back(number[across[e]]);
+        }
+        sort(row.begin(), row.end());
+        row.erase(unique(row.begin(), row.end()), row.end());
+        dagOffsets[k + 1] = dagTargets.size();
+        dagTargets.insert(dagTargets.end(), row.begin(), row.end());
+    }
+    dagOffsets[count + 1] = dagTargets.size();
+    seen.resize(count);
+}
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index up to the
+//                  count, spread over the pool when one is given
+void Components::run(int count, const function<void(int, int)>& task,
+                     ThreadPool* pool) {
+    if(pool == nullptr || count < 2) {
+        for(int i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    pool->parallelFor(0, count, 1, task);
+}
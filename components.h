@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+// COMPONENTS.H
+// Class for the strongly connected components of a directed graph
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// Components: the component of every node, the nodes of each component all
+// reach one another, and the graph of the components
+// and allows other features:
+//      --finding the components with Tarjan's algorithm on one thread, or
+//        with forward-backward search and coloring spread over a ThreadPool
+//      --the condensation, a graph with a node per component and an edge
+//        where an edge of the graph joins 2 components, held in the same
+//        compressed sparse rows as a GraphL's edges
+//      --asking whether one node can reach another through the condensation
+//
+// Implementation and assumptions:
+//      --Tarjan's algorithm keeps an explicit stack of (node, next edge)
+//        frames instead of recursing, so deep graphs cannot overflow the
+//        call stack
+//      --the parallel method first trims nodes with no edges in or no
+//        edges out among the nodes left, each is a component of its own,
+//        then takes the component of the node with the most edges in times
+//        edges out by searching forward and backward from it (the component
+//        is what both searches reach), which on large graphs is usually the
+//        one giant component, trims again, then colors the rest
+//      --coloring gives every node left its own id as its color and passes
+//        the larger color along every edge until nothing changes, a node
+//        whose color is its own id is then the root of a component, which
+//        is what it reaches backward among the nodes of its color, the
+//        roots are searched at once on the workers and the rounds repeat
+//        until every node has a component
+//      --components are numbered 1 to the count in an order where every
+//        edge of the condensation goes from a lower number to a higher one,
+//        which order depends on the method
+//      --the condensation has no loops and no edge twice, its edges are in
+//        increasing order of the component they go to
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "edgerows.h"
+#include "threadpool.h"
+#include "bitarray.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class Components {
+public:
+    enum Method {
+        AUTO,               // TARJAN without a pool or on small graphs
+        TARJAN,             // Tarjan's algorithm on the calling thread
+        FORWARD_BACKWARD    // trimming, forward-backward and coloring
+    };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No graph has been solved, the method is AUTO
+    Components();
+
+    Components(const Components&) = delete;
+    Components& operator=(const Components&) = delete;
+
+//----------------------------------------------------------------------------
+// setMethod
+// Preconditions:   None
+// Postconditions:  Later calls to solve use the given method, the default is
+//                  AUTO
+    void setMethod(Method);
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Edges in are the reverse of edges out
+// Postconditions:  Component of every node and the condensation are found,
+//                  FORWARD_BACKWARD spreads its work over the pool when one
+//                  is given
+    void solve(const EdgeRows&, const EdgeRows&, ThreadPool* = nullptr);
+
+//----------------------------------------------------------------------------
+// nodeCount, componentCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes of the graph, and of
+//                  components, found by the last solve
+    int nodeCount() const;
+    int componentCount() const;
+
+//----------------------------------------------------------------------------
+// component
+// Preconditions:   solve has been called, node is in range
+// Postconditions:  Returns the number of the node's component
+    int component(int v) const { return ids[v]; }
+
+//----------------------------------------------------------------------------
+// componentSize
+// Preconditions:   Component is in the range 1 to the count
+// Postconditions:  Returns the number of nodes in the component
+    int componentSize(int) const;
+
+//----------------------------------------------------------------------------
+// condensation
+// Preconditions:   None
+// Postconditions:  Returns the edges between components, valid until the
+//                  next solve
+    EdgeRows condensation() const;
+
+//----------------------------------------------------------------------------
+// reaches
+// Preconditions:   solve has been called, nodes are in range
+// Postconditions:  Returns true if there is a path from the first node to
+//                  the second, found by a search of the condensation
+    bool reaches(int, int);
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the component numbers and the
+//                  condensation
+    size_t memoryBytes() const;
+
+private:
+    // Node whose edges Tarjan's algorithm is part way through
+    struct SearchFrame {
+        int node;                   // node being searched
+        int next;                   // first edge not yet followed
+    };
+
+    struct alignas(64) Worker {
+        vector<int> found;          // nodes it found this step
+    };
+
+    Method chosen;                  // method asked for
+    int nodes;                      // number of nodes of the graph
+    int count;                      // number of components
+    vector<int> ids;                // component of each node
+    vector<int> sizes;              // nodes of each component
+    vector<int> dagOffsets;         // where each component's edges begin
+    vector<int> dagTargets;         // component each edge goes to
+    unique_ptr<atomic<int>[]> owner;    // component while solving, 0 if none
+    unique_ptr<atomic<int>[]> color;    // color of each node while coloring
+    unique_ptr<atomic<uint64_t>[]> ahead;   // nodes reached forward
+    unique_ptr<atomic<uint64_t>[]> behind;  // nodes reached backward
+    atomic<int> nextId;             // last component number given out
+    vector<int> active;             // nodes without a component
+    vector<Worker> workers;         // per-worker lists
+    BitArray seen;                  // components found by reaches
+    vector<int> pending;            // components reaches has still to search
+    vector<int> touched;            // components reaches has marked
+
+//----------------------------------------------------------------------------
+// tarjan
+// Preconditions:   None
+// Postconditions:  Each node's component is in ids, numbered in the order
+//                  the components were finished
+    void tarjan(const EdgeRows&);
+
+//----------------------------------------------------------------------------
+// forwardBackward
+// Preconditions:   Edges in are the reverse of edges out
+// Postconditions:  Each node's component is in ids, numbered in the order
+//                  they were found
+    void forwardBackward(const EdgeRows&, const EdgeRows&, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// trim
+// Preconditions:   Active list holds the nodes without a component
+// Postconditions:  Nodes with no edges out or no edges in among the active
+//                  nodes are each given a component, until none is left,
+//                  active list holds the rest
+    void trim(const EdgeRows&, const EdgeRows&, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// reach
+// Preconditions:   Nodes of the list are marked
+// Postconditions:  Every node without a component reached from the list
+//                  along edges between nodes of the same color is marked,
+//                  the list is left empty
+    void reach(const EdgeRows&, vector<int>&, atomic<uint64_t>*, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// claim
+// Preconditions:   None
+// Postconditions:  Returns true and gives the node a component of its own
+//                  if it had none, returns false otherwise
+    bool claim(int);
+
+//----------------------------------------------------------------------------
+// gather
+// Preconditions:   No step is running
+// Postconditions:  List holds the nodes in the workers' lists, the lists
+//                  are empty
+    void gather(vector<int>&);
+
+//----------------------------------------------------------------------------
+// compact
+// Preconditions:   No step is running
+// Postconditions:  Active list holds only the nodes still without a
+//                  component
+    void compact();
+
+//----------------------------------------------------------------------------
+// condense
+// Preconditions:   ids holds a component between 1 and the count for every
+//                  node
+// Postconditions:  Components are renumbered in topological order, sizes
+//                  and the condensation are made
+    void condense(const EdgeRows&);
+
+//----------------------------------------------------------------------------
+// run
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index up to the
+//                  count, spread over the pool when one is given
+    void run(int, const function<void(int, int)>&, ThreadPool*);
+};
+
+#endif
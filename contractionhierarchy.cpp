@@ -0,0 +1,531 @@
+//----------------------------------------------------------------------------
+// CONTRACTIONHIERARCHY.CPP
+// Implementation for ContractionHierarchy Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ContractionHierarchy: shortest paths between 2 nodes of a static graph
+// and allows other features:
+//      --building the index from a CSRGraph, on several threads through a
+//        ThreadPool
+//      --finding the shortest distance and path between 2 nodes with a
+//        search that settles a few hundred nodes even on large road graphs
+//      --counts of shortcuts, bytes used and nodes settled by a query
+//
+// Implementation and assumptions:
+//      --nodes are contracted one after another, contracting a node removes
+//        it and adds a shortcut edge u -> w for each pair of its neighbours
+//        whose only shortest path went through it, a limited Dijkstra search
+//        (a witness search) checks for another path first
+//      --the next nodes to contract are the ones with the lowest priority,
+//        twice the edge difference (shortcuts added less edges removed) plus
+//        the neighbours already contracted and the depth of contracted nodes
+//        below it, so the graph is worked on evenly, priorities come from
+//        shorter witness searches than the ones of the contraction itself
+//      --each round contracts every node whose priority is lower than all of
+//        its neighbours', no 2 such nodes are neighbours so their witness
+//        searches and shortcuts are found in parallel, witness searches do
+//        not pass through nodes of the same round, the priorities of the
+//        neighbours are then found again, also in parallel
+//      --a node's rank is the round order it was contracted in, a query
+//        searches forward from the origin only over edges to higher ranks,
+//        backward from the destination the same way, and meets at the
+//        highest ranked node of the path
+//      --every shortcut remembers the 2 edges it replaced, so a path found
+//        is unpacked back to the original edges
+//      --on paths of equal length the path found may differ from the one
+//        Dijkstra's algorithm picks
+//      --the index only holds for the edges it was built from
+//      --edge lengths are assumed to be 0 or more, node ids are in the range
+//        1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "contractionhierarchy.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No index is held
+ContractionHierarchy::ContractionHierarchy() {
+    clear();
+}
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Graph is merged
+// Postconditions:  Index is built for the graph, the work of each round is
+//                  spread over the pool when one is given
+void ContractionHierarchy::build(const CSRGraph& g, ThreadPool* pool) {
+    clear();
+    nodes = g.nodeCount();
+
+    // Working graph starts as the original edges, self loops are never used
+    out.assign(nodes + 1, vector<Link>());
+    in.assign(nodes + 1, vector<Link>());
+    state.assign(nodes + 1, 0);
+    rank.assign(nodes + 1, 0);
+    contractedNear.assign(nodes + 1, 0);
+    depth.assign(nodes + 1, 0);
+    for(int v = 1; v <= nodes; v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            int k = g.target(e);
+            if(k == v) {
+                continue;
+            }
+            int id = arcs.size();
+            arcs.push_back(Arc{v, k, g.weight(e), -1, -1});
+            out[v].push_back(Link{k, id});
+            in[k].push_back(Link{v, id});
+        }
+    }
+
+    int threads = pool == nullptr ? 1 : pool->threadCount();
+    witness.resize(threads);
+    for(Witness& space : witness) {
+        space.dist.assign(nodes + 1, INT_MAX);
+        space.target.assign(nodes + 1, 0);
+        space.stamp = 0;
+        space.heap.reset(nodes);
+    }
+
+    // Runs step(index, worker) for every index below count
+    auto each = [pool, threads](int count,
+                                const function<void(int, int)>& step) {
+        if(pool == nullptr) {
+            for(int t = 0; t < count; t++) {
+                step(t, 0);
+            }
+            return;
+        }
+        int grain = count / (threads * 8);
+        pool->parallelFor(0, count, grain < 1 ? 1 : grain, step);
+    };
+
+    vector<int> prio(nodes + 1, 0);
+    vector<vector<int>> up(nodes + 1);
+    vector<vector<int>> down(nodes + 1);
+    vector<int> live;
+    for(int v = 1; v <= nodes; v++) {
+        live.push_back(v);
+    }
+    vector<int> stale = live;           // nodes whose priority is out of date
+    vector<char> marked(nodes + 1, 0);
+    int next = 0;
+
+    while(!live.empty()) {
+        roundCount++;
+        each(stale.size(), [&](int t, int worker) {
+            prio[stale[t]] = priority(stale[t], witness[worker]);
+        });
+
+        // Nodes lower than all their neighbours are never neighbours
+        auto lower = [&prio](int a, int b) {
+            return prio[a] < prio[b] || (prio[a] == prio[b] && a < b);
+        };
+        vector<int> round;
+        for(int v : live) {
+            bool lowest = true;
+            for(const Link& link : out[v]) {
+                lowest = lowest && lower(v, link.node);
+            }
+            for(const Link& link : in[v]) {
+                lowest = lowest && lower(v, link.node);
+            }
+            if(lowest) {
+                round.push_back(v);
+                state[v] = 2;
+            }
+        }
+
+        vector<vector<Shortcut>> found(round.size());
+        each(round.size(), [&](int t, int worker) {
+            findShortcuts(round[t], witness[worker], MAX_SETTLED);
+            found[t] = witness[worker].found;
+        });
+
+        // Neighbours of the round get new priorities next round
+        stale.clear();
+        for(size_t t = 0; t < round.size(); t++) {
+            int v = round[t];
+            for(const Link& link : out[v]) {
+                if(!marked[link.node]) {
+                    marked[link.node] = 1;
+                    stale.push_back(link.node);
+                }
+            }
+            for(const Link& link : in[v]) {
+                if(!marked[link.node]) {
+                    marked[link.node] = 1;
+                    stale.push_back(link.node);
+                }
+            }
+            rank[v] = next++;
+            contract(v, found[t], up, down);
+        }
+        for(int v : stale) {
+            marked[v] = 0;
+        }
+
+        size_t kept = 0;
+        for(int v : live) {
+            if(state[v] == 0) {
+                live[kept++] = v;
+            }
+        }
+        live.resize(kept);
+    }
+
+    // Flatten the up and down arcs of each node into compressed rows
+    upOffsets.assign(nodes + 2, 0);
+    downOffsets.assign(nodes + 2, 0);
+    for(int v = 1; v <= nodes; v++) {
+        upOffsets[v + 1] = upOffsets[v] + up[v].size();
+        downOffsets[v + 1] = downOffsets[v] + down[v].size();
+        upArcs.insert(upArcs.end(), up[v].begin(), up[v].end());
+        downArcs.insert(downArcs.end(), down[v].begin(), down[v].end());
+    }
+
+    // Working graph is not needed by queries
+    vector<vector<Link>>().swap(out);
+    vector<vector<Link>>().swap(in);
+    vector<char>().swap(state);
+    vector<int>().swap(contractedNear);
+    vector<int>().swap(depth);
+    vector<Witness>().swap(witness);
+
+    forwardDist.assign(nodes + 1, INT_MAX);
+    backwardDist.assign(nodes + 1, INT_MAX);
+    forwardArc.assign(nodes + 1, -1);
+    backwardArc.assign(nodes + 1, -1);
+    forwardHeap.reset(nodes);
+    backwardHeap.reset(nodes);
+}
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  No index is held
+void ContractionHierarchy::clear() {
+    nodes = 0;
+    roundCount = 0;
+    shortcuts = 0;
+    settledCount = 0;
+    arcs.clear();
+    rank.clear();
+    upOffsets.clear();
+    upArcs.clear();
+    downOffsets.clear();
+    downArcs.clear();
+    touched.clear();
+}
+
+//----------------------------------------------------------------------------
+// built
+// Preconditions:   None
+// Postconditions:  Returns true if an index is held
+bool ContractionHierarchy::built() const {
+    return !upOffsets.empty();
+}
+
+//----------------------------------------------------------------------------
+// query
+// Preconditions:   Index is built, nodes are in the graph
+// Postconditions:  Returns the shortest distance from node 1 to node 2 and
+//                  the vector holds the nodes of the path from 1 to 2,
+//                  returns INT_MAX and an empty vector if there is no path
+int ContractionHierarchy::query(int s, int t, vector<int>& path) {
+    path.clear();
+    settledCount = 0;
+    for(int v : touched) {
+        forwardDist[v] = backwardDist[v] = INT_MAX;
+        forwardArc[v] = backwardArc[v] = -1;
+    }
+    touched.clear();
+    forwardHeap.clear();
+    backwardHeap.clear();
+
+    forwardDist[s] = 0;
+    backwardDist[t] = 0;
+    touched.push_back(s);
+    touched.push_back(t);
+    forwardHeap.update(s, 0);
+    backwardHeap.update(t, 0);
+    long long best = INT_MAX;       // shortest path length seen so far
+    int meet = 0;                   // node the shortest path goes through
+
+    // Each side stops once its nearest node is no closer than best
+    for(;;) {
+        bool forward = !forwardHeap.empty() && forwardHeap.topKey() < best;
+        bool backward = !backwardHeap.empty() &&
+                        backwardHeap.topKey() < best;
+        if(!forward && !backward) {
+            break;
+        }
+        if(forward && (!backward ||
+                       forwardHeap.topKey() <= backwardHeap.topKey())) {
+            int v = forwardHeap.pop();
+            settledCount++;
+            if(backwardDist[v] != INT_MAX &&
+               (long long)forwardDist[v] + backwardDist[v] < best) {
+                best = (long long)forwardDist[v] + backwardDist[v];
+                meet = v;
+            }
+            for(int i = upOffsets[v]; i < upOffsets[v + 1]; i++) {
+                const Arc& arc = arcs[upArcs[i]];
+                int through = forwardDist[v] + arc.length;
+                if(through < forwardDist[arc.to]) {
+                    touched.push_back(arc.to);
+                    forwardDist[arc.to] = through;
+                    forwardArc[arc.to] = upArcs[i];
+                    forwardHeap.update(arc.to, through);
+                }
+            }
+        }
+        else {
+            int v = backwardHeap.pop();
+            settledCount++;
+            if(forwardDist[v] != INT_MAX &&
+               (long long)forwardDist[v] + backwardDist[v] < best) {
+                best = (long long)forwardDist[v] + backwardDist[v];
+                meet = v;
+            }
+            for(int i = downOffsets[v]; i < downOffsets[v + 1]; i++) {
+                const Arc& arc = arcs[downArcs[i]];
+                int through = backwardDist[v] + arc.length;
+                if(through < backwardDist[arc.from]) {
+                    touched.push_back(arc.from);
+                    backwardDist[arc.from] = through;
+                    backwardArc[arc.from] = downArcs[i];
+                    backwardHeap.update(arc.from, through);
+                }
+            }
+        }
+    }
+    if(meet == 0) {
+        return INT_MAX;
+    }
+
+    // Arcs from the origin up to the meeting node, then down to the end
+    vector<int> climb;
+    for(int v = meet; v != s; v = arcs[forwardArc[v]].from) {
+        climb.push_back(forwardArc[v]);
+    }
+    path.push_back(s);
+    for(int i = climb.size() - 1; i >= 0; i--) {
+        unpack(climb[i], path);
+    }
+    for(int v = meet; v != t; v = arcs[backwardArc[v]].to) {
+        unpack(backwardArc[v], path);
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------
+// settled
+// Preconditions:   None
+// Postconditions:  Returns the nodes settled by the last query
+int ContractionHierarchy::settled() const {
+    return settledCount;
+}
+
+//----------------------------------------------------------------------------
+// shortcutCount, rounds, memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the shortcuts added, the rounds of contraction,
+//                  and the bytes held by the index
+int ContractionHierarchy::shortcutCount() const {
+    return shortcuts;
+}
+int ContractionHierarchy::rounds() const {
+    return roundCount;
+}
+size_t ContractionHierarchy::memoryBytes() const {
+    return arcs.capacity() * sizeof(Arc) +
+           (rank.capacity() + upOffsets.capacity() + upArcs.capacity() +
+            downOffsets.capacity() + downArcs.capacity()) * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// findShortcuts
+// Preconditions:   Node is live, working graph is built
+// Postconditions:  Worker's found vector holds the shortcuts contracting the
+//                  node needs when witness searches settle at most the
+//                  given nodes, returns how many
+int ContractionHierarchy::findShortcuts(int v, Witness& space,
+                                        int maxSettled) {
+    space.found.clear();
+    for(const Link& into : in[v]) {
+        int u = into.node;
+        int first = arcs[into.arc].length;
+
+        // Longest path through v the witness search has to beat, and the
+        // nodes it ends at, the search stops once all of them are settled
+        int limit = -1;
+        int targets = 0;
+        space.stamp++;
+        for(const Link& onward : out[v]) {
+            if(onward.node != u) {
+                limit = max(limit, first + arcs[onward.arc].length);
+                if(space.target[onward.node] != space.stamp) {
+                    space.target[onward.node] = space.stamp;
+                    targets++;
+                }
+            }
+        }
+        if(limit < 0) {
+            continue;
+        }
+
+        // Limited Dijkstra from u that does not pass through v or the round
+        vector<int>& dist = space.dist;
+        BinaryHeap& heap = space.heap;
+        dist[u] = 0;
+        space.touched.push_back(u);
+        heap.update(u, 0);
+        int settledNodes = 0;
+        while(!heap.empty() && heap.topKey() <= limit &&
+              settledNodes < maxSettled && targets > 0) {
+            int x = heap.pop();
+            settledNodes++;
+            if(space.target[x] == space.stamp) {
+                targets--;
+            }
+            for(const Link& link : out[x]) {
+                int k = link.node;
+                if(k == v || state[k] != 0) {
+                    continue;
+                }
+                int through = dist[x] + arcs[link.arc].length;
+                if(through < dist[k]) {
+                    if(dist[k] == INT_MAX) {
+                        space.touched.push_back(k);
+                    }
+                    dist[k] = through;
+                    heap.update(k, through);
+                }
+            }
+        }
+
+        for(const Link& onward : out[v]) {
+            int w = onward.node;
+            int via = first + arcs[onward.arc].length;
+            if(w != u && dist[w] > via) {
+                space.found.push_back(Shortcut{u, w, via, into.arc,
+                                               onward.arc});
+            }
+        }
+
+        heap.clear();
+        for(int x : space.touched) {
+            dist[x] = INT_MAX;
+        }
+        space.touched.clear();
+    }
+    return space.found.size();
+}
+
+//----------------------------------------------------------------------------
+// priority
+// Preconditions:   Node is live, working graph is built
+// Postconditions:  Returns twice the edge difference of contracting the node
+//                  plus its contracted neighbours and its depth
+int ContractionHierarchy::priority(int v, Witness& space) {
+    int added = findShortcuts(v, space, GUESS_SETTLED);
+    int removed = in[v].size() + out[v].size();
+    return 2 * (added - removed) + contractedNear[v] + depth[v];
+}
+
+//----------------------------------------------------------------------------
+// contract
+// Preconditions:   Node's shortcuts are in the parameter, node is in the
+//                  current round
+// Postconditions:  Node is contracted, its shortcuts are added to the
+//                  working graph, its live edges are kept as its up and
+//                  down arcs
+void ContractionHierarchy::contract(int v, const vector<Shortcut>& found,
+                                    vector<vector<int>>& up,
+                                    vector<vector<int>>& down) {
+    state[v] = 1;
+    auto dropLink = [v](vector<Link>& links) {
+        for(size_t i = 0; i < links.size(); i++) {
+            if(links[i].node == v) {
+                links[i] = links.back();
+                links.pop_back();
+                return;
+            }
+        }
+    };
+
+    // Every live neighbour is contracted later, so has a higher rank
+    for(const Link& link : out[v]) {
+        up[v].push_back(link.arc);
+        dropLink(in[link.node]);
+        contractedNear[link.node]++;
+        depth[link.node] = max(depth[link.node], depth[v] + 1);
+    }
+    for(const Link& link : in[v]) {
+        down[v].push_back(link.arc);
+        dropLink(out[link.node]);
+        contractedNear[link.node]++;
+        depth[link.node] = max(depth[link.node], depth[v] + 1);
+    }
+    vector<Link>().swap(out[v]);
+    vector<Link>().swap(in[v]);
+
+    for(const Shortcut& shortcut : found) {
+        addArc(shortcut);
+    }
+}
+
+//----------------------------------------------------------------------------
+// addArc
+// Preconditions:   Both nodes are live
+// Postconditions:  Shortcut is in the working graph, replacing a longer
+//                  edge between the same nodes, kept out if not shorter
+void ContractionHierarchy::addArc(const Shortcut& shortcut) {
+    Link* there = nullptr;
+    for(Link& link : out[shortcut.from]) {
+        if(link.node == shortcut.to) {
+            there = &link;
+        }
+    }
+    if(there != nullptr && arcs[there->arc].length <= shortcut.length) {
+        return;
+    }
+
+    int id = arcs.size();
+    arcs.push_back(Arc{shortcut.from, shortcut.to, shortcut.length,
+                       shortcut.first, shortcut.second});
+    shortcuts++;
+    if(there == nullptr) {
+        out[shortcut.from].push_back(Link{shortcut.to, id});
+        in[shortcut.to].push_back(Link{shortcut.from, id});
+        return;
+    }
+    there->arc = id;
+    for(Link& link : in[shortcut.to]) {
+        if(link.node == shortcut.from) {
+            link.arc = id;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// unpack
+// Preconditions:   Arc is in arcs
+// Postconditions:  Original nodes after the arc's origin up to its
+//                  destination are added to the end of the path
+void ContractionHierarchy::unpack(int arc, vector<int>& path) const {
+    vector<int> pending(1, arc);
+    while(!pending.empty()) {
+        const Arc& a = arcs[pending.back()];
+        pending.pop_back();
+        if(a.first == -1) {
+            path.push_back(a.to);
+        }
+        else {
+            pending.push_back(a.second);
+            pending.push_back(a.first);
+        }
+    }
+}
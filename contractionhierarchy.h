@@ -0,0 +1,203 @@
+//----------------------------------------------------------------------------
+// CONTRACTIONHIERARCHY.H
+// Class for a contraction hierarchy index of a weighted directed graph
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ContractionHierarchy: shortest paths between 2 nodes of a static graph
+// and allows other features:
+//      --building the index from a CSRGraph, on several threads through a
+//        ThreadPool
+//      --finding the shortest distance and path between 2 nodes with a
+//        search that settles a few hundred nodes even on large road graphs
+//      --counts of shortcuts, bytes used and nodes settled by a query
+//
+// Implementation and assumptions:
+//      --nodes are contracted one after another, contracting a node removes
+//        it and adds a shortcut edge u -> w for each pair of its neighbours
+//        whose only shortest path went through it, a limited Dijkstra search
+//        (a witness search) checks for another path first
+//      --the next nodes to contract are the ones with the lowest priority,
+//        twice the edge difference (shortcuts added less edges removed) plus
+//        the neighbours already contracted and the depth of contracted nodes
+//        below it, so the graph is worked on evenly, priorities come from
+//        shorter witness searches than the ones of the contraction itself
+//      --each round contracts every node whose priority is lower than all of
+//        its neighbours', no 2 such nodes are neighbours so their witness
+//        searches and shortcuts are found in parallel, witness searches do
+//        not pass through nodes of the same round, the priorities of the
+//        neighbours are then found again, also in parallel
+//      --a node's rank is the round order it was contracted in, a query
+//        searches forward from the origin only over edges to higher ranks,
+//        backward from the destination the same way, and meets at the
+//        highest ranked node of the path
+//      --every shortcut remembers the 2 edges it replaced, so a path found
+//        is unpacked back to the original edges
+//      --on paths of equal length the path found may differ from the one
+//        Dijkstra's algorithm picks
+//      --the index only holds for the edges it was built from
+//      --edge lengths are assumed to be 0 or more, node ids are in the range
+//        1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "csrgraph.h"
+#include "dheap.h"
+#include "threadpool.h"
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+class ContractionHierarchy {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No index is held
+    ContractionHierarchy();
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Graph is merged
+// Postconditions:  Index is built for the graph, the work of each round is
+//                  spread over the pool when one is given
+    void build(const CSRGraph&, ThreadPool* = nullptr);
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  No index is held
+    void clear();
+
+//----------------------------------------------------------------------------
+// built
+// Preconditions:   None
+// Postconditions:  Returns true if an index is held
+    bool built() const;
+
+//----------------------------------------------------------------------------
+// query
+// Preconditions:   Index is built, nodes are in the graph
+// Postconditions:  Returns the shortest distance from node 1 to node 2 and
+//                  the vector holds the nodes of the path from 1 to 2,
+//                  returns INT_MAX and an empty vector if there is no path
+    int query(int, int, vector<int>&);
+
+//----------------------------------------------------------------------------
+// settled
+// Preconditions:   None
+// Postconditions:  Returns the nodes settled by the last query
+    int settled() const;
+
+//----------------------------------------------------------------------------
+// shortcutCount, rounds, memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the shortcuts added, the rounds of contraction,
+//                  and the bytes held by the index
+    int shortcutCount() const;
+    int rounds() const;
+    size_t memoryBytes() const;
+
+private:
+    static const int MAX_SETTLED = 500;  // nodes a witness search may settle
+    static const int GUESS_SETTLED = 10; // the same, finding a priority
+
+    struct Arc {
+        int from;           // origin node
+        int to;             // destination node
+        int length;         // length of the edge or shortcut
+        int first;          // arc from origin to the middle node, -1 if none
+        int second;         // arc from the middle node to destination
+    };
+    struct Link {
+        int node;           // node at the other end
+        int arc;            // index in arcs
+    };
+    struct Shortcut {
+        int from;           // origin node
+        int to;             // destination node
+        int length;         // length through the contracted node
+        int first;          // arc into the contracted node
+        int second;         // arc out of the contracted node
+    };
+    struct alignas(64) Witness {
+        vector<int> dist;           // distance from the search's source
+        vector<int> touched;        // nodes whose distance is set
+        vector<int> target;         // stamp of the search a node ends
+        int stamp;                  // stamp of the current search
+        BinaryHeap heap;            // queue of the search
+        vector<Shortcut> found;     // shortcuts found for a node
+    };
+
+    int nodes;                      // number of nodes of the graph
+    int roundCount;                 // rounds of contraction of the build
+    int shortcuts;                  // arcs that are shortcuts
+    vector<Arc> arcs;               // original edges then shortcuts
+    vector<int> rank;               // contraction order of each node
+    vector<int> upOffsets;          // first up arc of each node
+    vector<int> upArcs;             // arcs to higher ranks, by origin
+    vector<int> downOffsets;        // first down arc of each node
+    vector<int> downArcs;           // arcs from higher ranks, by destination
+
+    // Working graph, only used while building
+    vector<vector<Link>> out;       // live edges out of each node
+    vector<vector<Link>> in;        // live edges into each node
+    vector<char> state;             // 0 live, 1 contracted, 2 this round
+    vector<int> contractedNear;     // neighbours contracted before the node
+    vector<int> depth;              // longest chain of contracted nodes below
+    vector<Witness> witness;        // per-worker search space
+
+    // Query search space
+    vector<int> forwardDist;        // distance from the origin
+    vector<int> backwardDist;       // distance to the destination
+    vector<int> forwardArc;         // arc the forward search came in on
+    vector<int> backwardArc;        // arc the backward search came in on
+    vector<int> touched;            // nodes to reset before the next query
+    BinaryHeap forwardHeap;         // queue of the forward search
+    BinaryHeap backwardHeap;        // queue of the backward search
+    int settledCount;               // nodes settled by the last query
+
+//----------------------------------------------------------------------------
+// findShortcuts
+// Preconditions:   Node is live, working graph is built
+// Postconditions:  Worker's found vector holds the shortcuts contracting the
+//                  node needs when witness searches settle at most the
+//                  given nodes, returns how many
+    int findShortcuts(int, Witness&, int);
+
+//----------------------------------------------------------------------------
+// priority
+// Preconditions:   Node is live, working graph is built
+// Postconditions:  Returns twice the edge difference of contracting the node
+//                  plus its contracted neighbours and its depth
+    int priority(int, Witness&);
+
+//----------------------------------------------------------------------------
+// contract
+// Preconditions:   Node's shortcuts are in the parameter, node is in the
+//                  current round
+// Postconditions:  Node is contracted, its shortcuts are added to the
+//                  working graph, its live edges are kept as its up and
+//                  down arcs
+    void contract(int, const vector<Shortcut>&, vector<vector<int>>&,
+                  vector<vector<int>>&);
+
+//----------------------------------------------------------------------------
+// addArc
+// Preconditions:   Both nodes are live
+// Postconditions:  Shortcut is in the working graph, replacing a longer
+//                  edge between the same nodes, kept out if not shorter
+    void addArc(const Shortcut&);
+
+//----------------------------------------------------------------------------
+// unpack
+// Preconditions:   Arc is in arcs
+// Postconditions:  Original nodes after the arc's origin up to its
+//                  destination are added to the end of the path
+    void unpack(int, vector<int>&) const;
+};
+
+#endif
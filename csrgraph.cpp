@@ -0,0 +1,392 @@
+//----------------------------------------------------------------------------
+// CSRGRAPH.CPP
+// Implementation for CSRGraph Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// CSRGraph: stores the edges of a graph by origin node
+// and allows other features:
+//      --building the edge store from a list of edges in one pass
+//      --lookup of the length of the edge between 2 nodes
+//      --insertion and removal of individual edges
+//      --walking the edges of a node in order of destination node
+//      --building the reverse (transposed) edge store
+//
+// Implementation and assumptions:
+//      --uses 3 contiguous arrays: offsets holds where the edges of each node
+//        begin, targets and weights hold the destination and length of each
+//        edge, so memory grows with the number of edges instead of nodes^2
+//      --the edges of each node are sorted by destination node
+//      --insertions and removals go to a small delta buffer first, the
+//        buffer is merged into the arrays when it fills up or when merge is
+//        called, the arrays only reflect the delta after a merge
+//      --node ids are in the range 1 to the node count (node 0 is not used
+//        and never has edges), a length of INT_MAX means there is no edge
+//      --when the same edge is given more than once, the last length wins
+//----------------------------------------------------------------------------
+
+#include "csrgraph.h"
+#include <algorithm>
+#include <utility>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Edge store holds 0 nodes and no edges
+CSRGraph::CSRGraph() {
+    build(0, vector<Edge>());
+}
+
+//----------------------------------------------------------------------------
+// Copy constructor
+// Preconditions:   None
+// Postconditions:  Edge store is a copy of the parameter, a view of memory
+//                  stays a view of the same memory
+CSRGraph::CSRGraph(const CSRGraph& other) {
+    *this = other;
+}
+
+//----------------------------------------------------------------------------
+// Move constructor
+// Preconditions:   None
+// Postconditions:  Edge store takes the parameter's arrays, the parameter
+//                  holds 0 nodes
+CSRGraph::CSRGraph(CSRGraph&& other) noexcept {
+    *this = move(other);
+}
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  Edge store is a copy of the parameter, a view of memory
+//                  stays a view of the same memory
+CSRGraph& CSRGraph::operator=(const CSRGraph& other) {
+    if(this != &other) {
+        nodes = other.nodes;
+        view = other.view;
+        heldOffsets = other.heldOffsets;
+        heldTargets = other.heldTargets;
+        heldWeights = other.heldWeights;
+        delta = other.delta;
+        edges = other.edges;
+        offsets = other.offsets;
+        targets = other.targets;
+        weights = other.weights;
+        if(!view) {
+            hold();         // point at the copied arrays, not the parameter's
+        }
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  Edge store takes the parameter's arrays, the parameter
+//                  holds 0 nodes
+CSRGraph& CSRGraph::operator=(CSRGraph&& other) noexcept {
+    if(this != &other) {
+        nodes = other.nodes;
+        view = other.view;
+        heldOffsets = move(other.heldOffsets);
+        heldTargets = move(other.heldTargets);
+        heldWeights = move(other.heldWeights);
+        delta = move(other.delta);
+        edges = other.edges;
+        offsets = other.offsets;
+        targets = other.targets;
+        weights = other.weights;
+        if(!view) {
+            hold();
+        }
+        other.nodes = 0;
+        other.view = false;
+        other.hold();
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   None
+// Postconditions:  Edge store holds the given number of nodes and the edges
+//                  of the list, edges with an invalid node are ignored, the
+//                  delta buffer is emptied
+void CSRGraph::build(int n, const vector<Edge>& list) {
+    nodes = n < 0 ? 0 : n;
+    delta.clear();
+    view = false;
+
+    // First pass, count the edges of each node
+    heldOffsets.assign(nodes + 2, 0);
+    for(const Edge& e : list) {
+        if(e.from >= 1 && e.from <= nodes && e.to >= 1 && e.to <= nodes &&
+           e.length != INT_MAX) {
+            heldOffsets[e.from + 1]++;
+        }
+    }
+    for(int v = 1; v <= nodes + 1; v++) {
+        heldOffsets[v] += heldOffsets[v - 1];
+    }
+
+    // Second pass, place each edge in its node's range, keeping input order
+    heldTargets.resize(heldOffsets[nodes + 1]);
+    heldWeights.resize(heldOffsets[nodes + 1]);
+    vector<int> next(heldOffsets.begin(), heldOffsets.end() - 1);
+    for(const Edge& e : list) {
+        if(e.from >= 1 && e.from <= nodes && e.to >= 1 && e.to <= nodes &&
+           e.length != INT_MAX) {
+            heldTargets[next[e.from]] = e.to;
+            heldWeights[next[e.from]] = e.length;
+            next[e.from]++;
+        }
+    }
+
+    // Sort each node's edges by destination, the last duplicate wins
+    vector<pair<int, int>> row;
+    int write = 0;
+    for(int v = 0; v <= nodes; v++) {
+        row.clear();
+        for(int e = heldOffsets[v]; e < heldOffsets[v + 1]; e++) {
+            row.push_back(make_pair(heldTargets[e], heldWeights[e]));
+        }
+        stable_sort(row.begin(), row.end(),
+                    [](const pair<int, int>& a, const pair<int, int>& b) {
+                        return a.first < b.first;
+                    });
+        heldOffsets[v] = write;
+        for(size_t k = 0; k < row.size(); k++) {
+            if(k + 1 < row.size() && row[k + 1].first == row[k].first) {
+                continue;
+            }
+            heldTargets[write] = row[k].first;
+            heldWeights[write] = row[k].second;
+            write++;
+        }
+    }
+    heldOffsets[nodes + 1] = write;
+    heldTargets.resize(write);
+    heldWeights.resize(write);
+    hold();
+}
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Arrays are laid out as the ones build makes, with the
+//                  given node and edge counts, and outlive this store and
+//                  its copies
+// Postconditions:  Edge store is a view of the arrays, which are never
+//                  written, the delta buffer is emptied
+void CSRGraph::attach(int n, int m, const int* offsetArray,
+                      const int* targetArray, const int* weightArray) {
+    nodes = n;
+    delta.clear();
+    vector<int>().swap(heldOffsets);
+    vector<int>().swap(heldTargets);
+    vector<int>().swap(heldWeights);
+    view = true;
+    edges = m;
+    offsets = offsetArray;
+    targets = targetArray;
+    weights = weightArray;
+}
+
+//----------------------------------------------------------------------------
+// nodeCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes
+int CSRGraph::nodeCount() const {
+    return nodes;
+}
+
+//----------------------------------------------------------------------------
+// edgeCount
+// Preconditions:   None
+// Postconditions:  Returns the number of edges held in the arrays, pending
+//                  changes in the delta buffer are not counted
+int CSRGraph::edgeCount() const {
+    return edges;
+}
+
+//----------------------------------------------------------------------------
+// length
+// Preconditions:   None
+// Postconditions:  Returns the length of the edge from the first node to the
+//                  second, including pending changes, INT_MAX if no edge
+int CSRGraph::length(int from, int to) const {
+    if(from < 1 || from > nodes || to < 1 || to > nodes) {
+        return INT_MAX;
+    }
+    // Newest pending change wins
+    for(int k = (int)delta.size() - 1; k >= 0; k--) {
+        if(delta[k].from == from && delta[k].to == to) {
+            return delta[k].length;
+        }
+    }
+    int e = find(from, to);
+    return e == -1 ? INT_MAX : weights[e];
+}
+
+//----------------------------------------------------------------------------
+// insertEdge
+// Preconditions:   None
+// Postconditions:  Returns false if invalid parameters or a duplicate edge
+//                  otherwise adds the edge to the delta buffer and returns
+//                  true
+bool CSRGraph::insertEdge(int from, int to, int len) {
+    if(from < 1 || from > nodes || to < 1 || to > nodes || len == INT_MAX) {
+        return false;
+    }
+    if(length(from, to) != INT_MAX) {
+        return false;
+    }
+    delta.push_back(Edge{from, to, len});
+    if((int)delta.size() >= MAX_DELTA) {
+        merge();
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// removeEdge
+// Preconditions:   None
+// Postconditions:  Returns false if invalid parameters or no such edge
+//                  otherwise records the removal in the delta buffer and
+//                  returns true
+bool CSRGraph::removeEdge(int from, int to) {
+    if(length(from, to) == INT_MAX) {
+        return false;
+    }
+    delta.push_back(Edge{from, to, INT_MAX});
+    if((int)delta.size() >= MAX_DELTA) {
+        merge();
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// merge
+// Preconditions:   None
+// Postconditions:  Pending changes in the delta buffer are applied to the
+//                  arrays, the delta buffer is emptied
+void CSRGraph::merge() {
+    if(delta.empty()) {
+        return;
+    }
+    // Group changes by edge, later changes stay after earlier ones
+    stable_sort(delta.begin(), delta.end(), [](const Edge& a, const Edge& b) {
+        return a.from < b.from || (a.from == b.from && a.to < b.to);
+    });
+
+    vector<int> newOffsets(nodes + 2, 0);
+    vector<int> newTargets;
+    vector<int> newWeights;
+    newTargets.reserve(edges + delta.size());
+    newWeights.reserve(edges + delta.size());
+
+    size_t d = 0;
+    for(int v = 0; v <= nodes; v++) {
+        newOffsets[v] = newTargets.size();
+        int e = offsets[v];
+        while(e < offsets[v + 1] || (d < delta.size() && delta[d].from == v)) {
+            bool fromDelta = d < delta.size() && delta[d].from == v &&
+                             (e == offsets[v + 1] || delta[d].to <= targets[e]);
+            if(!fromDelta) {
+                newTargets.push_back(targets[e]);
+                newWeights.push_back(weights[e]);
+                e++;
+                continue;
+            }
+            // Skip to the newest change of this edge
+            while(d + 1 < delta.size() && delta[d + 1].from == v &&
+                  delta[d + 1].to == delta[d].to) {
+                d++;
+            }
+            if(e < offsets[v + 1] && targets[e] == delta[d].to) {
+                e++;        // old edge is replaced or removed
+            }
+            if(delta[d].length != INT_MAX) {
+                newTargets.push_back(delta[d].to);
+                newWeights.push_back(delta[d].length);
+            }
+            d++;
+        }
+    }
+    newOffsets[nodes + 1] = newTargets.size();
+
+    // A view's arrays are left alone, the merged ones are held from now on
+    heldOffsets.swap(newOffsets);
+    heldTargets.swap(newTargets);
+    heldWeights.swap(newWeights);
+    view = false;
+    hold();
+    delta.clear();
+}
+
+//----------------------------------------------------------------------------
+// transpose
+// Preconditions:   Delta buffer has been merged
+// Postconditions:  Parameter holds every edge of this store reversed, so its
+//                  edges of a node are the edges into that node here
+void CSRGraph::transpose(CSRGraph& out) const {
+    out.nodes = nodes;
+    out.delta.clear();
+    out.view = false;
+
+    // First pass, count the edges into each node
+    out.heldOffsets.assign(nodes + 2, 0);
+    for(int e = 0; e < edges; e++) {
+        out.heldOffsets[targets[e] + 1]++;
+    }
+    for(int v = 1; v <= nodes + 1; v++) {
+        out.heldOffsets[v] += out.heldOffsets[v - 1];
+    }
+
+    // Second pass, origins are visited in order so each row stays sorted
+    out.heldTargets.resize(edges);
+    out.heldWeights.resize(edges);
+    vector<int> next(out.heldOffsets.begin(), out.heldOffsets.end() - 1);
+    for(int v = 0; v <= nodes; v++) {
+        for(int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int k = next[targets[e]]++;
+            out.heldTargets[k] = v;
+            out.heldWeights[k] = weights[e];
+        }
+    }
+    out.hold();
+}
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the arrays and delta buffer
+size_t CSRGraph::memoryBytes() const {
+    return (heldOffsets.capacity() + heldTargets.capacity() +
+            heldWeights.capacity()) * sizeof(int) +
+           delta.capacity() * sizeof(Edge);
+}
+
+//----------------------------------------------------------------------------
+// hold
+// Preconditions:   Store is not a view
+// Postconditions:  Arrays read are the ones held by this store
+void CSRGraph::hold() {
+    offsets = heldOffsets.data();
+    targets = heldTargets.data();
+    weights = heldWeights.data();
+    edges = heldTargets.size();
+}
+
+//----------------------------------------------------------------------------
+// find
+// Preconditions:   None
+// Postconditions:  Returns the index of the edge in the arrays, -1 if the
+//                  arrays hold no such edge
+int CSRGraph::find(int from, int to) const {
+    const int* first = targets + offsets[from];
+    const int* last = targets + offsets[from + 1];
+    const int* it = lower_bound(first, last, to);
+    if(it == last || *it != to) {
+        return -1;
+    }
+    return it - targets;
+}
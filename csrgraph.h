@@ -0,0 +1,194 @@
+//----------------------------------------------------------------------------
+// CSRGRAPH.H
+// Class for the edges of a weighted directed graph in compressed sparse rows
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// CSRGraph: stores the edges of a graph by origin node
+// and allows other features:
+//      --building the edge store from a list of edges in one pass
+//      --lookup of the length of the edge between 2 nodes
+//      --insertion and removal of individual edges
+//      --walking the edges of a node in order of destination node
+//      --building the reverse (transposed) edge store
+//
+// Implementation and assumptions:
+//      --uses 3 contiguous arrays: offsets holds where the edges of each node
+//        begin, targets and weights hold the destination and length of each
+//        edge, so memory grows with the number of edges instead of nodes^2
+//      --the edges of each node are sorted by destination node
+//      --insertions and removals go to a small delta buffer first, the
+//        buffer is merged into the arrays when it fills up or when merge is
+//        called, the arrays only reflect the delta after a merge
+//      --node ids are in the range 1 to the node count (node 0 is not used
+//        and never has edges), a length of INT_MAX means there is no edge
+//      --when the same edge is given more than once, the last length wins
+//      --the arrays can instead be a view of memory held elsewhere, such as a
+//        mapped snapshot file, which is only read, the first merge with
+//        pending changes makes arrays of its own
+//----------------------------------------------------------------------------
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+struct Edge {
+    int from;       // origin node
+    int to;         // destination node
+    int length;     // length of the edge
+};
+
+class CSRGraph {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Edge store holds 0 nodes and no edges
+    CSRGraph();
+
+//----------------------------------------------------------------------------
+// Copy constructor, move constructor
+// Preconditions:   None
+// Postconditions:  Edge store is a copy of the parameter, or takes its
+//                  arrays and leaves it with 0 nodes, a view of memory stays
+//                  a view of the same memory
+    CSRGraph(const CSRGraph&);
+    CSRGraph(CSRGraph&&) noexcept;
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  As the copy and move constructors
+    CSRGraph& operator=(const CSRGraph&);
+    CSRGraph& operator=(CSRGraph&&) noexcept;
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   None
+// Postconditions:  Edge store holds the given number of nodes and the edges
+//                  of the list, edges with an invalid node are ignored, the
+//                  delta buffer is emptied
+    void build(int, const vector<Edge>&);
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Arrays are laid out as the ones build makes, with the
+//                  given node and edge counts, and outlive this store and
+//                  its copies
+// Postconditions:  Edge store is a view of the arrays, which are never
+//                  written, the delta buffer is emptied
+    void attach(int, int, const int*, const int*, const int*);
+
+//----------------------------------------------------------------------------
+// nodeCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes
+    int nodeCount() const;
+
+//----------------------------------------------------------------------------
+// edgeCount
+// Preconditions:   None
+// Postconditions:  Returns the number of edges held in the arrays, pending
+//                  changes in the delta buffer are not counted
+    int edgeCount() const;
+
+//----------------------------------------------------------------------------
+// length
+// Preconditions:   None
+// Postconditions:  Returns the length of the edge from the first node to the
+//                  second, including pending changes, INT_MAX if no edge
+    int length(int, int) const;
+
+//----------------------------------------------------------------------------
+// insertEdge
+// Preconditions:   None
+// Postconditions:  Returns false if invalid parameters or a duplicate edge
+//                  otherwise adds the edge to the delta buffer and returns
+//                  true
+    bool insertEdge(int, int, int);
+
+//----------------------------------------------------------------------------
+// removeEdge
+// Preconditions:   None
+// Postconditions:  Returns false if invalid parameters or no such edge
+//                  otherwise records the removal in the delta buffer and
+//                  returns true
+    bool removeEdge(int, int);
+
+//----------------------------------------------------------------------------
+// merge
+// Preconditions:   None
+// Postconditions:  Pending changes in the delta buffer are applied to the
+//                  arrays, the delta buffer is emptied
+    void merge();
+
+//----------------------------------------------------------------------------
+// begin, end
+// Preconditions:   Delta buffer has been merged
+// Postconditions:  Returns the first and one past the last edge index of the
+//                  node, for use with target and weight
+    int begin(int v) const { return offsets[v]; }
+    int end(int v) const { return offsets[v + 1]; }
+
+//----------------------------------------------------------------------------
+// target, weight
+// Preconditions:   Edge index came from begin and end
+// Postconditions:  Returns the destination node and length of the edge
+    int target(int e) const { return targets[e]; }
+    int weight(int e) const { return weights[e]; }
+
+//----------------------------------------------------------------------------
+// offsetData, targetData, weightData
+// Preconditions:   Delta buffer has been merged
+// Postconditions:  Returns the arrays read by begin and end (node count + 2
+//                  entries), target and weight (edge count entries)
+    const int* offsetData() const { return offsets; }
+    const int* targetData() const { return targets; }
+    const int* weightData() const { return weights; }
+
+//----------------------------------------------------------------------------
+// transpose
+// Preconditions:   Delta buffer has been merged
+// Postconditions:  Parameter holds every edge of this store reversed, so its
+//                  edges of a node are the edges into that node here
+    void transpose(CSRGraph&) const;
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the arrays and delta buffer
+    size_t memoryBytes() const;
+
+private:
+    static const int MAX_DELTA = 64;    // pending changes before a merge
+
+    int nodes;                  // number of nodes
+    int edges;                  // number of edges in the arrays
+    bool view;                  // whether the arrays are held elsewhere
+    const int* offsets;         // first edge of each node, nodes + 2 entries
+    const int* targets;         // destination node of each edge
+    const int* weights;         // length of each edge
+    vector<int> heldOffsets;    // arrays read, unless a view
+    vector<int> heldTargets;
+    vector<int> heldWeights;
+    vector<Edge> delta;         // pending changes, INT_MAX length = removal
+
+//----------------------------------------------------------------------------
+// hold
+// Preconditions:   Store is not a view
+// Postconditions:  Arrays read are the ones held by this store
+    void hold();
+
+//----------------------------------------------------------------------------
+// find
+// Preconditions:   None
+// Postconditions:  Returns the index of the edge in the arrays, -1 if the
+//                  arrays hold no such edge
+    int find(int, int) const;
+};
+
+#endif
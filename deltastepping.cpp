@@ -0,0 +1,235 @@
+//----------------------------------------------------------------------------
+// DELTASTEPPING.CPP
+// Implementation for DeltaStepping Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// DeltaStepping: shortest distance from one source to every node of a graph
+// and allows other features:
+//      --running one source on several threads through a ThreadPool
+//      --choice of the bucket width delta, or one picked from the spread of
+//        the edge lengths
+//      --counts of the phases run by the last source
+//
+// Implementation and assumptions:
+//      --nodes wait in buckets by distance / delta, the lowest bucket that
+//        is not empty is emptied in phases, each phase relaxes the light
+//        edges (length delta or less) of every node in the bucket at once,
+//        which can put nodes back into the same bucket for the next phase
+//      --once the bucket stays empty the heavy edges of every node it held
+//        are relaxed, these only reach later buckets
+//      --the nodes of a phase are spread over the threads, distances are
+//        atomic and only ever lowered with compare and swap, each worker
+//        keeps the nodes it lowered and they are put in their buckets
+//        between phases
+//      --a node can sit in a bucket more than once or in a bucket it has
+//        since left, entries whose distance is no longer in the bucket are
+//        skipped
+//      --buckets are reused in a ring, the longest edge can only reach
+//        longest / delta buckets ahead, delta is raised if the ring would
+//        need more than MAX_BUCKETS
+//      --the distances are the same as Dijkstra's algorithm, which is exact
+//        for any lengths of 0 or more, suits also asks for positive lengths
+//        so the previous nodes can be taken from the distances
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "deltastepping.h"
+#include <algorithm>
+
+// Phases with fewer nodes than this run on the calling thread alone, the
+// pool costs more than it saves on them
+static const int PARALLEL_NODES = 256;
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is solved, delta is picked from the graph
+DeltaStepping::DeltaStepping()
+    : chosen(0), width(1), nodes(0), phaseCount(0), stamp(0) {
+}
+
+//----------------------------------------------------------------------------
+// suits
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns true if every edge length is positive
+bool DeltaStepping::suits(const CSRGraph& g) {
+    for(int v = 1; v <= g.nodeCount(); v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            if(g.weight(e) <= 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// suggestDelta
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns the edge length below which about one edge per
+//                  node falls, at least 1
+int DeltaStepping::suggestDelta(const CSRGraph& g) {
+    // With d edges per node, delta near the (1 / d) quantile of the lengths
+    // keeps the light edges of a bucket few but the buckets full
+    vector<int> lengths;
+    lengths.reserve(g.edgeCount());
+    for(int v = 1; v <= g.nodeCount(); v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            lengths.push_back(g.weight(e));
+        }
+    }
+    if(lengths.empty()) {
+        return 1;
+    }
+    size_t at = min((size_t)g.nodeCount(), lengths.size() - 1);
+    nth_element(lengths.begin(), lengths.begin() + at, lengths.end());
+    return max(lengths[at], 1);
+}
+
+//----------------------------------------------------------------------------
+// setDelta
+// Preconditions:   None
+// Postconditions:  Later calls to solve use buckets of the given width, 0 or
+//                  less picks it with suggestDelta
+void DeltaStepping::setDelta(int value) {
+    chosen = value;
+}
+
+//----------------------------------------------------------------------------
+// delta
+// Preconditions:   None
+// Postconditions:  Returns the bucket width used by the last solve
+int DeltaStepping::delta() const {
+    return width;
+}
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Delta buffer of the graph has been merged, source is in
+//                  the graph
+// Postconditions:  Shortest distance from the source to every node is found,
+//                  the nodes of each phase are spread over the pool when one
+//                  is given
+void DeltaStepping::solve(const CSRGraph& g, int source, ThreadPool* pool) {
+    if(!dist || nodes != g.nodeCount()) {
+        nodes = g.nodeCount();
+        dist.reset(new atomic<int>[nodes + 1]);
+        taken.assign(nodes + 1, -1);
+    }
+    for(int v = 0; v <= nodes; v++) {
+        dist[v].store(INT_MAX, memory_order_relaxed);
+    }
+    workers.resize(pool == nullptr ? 1 : pool->threadCount());
+    phaseCount = 0;
+
+    // The ring must reach from a bucket to its longest edge's bucket
+    int longest = 0;
+    for(int v = 1; v <= nodes; v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            longest = max(longest, g.weight(e));
+        }
+    }
+    width = chosen > 0 ? chosen : suggestDelta(g);
+    width = max(width, longest / (MAX_BUCKETS - 2) + 1);
+    int ring = longest / width + 2;
+    buckets.resize(ring);
+    for(vector<int>& bucket : buckets) {
+        bucket.clear();
+    }
+
+    dist[source].store(0, memory_order_relaxed);
+    buckets[0].push_back(source);
+    long queued = 1;                // entries in all buckets
+    for(long current = 0; queued > 0; current++) {
+        vector<int>& bucket = buckets[current % ring];
+        done.clear();
+        while(!bucket.empty()) {
+            phaseCount++;
+            stamp++;
+            queued -= bucket.size();
+            frontier.clear();
+            for(int v : bucket) {
+                if(dist[v].load(memory_order_relaxed) / width == current &&
+                   taken[v] != stamp) {
+                    taken[v] = stamp;
+                    frontier.push_back(v);
+                }
+            }
+            bucket.clear();
+            relax(g, frontier, true, pool);
+            done.insert(done.end(), frontier.begin(), frontier.end());
+            queued += place(ring);
+        }
+
+        // Heavy edges once per node, from its final distance
+        sort(done.begin(), done.end());
+        done.erase(unique(done.begin(), done.end()), done.end());
+        relax(g, done, false, pool);
+        queued += place(ring);
+    }
+}
+
+//----------------------------------------------------------------------------
+// phases
+// Preconditions:   None
+// Postconditions:  Returns the phases run by the last solve
+long DeltaStepping::phases() const {
+    return phaseCount;
+}
+
+//----------------------------------------------------------------------------
+// relax
+// Preconditions:   Node list is not changed while the phase runs
+// Postconditions:  Edges out of every node of the list that are light, or
+//                  heavy, are relaxed, lowered nodes are in the workers'
+//                  lists
+void DeltaStepping::relax(const CSRGraph& g, const vector<int>& list,
+                          bool light, ThreadPool* pool) {
+    auto step = [&](int index, int worker) {
+        int v = list[index];
+        int base = dist[v].load(memory_order_relaxed);
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            int length = g.weight(e);
+            if((length <= width) != light) {
+                continue;
+            }
+            int k = g.target(e);
+            int through = base + length;
+            int seen = dist[k].load(memory_order_relaxed);
+            while(through < seen) {
+                if(dist[k].compare_exchange_weak(seen, through,
+                                                 memory_order_relaxed)) {
+                    workers[worker].lowered.push_back(k);
+                    break;
+                }
+            }
+        }
+    };
+    int count = list.size();
+    if(pool == nullptr || count < PARALLEL_NODES) {
+        for(int i = 0; i < count; i++) {
+            step(i, 0);
+        }
+        return;
+    }
+    int grain = count / (pool->threadCount() * 8);
+    pool->parallelFor(0, count, grain < 1 ? 1 : grain, step);
+}
+
+//----------------------------------------------------------------------------
+// place
+// Preconditions:   Ring is the number of buckets
+// Postconditions:  Nodes in the workers' lists are in the buckets of their
+//                  distances, the lists are empty, returns the entries added
+long DeltaStepping::place(int ring) {
+    long added = 0;
+    for(Worker& worker : workers) {
+        for(int k : worker.lowered) {
+            long number = dist[k].load(memory_order_relaxed) / width;
+            buckets[number % ring].push_back(k);
+        }
+        added += worker.lowered.size();
+        worker.lowered.clear();
+    }
+    return added;
+}
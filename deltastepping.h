@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------
+// DELTASTEPPING.H
+// Class for single source shortest distances by parallel delta-stepping
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// DeltaStepping: shortest distance from one source to every node of a graph
+// and allows other features:
+//      --running one source on several threads through a ThreadPool
+//      --choice of the bucket width delta, or one picked from the spread of
+//        the edge lengths
+//      --counts of the phases run by the last source
+//
+// Implementation and assumptions:
+//      --nodes wait in buckets by distance / delta, the lowest bucket that
+//        is not empty is emptied in phases, each phase relaxes the light
+//        edges (length delta or less) of every node in the bucket at once,
+//        which can put nodes back into the same bucket for the next phase
+//      --once the bucket stays empty the heavy edges of every node it held
+//        are relaxed, these only reach later buckets
+//      --the nodes of a phase are spread over the threads, distances are
+//        atomic and only ever lowered with compare and swap, each worker
+//        keeps the nodes it lowered and they are put in their buckets
+//        between phases
+//      --a node can sit in a bucket more than once or in a bucket it has
+//        since left, entries whose distance is no longer in the bucket are
+//        skipped
+//      --buckets are reused in a ring, the longest edge can only reach
+//        longest / delta buckets ahead, delta is raised if the ring would
+//        need more than MAX_BUCKETS
+//      --the distances are the same as Dijkstra's algorithm, which is exact
+//        for any lengths of 0 or more, suits also asks for positive lengths
+//        so the previous nodes can be taken from the distances
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include "csrgraph.h"
+#include "threadpool.h"
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class DeltaStepping {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is solved, delta is picked from the graph
+    DeltaStepping();
+
+//----------------------------------------------------------------------------
+// suits
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns true if every edge length is positive
+    static bool suits(const CSRGraph&);
+
+//----------------------------------------------------------------------------
+// suggestDelta
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns the edge length below which about one edge per
+//                  node falls, at least 1
+    static int suggestDelta(const CSRGraph&);
+
+//----------------------------------------------------------------------------
+// setDelta
+// Preconditions:   None
+// Postconditions:  Later calls to solve use buckets of the given width, 0 or
+//                  less picks it with suggestDelta
+    void setDelta(int);
+
+//----------------------------------------------------------------------------
+// delta
+// Preconditions:   None
+// Postconditions:  Returns the bucket width used by the last solve
+    int delta() const;
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Delta buffer of the graph has been merged, source is in
+//                  the graph
+// Postconditions:  Shortest distance from the source to every node is found,
+//                  the nodes of each phase are spread over the pool when one
+//                  is given
+    void solve(const CSRGraph&, int, ThreadPool* = nullptr);
+
+//----------------------------------------------------------------------------
+// distance
+// Preconditions:   solve has been called, node is in range
+// Postconditions:  Returns the shortest distance from the source to the
+//                  node, INT_MAX if there is no path
+    int distance(int v) const {
+        return dist[v].load(memory_order_relaxed);
+    }
+
+//----------------------------------------------------------------------------
+// phases
+// Preconditions:   None
+// Postconditions:  Returns the phases run by the last solve
+    long phases() const;
+
+private:
+    static const int MAX_BUCKETS = 1 << 16; // size of the ring at most
+
+    struct alignas(64) Worker {
+        vector<int> lowered;        // nodes whose distance it lowered
+    };
+
+    int chosen;                     // delta asked for, 0 or less to suggest
+    int width;                      // delta of the last solve
+    int nodes;                      // number of nodes of the graph
+    long phaseCount;                // phases of the last solve
+    long stamp;                     // phases of every solve so far
+    unique_ptr<atomic<int>[]> dist; // distance from the source
+    vector<vector<int>> buckets;    // ring of nodes by distance / width
+    vector<int> frontier;           // nodes of the current phase
+    vector<int> done;               // nodes taken from the current bucket
+    vector<long> taken;             // stamp of the phase that last took a node
+    vector<Worker> workers;         // per-worker lists
+
+//----------------------------------------------------------------------------
+// relax
+// Preconditions:   Node list is not changed while the phase runs
+// Postconditions:  Edges out of every node of the list that are light, or
+//                  heavy, are relaxed, lowered nodes are in the workers'
+//                  lists
+    void relax(const CSRGraph&, const vector<int>&, bool, ThreadPool*);
+
+//----------------------------------------------------------------------------
+// place
+// Preconditions:   Ring is the number of buckets
+// Postconditions:  Nodes in the workers' lists are in the buckets of their
+//                  distances, the lists are empty, returns the entries added
+    long place(int);
+};
+
+#endif
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+// DHEAP.H
+// Template class for an indexed d-ary min heap
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// DHeap: priority queue of vertex ids keyed by distance
+// and allows other features:
+//      --insertion of a vertex, or lowering the key of a vertex already held
+//        (decrease-key) through a single update call
+//      --removal of the vertex with the minimum key
+//      --peeking at the minimum key
+//
+// Implementation and assumptions:
+//      --the heap is stored in an array, each node has D children
+//      --a position array maps each vertex id to its slot in the heap so
+//        decrease-key does not have to search for the vertex
+//      --ties between equal keys are broken by the lower vertex id, this
+//        matches the order GraphM::findV picks vertices in
+//      --vertex ids are assumed to be in the range 0 to n given to reset
+//      --D = 2 gives a binary heap, D = 4 gives a 4-ary heap
+//----------------------------------------------------------------------------
+
+#ifndef DHEAP_H
+#define DHEAP_H
+
+#include <vector>
+
+using namespace std;
+
+template <int D>
+class DHeap {
+public:
+//----------------------------------------------------------------------------
+// reset
+// Preconditions:   None
+// Postconditions:  Heap is emptied and can hold vertex ids 0 to n
+    void reset(int n) {
+        heap.clear();
+        pos.assign(n + 1, -1);
+        key.resize(n + 1);
+    }
+
+//----------------------------------------------------------------------------
+// resize
+// Preconditions:   Heap is empty
+// Postconditions:  Heap can hold vertex ids 0 to n, nothing is cleared so
+//                  this is constant time when it already could
+    void resize(int n) {
+        if((int)pos.size() < n + 1) {
+            pos.resize(n + 1, -1);
+            key.resize(n + 1);
+        }
+    }
+
+//----------------------------------------------------------------------------
+// empty
+// Preconditions:   None
+// Postconditions:  Returns true if no vertices are held in the heap
+    bool empty() const {
+        return heap.empty();
+    }
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Heap is emptied, only the vertices held are touched so
+//                  this is not linear in n
+    void clear() {
+        for(int v : heap) {
+            pos[v] = -1;
+        }
+        heap.clear();
+    }
+
+//----------------------------------------------------------------------------
+// topKey
+// Preconditions:   Heap is not empty
+// Postconditions:  Returns the minimum key, the heap is unchanged
+    int topKey() const {
+        return key[heap[0]];
+    }
+
+//----------------------------------------------------------------------------
+// update
+// Preconditions:   k is not greater than the key currently held for v
+// Postconditions:  v is inserted with key k, or its key is lowered to k if v
+//                  is already in the heap
+    void update(int v, int k) {
+        key[v] = k;
+        if(pos[v] == -1) {
+            pos[v] = heap.size();
+            heap.push_back(v);
+        }
+        siftUp(pos[v]);
+    }
+
+//----------------------------------------------------------------------------
+// pop
+// Preconditions:   Heap is not empty
+// Postconditions:  Vertex with the minimum key is removed and returned
+    int pop() {
+        int top = heap[0];
+        pos[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if(!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    vector<int> heap;   // vertex ids in heap order
+    vector<int> pos;    // slot of each vertex in heap, -1 if not held
+    vector<int> key;    // key of each vertex
+
+//----------------------------------------------------------------------------
+// less
+// Preconditions:   None
+// Postconditions:  Returns true if vertex a comes before vertex b
+    bool less(int a, int b) const {
+        return key[a] < key[b] || (key[a] == key[b] && a < b);
+    }
+
+//----------------------------------------------------------------------------
+// siftUp
+// Preconditions:   i is a valid slot in the heap
+// Postconditions:  Vertex at slot i is moved up until its parent is lower
+    void siftUp(int i) {
+        int v = heap[i];
+        while(i > 0) {
+            int parent = (i - 1) / D;
+            if(!less(v, heap[parent])) {
+                break;
+            }
+            heap[i] = heap[parent];
+            pos[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+//----------------------------------------------------------------------------
+// siftDown
+// Preconditions:   i is a valid slot in the heap
+// Postconditions:  Vertex at slot i is moved down until its children are
+//                  all higher
+    void siftDown(int i) {
+        int v = heap[i];
+        int n = heap.size();
+        for(;;) {
+            int first = i * D + 1;
+            if(first >= n) {
+                break;
+            }
+            int best = first;
+            int end = first + D < n ? first + D : n;
+            for(int c = first + 1; c < end; c++) {
+                if(less(heap[c], heap[best])) {
+                    best = c;
+                }
+            }
+            if(!less(heap[best], v)) {
+                break;
+            }
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+};
+
+typedef DHeap<2> BinaryHeap;
+typedef DHeap<4> FourAryHeap;
+
+#endif
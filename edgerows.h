@@ -0,0 +1,45 @@
+//----------------------------------------------------------------------------
+// EDGEROWS.H
+// Struct for a view of the edges of a directed graph in compressed sparse rows
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// EdgeRows: the edges of every node of a graph, held elsewhere
+// and allows other features:
+//      --walking the edges of a node as a range of indices into targets
+//      --counting the edges of a node, or of the whole graph
+//
+// Implementation and assumptions:
+//      --only points at arrays held by their owner, such as the edge arrays
+//        of a GraphL, and is valid while they are not changed
+//      --offsets holds node count + 2 entries, the edges of node v are
+//        targets[offsets[v]] up to targets[offsets[v + 1]], the other end
+//        of each edge, for the reverse of a graph the node each edge is from
+//      --node ids are in the range 1 to the node count, node 0 is not used
+//        and never has edges
+//----------------------------------------------------------------------------
+
+#ifndef EDGEROWS_H
+#define EDGEROWS_H
+
+struct EdgeRows {
+    int nodes;              // number of nodes
+    const int* offsets;     // where each node's edges begin, nodes + 2
+    const int* targets;     // other end of each edge
+
+//----------------------------------------------------------------------------
+// begin, end
+// Preconditions:   v is in the range 0 to the node count
+// Postconditions:  Returns the index of the first edge of v, and one past
+//                  its last
+    int begin(int v) const { return offsets[v]; }
+    int end(int v) const { return offsets[v + 1]; }
+
+//----------------------------------------------------------------------------
+// degree, edgeCount
+// Preconditions:   v is in the range 0 to the node count
+// Postconditions:  Returns the number of edges of v, and of every node
+    int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+    int edgeCount() const { return offsets[nodes + 1]; }
+};
+
+#endif
@@ -0,0 +1,260 @@
+//----------------------------------------------------------------------------
+// FLOYDWARSHALL.CPP
+// Implementation for FloydWarshall Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// FloydWarshall: shortest distance between every pair of nodes of a graph
+// and allows other features:
+//      --running on several threads through a ThreadPool
+//      --choice of the min-plus kernel, AVX2, SSE4.1 or plain C++, the best
+//        one the CPU supports is picked when the program runs
+//      --lookup of the distance between 2 nodes once solved
+//
+// Implementation and assumptions:
+//      --the distances are a copy of the edge lengths cut into square tiles
+//        of TILE x TILE, each tile contiguous in memory, so the 3 tiles the
+//        kernel works on at once stay in the cache
+//      --each round handles one diagonal tile, then the tiles in its row and
+//        column, then every other tile, the tiles of a step are independent
+//        so they are spread over the threads
+//      --the SIMD kernels are compiled for their instruction set with a
+//        target attribute, so the rest of the program needs no extra flags,
+//        they are only built for x86 with g++ or clang
+//      --missing edges are held as INF, which is small enough that INF + INF
+//        does not overflow, so distances must be below INF
+//      --edge lengths are assumed to be positive, suits checks for this
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "floydwarshall.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FLOYDWARSHALL_X86
+#include <immintrin.h>
+#endif
+
+const int FloydWarshall::INF;
+
+//----------------------------------------------------------------------------
+// relaxScalar
+// Preconditions:   Tiles hold N x N entries, the diagonal of the tile shared
+//                  by a and b, if any, is 0
+// Postconditions:  Every entry (i, j) of c is lowered to a(i, k) + b(k, j) if
+//                  that is shorter, for each k in order
+template <int N>
+static void relaxScalar(int* c, const int* a, const int* b) {
+    for(int k = 0; k < N; k++) {
+        const int* bk = b + k * N;
+        for(int i = 0; i < N; i++) {
+            int aik = a[i * N + k];
+            int* ci = c + i * N;
+            for(int j = 0; j < N; j++) {
+                int through = aik + bk[j];
+                if(through < ci[j]) {
+                    ci[j] = through;
+                }
+            }
+        }
+    }
+}
+
+#ifdef FLOYDWARSHALL_X86
+//----------------------------------------------------------------------------
+// relaxSse4
+// Preconditions:   Same as relaxScalar, N is a multiple of 4, CPU has SSE4.1
+// Postconditions:  Same as relaxScalar, 4 entries at a time
+template <int N>
+__attribute__((target("sse4.1")))
+static void relaxSse4(int* c, const int* a, const int* b) {
+    for(int k = 0; k < N; k++) {
+        const int* bk = b + k * N;
+        for(int i = 0; i < N; i++) {
+            __m128i aik = _mm_set1_epi32(a[i * N + k]);
+            int* ci = c + i * N;
+            for(int j = 0; j < N; j += 4) {
+                __m128i through = _mm_add_epi32(aik,
+                    _mm_loadu_si128((const __m128i*)(bk + j)));
+                __m128i old = _mm_loadu_si128((const __m128i*)(ci + j));
+                _mm_storeu_si128((__m128i*)(ci + j),
+                                 _mm_min_epi32(old, through));
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// relaxAvx2
+// Preconditions:   Same as relaxScalar, N is a multiple of 8, CPU has AVX2
+// Postconditions:  Same as relaxScalar, 8 entries at a time
+template <int N>
+__attribute__((target("avx2")))
+static void relaxAvx2(int* c, const int* a, const int* b) {
+    for(int k = 0; k < N; k++) {
+        const int* bk = b + k * N;
+        for(int i = 0; i < N; i++) {
+            __m256i aik = _mm256_set1_epi32(a[i * N + k]);
+            int* ci = c + i * N;
+            for(int j = 0; j < N; j += 8) {
+                __m256i through = _mm256_add_epi32(aik,
+                    _mm256_loadu_si256((const __m256i*)(bk + j)));
+                __m256i old = _mm256_loadu_si256((const __m256i*)(ci + j));
+                _mm256_storeu_si256((__m256i*)(ci + j),
+                                    _mm256_min_epi32(old, through));
+            }
+        }
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is solved, the kernel is the best one supported
+FloydWarshall::FloydWarshall() {
+    kernel = bestKernel();
+    nodes = 0;
+    tiles = 0;
+}
+
+//----------------------------------------------------------------------------
+// suits
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns true if every edge length is positive and no
+//                  path can reach INF, so the distances found are exact
+bool FloydWarshall::suits(const CSRGraph& g) {
+    long long longest = 0;
+    for(int v = 1; v <= g.nodeCount(); v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            if(g.weight(e) <= 0) {
+                return false;
+            }
+            if(g.weight(e) > longest) {
+                longest = g.weight(e);
+            }
+        }
+    }
+    // A shortest path has at most nodes - 1 edges
+    return longest * g.nodeCount() < INF;
+}
+
+//----------------------------------------------------------------------------
+// bestKernel
+// Preconditions:   None
+// Postconditions:  Returns the fastest kernel the CPU supports
+FloydWarshall::Kernel FloydWarshall::bestKernel() {
+#ifdef FLOYDWARSHALL_X86
+    if(__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.1")) {
+        return SSE4;
+    }
+#endif
+    return SCALAR;
+}
+
+//----------------------------------------------------------------------------
+// setKernel
+// Preconditions:   None
+// Postconditions:  Later calls to solve use the given kernel, or the best
+//                  supported one if the CPU does not support it
+void FloydWarshall::setKernel(Kernel k) {
+    Kernel best = bestKernel();
+    kernel = k > best ? best : k;
+}
+
+//----------------------------------------------------------------------------
+// kernelName
+// Preconditions:   None
+// Postconditions:  Returns the name of the kernel solve uses
+const char* FloydWarshall::kernelName() const {
+    if(kernel == AVX2) {
+        return "avx2";
+    }
+    if(kernel == SSE4) {
+        return "sse4.1";
+    }
+    return "scalar";
+}
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Delta buffer of the graph has been merged, suits is true
+// Postconditions:  Shortest distance between every pair of nodes is found,
+//                  the tiles are spread over the pool when one is given
+void FloydWarshall::solve(const CSRGraph& g, ThreadPool* pool) {
+    nodes = g.nodeCount();
+    tiles = (nodes + TILE - 1) / TILE;
+    int padded = tiles * TILE;
+
+    // Copy the edge lengths, padding nodes are only reachable from themselves
+    dist.assign((size_t)padded * padded, INF);
+    for(int v = 0; v < padded; v++) {
+        dist[slot(v, v)] = 0;
+    }
+    for(int v = 1; v <= nodes; v++) {
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            if(g.target(e) != v) {
+                dist[slot(v - 1, g.target(e) - 1)] = g.weight(e);
+            }
+        }
+    }
+
+    // Runs step(index) for every index below count, on the pool if any
+    auto each = [pool](int count, const function<void(int)>& step) {
+        if(pool == nullptr) {
+            for(int t = 0; t < count; t++) {
+                step(t);
+            }
+            return;
+        }
+        pool->parallelFor(0, count, 1, [&step](int t, int) { step(t); });
+    };
+
+    for(int k = 0; k < tiles; k++) {
+        int* diagonal = tile(k, k);
+        relax(diagonal, diagonal, diagonal);
+
+        // Tiles in the diagonal tile's row and column only need it
+        each(2 * tiles, [&](int t) {
+            int other = t / 2;
+            if(other == k) {
+                return;
+            }
+            if(t % 2 == 0) {
+                relax(tile(k, other), diagonal, tile(k, other));
+            }
+            else {
+                relax(tile(other, k), tile(other, k), diagonal);
+            }
+        });
+
+        // Every other tile needs the row and column tiles just finished
+        each(tiles * tiles, [&](int t) {
+            int r = t / tiles;
+            int c = t % tiles;
+            if(r != k && c != k) {
+                relax(tile(r, c), tile(r, k), tile(k, c));
+            }
+        });
+    }
+}
+
+//----------------------------------------------------------------------------
+// relax
+// Preconditions:   Tiles are in dist
+// Postconditions:  Every entry (i, j) of tile c is lowered to a(i, k) +
+//                  b(k, j) if that is shorter, for each k of the tiles
+void FloydWarshall::relax(int* c, const int* a, const int* b) const {
+#ifdef FLOYDWARSHALL_X86
+    if(kernel == AVX2) {
+        relaxAvx2<TILE>(c, a, b);
+        return;
+    }
+    if(kernel == SSE4) {
+        relaxSse4<TILE>(c, a, b);
+        return;
+    }
+#endif
+    relaxScalar<TILE>(c, a, b);
+}
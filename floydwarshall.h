@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+// FLOYDWARSHALL.H
+// Class for all pairs shortest distances by blocked Floyd-Warshall
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// FloydWarshall: shortest distance between every pair of nodes of a graph
+// and allows other features:
+//      --running on several threads through a ThreadPool
+//      --choice of the min-plus kernel, AVX2, SSE4.1 or plain C++, the best
+//        one the CPU supports is picked when the program runs
+//      --lookup of the distance between 2 nodes once solved
+//
+// Implementation and assumptions:
+//      --the distances are a copy of the edge lengths cut into square tiles
+//        of TILE x TILE, each tile contiguous in memory, so the 3 tiles the
+//        kernel works on at once stay in the cache
+//      --each round handles one diagonal tile, then the tiles in its row and
+//        column, then every other tile, the tiles of a step are independent
+//        so they are spread over the threads
+//      --missing edges are held as INF, which is small enough that INF + INF
+//        does not overflow, so distances must be below INF
+//      --edge lengths are assumed to be positive, suits checks for this
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef FLOYDWARSHALL_H
+#define FLOYDWARSHALL_H
+
+#include "csrgraph.h"
+#include "threadpool.h"
+#include <climits>
+#include <vector>
+
+using namespace std;
+
+class FloydWarshall {
+public:
+    // Min-plus kernel used on each tile
+    enum Kernel { SCALAR, SSE4, AVX2 };
+
+    // Largest distance that can be held, missing edges are stored as this
+    static const int INF = INT_MAX / 2;
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Nothing is solved, the kernel is the best one supported
+    FloydWarshall();
+
+//----------------------------------------------------------------------------
+// suits
+// Preconditions:   Delta buffer of the graph has been merged
+// Postconditions:  Returns true if every edge length is positive and no
+//                  path can reach INF, so the distances found are exact
+    static bool suits(const CSRGraph&);
+
+//----------------------------------------------------------------------------
+// bestKernel
+// Preconditions:   None
+// Postconditions:  Returns the fastest kernel the CPU supports
+    static Kernel bestKernel();
+
+//----------------------------------------------------------------------------
+// setKernel
+// Preconditions:   None
+// Postconditions:  Later calls to solve use the given kernel, or the best
+//                  supported one if the CPU does not support it
+    void setKernel(Kernel);
+
+//----------------------------------------------------------------------------
+// kernelName
+// Preconditions:   None
+// Postconditions:  Returns the name of the kernel solve uses
+    const char* kernelName() const;
+
+//----------------------------------------------------------------------------
+// solve
+// Preconditions:   Delta buffer of the graph has been merged, suits is true
+// Postconditions:  Shortest distance between every pair of nodes is found,
+//                  the tiles are spread over the pool when one is given
+    void solve(const CSRGraph&, ThreadPool* = nullptr);
+
+//----------------------------------------------------------------------------
+// distance
+// Preconditions:   solve has been called, nodes are in range
+// Postconditions:  Returns the shortest distance from node 1 to node 2,
+//                  INT_MAX if there is no path
+    int distance(int from, int to) const {
+        int d = dist[slot(from - 1, to - 1)];
+        return d >= INF ? INT_MAX : d;
+    }
+
+private:
+    static const int TILE = 64;     // rows and columns of a tile
+
+    Kernel kernel;                  // min-plus kernel used by solve
+    int nodes;                      // number of nodes solved for
+    int tiles;                      // tiles along each side of the matrix
+    vector<int> dist;               // distances, tile by tile
+
+//----------------------------------------------------------------------------
+// slot
+// Preconditions:   Row and column are in the padded matrix
+// Postconditions:  Returns the index in dist of the entry
+    size_t slot(int r, int c) const {
+        size_t tile = (size_t)(r / TILE) * tiles + c / TILE;
+        return tile * TILE * TILE + (r % TILE) * TILE + c % TILE;
+    }
+
+//----------------------------------------------------------------------------
+// tile
+// Preconditions:   Tile row and column are below tiles
+// Postconditions:  Returns the first entry of the tile
+    int* tile(int r, int c) {
+        return &dist[((size_t)r * tiles + c) * TILE * TILE];
+    }
+
+//----------------------------------------------------------------------------
+// relax
+// Preconditions:   Tiles are in dist
+// Postconditions:  Every entry (i, j) of tile c is lowered to a(i, k) +
+//                  b(k, j) if that is shorter, for each k of the tiles
+    void relax(int*, const int*, const int*) const;
+};
+
+#endif
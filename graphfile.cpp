@@ -0,0 +1,225 @@
+//----------------------------------------------------------------------------
+// GRAPHFILE.CPP
+// Implementation for GraphFile Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// GraphFile: reads graphs in the text format buildGraph takes
+// and allows other features:
+//      --mapping a whole file into memory, or reading text already in memory
+//      --reading the node count, label lines, and edges of one graph after
+//        another, as GraphM and GraphL read them from an istream
+//      --counts of the bytes read, to measure the speed of a load
+//
+// Implementation and assumptions:
+//      --the file is mapped read only with mmap, so it is never copied and
+//        the kernel reads it ahead while it is parsed
+//      --integers are read by a scanner that only knows spaces, signs and
+//        digits, no locale and no virtual calls per token
+//      --the ends of lines are found with memchr, which the C library does
+//        16 or 32 bytes at a time with SIMD
+//      --labels are returned as views of the text, nothing is allocated
+//      --text that is not a number where one is expected, or a number that
+//        does not fit an int, ends the graph, as a failed >> would
+//      --a graph is the node count on its own line, a label line for each
+//        node, then i j k edges ending with 0 0 0 (GraphM) or i j edges
+//        ending with 0 0 (GraphL), any number of graphs follow each other
+//----------------------------------------------------------------------------
+
+#include "graphfile.h"
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No text is held
+GraphFile::GraphFile()
+    : text(nullptr), at(nullptr), end(nullptr), mapped(nullptr),
+      mappedBytes(0) {
+}
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  File is unmapped
+GraphFile::~GraphFile() {
+    close();
+}
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   None
+// Postconditions:  Returns true and holds the whole file if it could be
+//                  mapped, an empty file holds no text, returns false if it
+//                  could not be opened
+bool GraphFile::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap of 0 bytes fails, an empty file simply holds no graphs
+    if(info.st_size > 0) {
+        void* start = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd,
+                           0);
+        if(start == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        madvise(start, info.st_size, MADV_SEQUENTIAL);
+        mapped = start;
+        mappedBytes = info.st_size;
+        attach((const char*)start, info.st_size);
+    }
+    ::close(fd);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Text outlives its use by this object
+// Postconditions:  Given number of characters of the text are held, as if
+//                  they were a file
+void GraphFile::attach(const char* start, size_t length) {
+    text = start;
+    at = start;
+    end = start + length;
+}
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No text is held, a mapped file is unmapped
+void GraphFile::close() {
+    if(mapped != nullptr) {
+        munmap(mapped, mappedBytes);
+    }
+    mapped = nullptr;
+    mappedBytes = 0;
+    text = at = end = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// readCount
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameter to the next integer,
+//                  the rest of its line is skipped, returns false if there
+//                  is none
+bool GraphFile::readCount(int& count) {
+    if(!readInt(count)) {
+        return false;
+    }
+    skipLine();
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// readLabel
+// Preconditions:   None
+// Postconditions:  Returns the text up to the end of the line, which is
+//                  skipped, as getline would, valid while the text is held
+string_view GraphFile::readLabel() {
+    const char* stop = at == end ? end
+                                 : (const char*)memchr(at, '\n', end - at);
+    if(stop == nullptr) {
+        stop = end;
+    }
+    string_view line(at, stop - at);
+    at = stop == end ? end : stop + 1;
+    return line;
+}
+
+//----------------------------------------------------------------------------
+// readEdge
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameters to the next i j k
+//                  edge, returns false if it is 0 0 0 or the text ends
+bool GraphFile::readEdge(int& from, int& to, int& length) {
+    if(!readInt(from) || !readInt(to)) {
+        return false;
+    }
+    if(from == 0 && to == 0) {
+        int garbage;
+        readInt(garbage);
+        return false;
+    }
+    return readInt(length);
+}
+
+//----------------------------------------------------------------------------
+// readPair
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameters to the next i j
+//                  edge, returns false if it is 0 0 or the text ends
+bool GraphFile::readPair(int& from, int& to) {
+    if(!readInt(from) || !readInt(to)) {
+        return false;
+    }
+    return from != 0 || to != 0;
+}
+
+//----------------------------------------------------------------------------
+// bytesRead, size
+// Preconditions:   None
+// Postconditions:  Returns the bytes read so far, and the bytes held
+size_t GraphFile::bytesRead() const {
+    return at - text;
+}
+size_t GraphFile::size() const {
+    return end - text;
+}
+
+//----------------------------------------------------------------------------
+// readInt
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameter to the next integer
+//                  after any spaces, returns false if there is none or it
+//                  does not fit an int
+bool GraphFile::readInt(int& value) {
+    // Space, \t, \n, \v, \f and \r, as the default locale skips
+    while(at < end && (*at == ' ' || (unsigned char)(*at - '\t') < 5)) {
+        at++;
+    }
+    bool negative = at < end && *at == '-';
+    if(at < end && (*at == '-' || *at == '+')) {
+        at++;
+    }
+    const char* first = at;
+    unsigned int most = negative ? (unsigned int)INT_MAX + 1 : INT_MAX;
+    unsigned int number = 0;
+    while(at < end && (unsigned char)(*at - '0') < 10) {
+        unsigned int digit = *at - '0';
+        if(number > (most - digit) / 10) {
+            return false;           // out of range, as operator>> fails
+        }
+        number = number * 10 + digit;
+        at++;
+    }
+    if(at == first) {
+        return false;
+    }
+    value = negative ? (int)-(long long)number : (int)number;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// skipLine
+// Preconditions:   None
+// Postconditions:  Text up to and including the next end of line is read
+void GraphFile::skipLine() {
+    if(at == end) {
+        return;
+    }
+    const char* stop = (const char*)memchr(at, '\n', end - at);
+    at = stop == nullptr ? end : stop + 1;
+}
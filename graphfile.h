@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+// GRAPHFILE.H
+// Class for reading the graph text format from a memory mapped file
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// GraphFile: reads graphs in the text format buildGraph takes
+// and allows other features:
+//      --mapping a whole file into memory, or reading text already in memory
+//      --reading the node count, label lines, and edges of one graph after
+//        another, as GraphM and GraphL read them from an istream
+//      --counts of the bytes read, to measure the speed of a load
+//
+// Implementation and assumptions:
+//      --the file is mapped read only with mmap, so it is never copied and
+//        the kernel reads it ahead while it is parsed
+//      --integers are read by a scanner that only knows spaces, signs and
+//        digits, no locale and no virtual calls per token
+//      --the ends of lines are found with memchr, which the C library does
+//        16 or 32 bytes at a time with SIMD
+//      --labels are returned as views of the text, nothing is allocated
+//      --text that is not a number where one is expected, or a number that
+//        does not fit an int, ends the graph, as a failed >> would
+//      --a graph is the node count on its own line, a label line for each
+//        node, then i j k edges ending with 0 0 0 (GraphM) or i j edges
+//        ending with 0 0 (GraphL), any number of graphs follow each other
+//----------------------------------------------------------------------------
+
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+class GraphFile {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No text is held
+    GraphFile();
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  File is unmapped
+    ~GraphFile();
+
+    GraphFile(const GraphFile&) = delete;
+    GraphFile& operator=(const GraphFile&) = delete;
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   None
+// Postconditions:  Returns true and holds the whole file if it could be
+//                  mapped, an empty file holds no text, returns false if it
+//                  could not be opened
+    bool open(const string&);
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Text outlives its use by this object
+// Postconditions:  Given number of characters of the text are held, as if
+//                  they were a file
+    void attach(const char*, size_t);
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No text is held, a mapped file is unmapped
+    void close();
+
+//----------------------------------------------------------------------------
+// readCount
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameter to the next integer,
+//                  the rest of its line is skipped, returns false if there
+//                  is none
+    bool readCount(int&);
+
+//----------------------------------------------------------------------------
+// readLabel
+// Preconditions:   None
+// Postconditions:  Returns the text up to the end of the line, which is
+//                  skipped, as getline would, valid while the text is held
+    string_view readLabel();
+
+//----------------------------------------------------------------------------
+// readEdge
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameters to the next i j k
+//                  edge, returns false if it is 0 0 0 or the text ends
+    bool readEdge(int&, int&, int&);
+
+//----------------------------------------------------------------------------
+// readPair
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameters to the next i j
+//                  edge, returns false if it is 0 0 or the text ends
+    bool readPair(int&, int&);
+
+//----------------------------------------------------------------------------
+// bytesRead, size
+// Preconditions:   None
+// Postconditions:  Returns the bytes read so far, and the bytes held
+    size_t bytesRead() const;
+    size_t size() const;
+
+private:
+    const char* text;               // first character held
+    const char* at;                 // next character to read
+    const char* end;                // one past the last character
+    void* mapped;                   // start of the mapping, nullptr if none
+    size_t mappedBytes;             // length of the mapping
+
+//----------------------------------------------------------------------------
+// readInt
+// Preconditions:   None
+// Postconditions:  Returns true and sets the parameter to the next integer
+//                  after any spaces, returns false if there is none or it
+//                  does not fit an int
+    bool readInt(int&);
+
+//----------------------------------------------------------------------------
+// skipLine
+// Preconditions:   None
+// Postconditions:  Text up to and including the next end of line is read
+    void skipLine();
+};
+
+#endif
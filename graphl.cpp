@@ -5,7 +5,7 @@
 // Preconditions:   None
 // Postconditions:  Adjacency array is populated with nodes and their edges/data
 //                  size is set to the number of nodes in the Graph
-GraphL::GraphL() : size(0) {}
+GraphL::GraphL() : offsets(2, 0), size(0), threadCount(1) {}
 
 //----------------------------------------------------------------------------
 // buildGraph
@@ -16,7 +16,13 @@ void GraphL::buildGraph(istream& infile) {
    int fromNode, toNode;          // from and to node ends of edge
 
    infile >> size;                // read the number of nodes
-   if (infile.eof()) return;      // stop reading if no more data
+   bool negative = size < 0;      // not a graph, as in the GraphFile overload
+   if (negative) {
+      size = 0;
+      labels.clear();
+   }
+   resetEdges();
+   if (negative || infile.eof()) return;   // stop reading if no more data
    
    // explanation to student: when you want to read a string after an int, 
    // you must purge the rest of the int line or the end-of-line char will
@@ -25,18 +31,97 @@ void GraphL::buildGraph(istream& infile) {
    getline(infile, s);
 
    // read graph node information
+   labels.clear();
    for (int i=1; i <= size; i++) {
-       adjList[i].data.setData(infile);
+       s.clear();                 // left empty if the line cannot be read
+       getline(infile, s);
+       labels.add(s);
    }
 
-   // read the edge data and add to the adjacency list
+   // read the edge data, then place it in the edge arrays
+   vector<int> pairs;             // from and to node of each edge read
    for (;;) {
       infile >> fromNode >> toNode;
-      if (fromNode == 0 && toNode == 0) return;     // end of edge data
+      if (fromNode == 0 && toNode == 0) break;      // end of edge data
+      pairs.push_back(fromNode);
+      pairs.push_back(toNode);
+   }
+   placeEdges(pairs);
+}
 
-      // insert a valid edge into the adjacency list for fromNode
-      adjList[fromNode].edges.push_front(toNode);
+//----------------------------------------------------------------------------
+// buildGraph
+// Preconditions:   Text held by the GraphFile is formatted as detailed at the
+//                  top of this file
+// Postconditions:  Next graph of the file is read and Graph is filled with
+//                  its data, returns false and Graph is empty if the file
+//                  holds no more graphs
+bool GraphL::buildGraph(GraphFile& file) {
+   int fromNode, toNode;          // from and to node ends of edge
+   int count;                     // number of nodes read
+
+   // Left empty if the file holds no more graphs
+   size = 0;
+   resetEdges();
+   labels.clear();
+   if (!file.readCount(count) || count < 0) return false;   // no more data
+   size = count;
+
+   for (int i=1; i <= size; i++) {
+      labels.add(file.readLabel());
    }
+   vector<int> pairs;             // from and to node of each edge read
+   while (file.readPair(fromNode, toNode)) {
+      pairs.push_back(fromNode);
+      pairs.push_back(toNode);
+   }
+   placeEdges(pairs);
+   return true;
+}
+
+//----------------------------------------------------------------------------
+// saveSnapshot
+// Preconditions:   None
+// Postconditions:  Nodes, labels and edges are written to a snapshot file in
+//                  the order of the adjacency lists, returns false if it
+//                  could not be written
+bool GraphL::saveSnapshot(const string& path) const {
+   EdgeRows out = edges();
+   return GraphSnapshot::write(path, GraphSnapshot::LISTS, size,
+                               out.offsets, out.targets, nullptr, labels);
+}
+
+//----------------------------------------------------------------------------
+// loadSnapshot
+// Preconditions:   None
+// Postconditions:  Returns true and Graph holds the graph of the snapshot,
+//                  its edges and labels read in place from the mapped file,
+//                  the whole file is checked against its checksum if asked,
+//                  otherwise, or if it is a snapshot of a GraphM, returns
+//                  false and Graph is empty
+bool GraphL::loadSnapshot(const string& path, bool check) {
+   size = 0;
+   resetEdges();
+   labels.clear();
+
+   // A GraphM snapshot's weights would be misread as edges
+   shared_ptr<GraphSnapshot> file = make_shared<GraphSnapshot>();
+   if (!file->open(path, check) || file->kind() != GraphSnapshot::LISTS) {
+      return false;
+   }
+   size = file->nodeCount();
+   labels.attach(size, file->labelStarts(), file->labelText());
+   snapshot = file;               // kept mapped while edges and labels read it
+   return true;
+}
+
+//----------------------------------------------------------------------------
+// findNode
+// Preconditions:   None
+// Postconditions:  Returns the lowest node whose information is the
+//                  parameter, 0 if there is none
+int GraphL::findNode(string_view name) {
+   return labels.find(name);
 }
 
 //----------------------------------------------------------------------------
@@ -45,14 +130,35 @@ void GraphL::buildGraph(istream& infile) {
 // Postconditions:  Nodes, their information, and their edges are printed out to
 //                  the console
 void GraphL::displayGraph() {
-    cout << "Graph:" << endl;
+    OutputBuffer out(cout);
+    displayGraph(out);
+}
+
+//----------------------------------------------------------------------------
+// displayGraph
+// Preconditions:   None
+// Postconditions:  Same text displayGraph prints to the console is written to
+//                  the buffer and flushed
+void GraphL::displayGraph(OutputBuffer& out) {
+    EdgeRows rows = edges();
+    out.putText("Graph:\n");
     for(int i = 1; i <= size; i++) {
-        cout << "Node " << i << "\t\t" << adjList[i].data << endl;
-        for(int n : adjList[i].edges) {
-            cout << "    edge " << i << " " << n << endl;
+        out.putText("Node ");
+        out.putInt(i);
+        out.putText("\t\t");
+        out.putText(labels.label(i));
+        out.put('\n');
+        for(int e = rows.begin(i); e < rows.end(i); e++) {
+            int n = rows.targets[e];
+            out.putText("    edge ");
+            out.putInt(i);
+            out.put(' ');
+            out.putInt(n);
+            out.put('\n');
         }
     }
-    cout << endl;
+    out.put('\n');
+    out.flush();
 }
 
 //----------------------------------------------------------------------------
@@ -61,50 +167,213 @@ void GraphL::displayGraph() {
 // Postconditions:  A sequence of the nodes in the graph is printed out to the 
 //                  console as found in the depth-first search
 void GraphL::depthFirstSearch() {
-    // Create array to track which edges have been visited
-    bool* visited = new bool[size+1];
-    // Mark all vertices as not visited
-    for(int i = 0; i < size+1; i++) {
-        visited[i] = false;
+    OutputBuffer out(cout);
+    depthFirstSearch(out);
+}
+
+//----------------------------------------------------------------------------
+// depthFirstSearch
+// Preconditions:   None
+// Postconditions:  Same text depthFirstSearch prints to the console is
+//                  written to the buffer and flushed
+void GraphL::depthFirstSearch(OutputBuffer& out) {
+    out.putText("Depth-first ordering: ");
+    for(int v : depthFirstOrder()) {
+        out.putInt(v);
+        out.put(' ');
     }
+    out.putText("\n\n");
+    out.flush();
+}
+
+//----------------------------------------------------------------------------
+// depthFirstOrder
+// Preconditions:   None
+// Postconditions:  Returns the nodes in the order depthFirstSearch prints
+//                  them, valid until the next search or build
+const vector<int>& GraphL::depthFirstOrder() {
+    EdgeRows rows = edges();
+    visited.resize(size + 1);
+    order.clear();
+    frames.clear();
 
-    // Queue to store nodes found in the search
-    queue<int> visitedNodes;
+    // For v = 1 to n, each unvisited node starts a search of its own
+    for(int i = 1; i <= size; i++) {
+        if(visited.test(i)) {
+            continue;
+        }
+        visited.set(i);
+        order.push_back(i);
+        frames.push_back(SearchFrame{i, rows.begin(i)});
 
-    // For v = 1 to n
-    for(int i = 1; i <=size; i++) {
-        if(!visited[i]) {
-            dfsHelper(i, visited, visitedNodes);
+        // The top frame follows its next unvisited edge, as the recursive
+        // search would call itself on it, and is popped once it has none
+        while(!frames.empty()) {
+            SearchFrame& top = frames.back();
+            int end = rows.end(top.node);
+            while(top.next < end && visited.test(rows.targets[top.next])) {
+                top.next++;
+            }
+            if(top.next == end) {
+                frames.pop_back();
+                continue;
+            }
+            int w = rows.targets[top.next++];
+            visited.set(w);
+            order.push_back(w);
+            frames.push_back(SearchFrame{w, rows.begin(w)});
         }
     }
+    return order;
+}
 
-    cout << "Depth-first ordering: ";
-    while(!visitedNodes.empty()) {
-        cout << visitedNodes.front() << " ";
-        visitedNodes.pop();
+//----------------------------------------------------------------------------
+// breadthFirstSearch
+// Preconditions:   None
+// Postconditions:  Returns true and the search holds the hop level and
+//                  parent of every node from the source, found on
+//                  threadCount threads, returns false if the source is not
+//                  a node
+bool GraphL::breadthFirstSearch(int source, BreadthFirst& search) {
+    if(source < 1 || source > size) {
+        return false;
     }
-    cout << endl << endl;
+    reverseEdges();
+    EdgeRows out = edges();
+    EdgeRows in = { size, inOffsets.data(), sources.data() };
+    search.solve(out, in, source, workers());
+    return true;
+}
 
-    // De-allocate bool array
-    delete[] visited;
-    visited = nullptr;
+//----------------------------------------------------------------------------
+// strongComponents
+// Preconditions:   None
+// Postconditions:  Components hold the strongly connected component of
+//                  every node and the graph of the components, found on
+//                  threadCount threads when their method is parallel
+void GraphL::strongComponents(Components& found) {
+    reverseEdges();
+    EdgeRows out = edges();
+    EdgeRows in = { size, inOffsets.data(), sources.data() };
+    found.solve(out, in, workers());
 }
 
 //----------------------------------------------------------------------------
-// dfsHelper
+// setThreadCount
 // Preconditions:   None
-// Postconditions:  Bool array parameter is updated, current node is processed
-//                  by pushing it into the queue parameter 
-void GraphL::dfsHelper(int v, bool* visited, queue<int>& visitedNodes) {
-    // Mark v as visited
-    visited[v] = true;
-    // Add node to queue
-    visitedNodes.push(v);
+// Postconditions:  Later breadth-first searches and components spread their
+//                  work over the given number of threads, 0 or less uses
+//                  every hardware thread, the default is 1
+void GraphL::setThreadCount(int count) {
+    threadCount = count > 0 ? count : ThreadPool::hardwareThreads();
+}
 
-    // For each vertex w adjacent to v
-    for(int w : adjList[v].edges) {
-        if(!visited[w]) {
-            dfsHelper(w, visited, visitedNodes);
-        }
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the edge arrays and their
+//                  reverse, not counting a snapshot read in place
+size_t GraphL::memoryBytes() const {
+    return (offsets.capacity() + targets.capacity() + inOffsets.capacity() +
+            sources.capacity()) * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// resetEdges
+// Preconditions:   None
+// Postconditions:  Edge arrays hold size nodes and no edges, their reverse
+//                  is empty, a loaded snapshot is dropped with its labels
+void GraphL::resetEdges() {
+   if (snapshot) {
+      labels.clear();             // only after nothing reads the file
+      snapshot.reset();
+   }
+   offsets.assign(size + 2, 0);
+   targets.clear();
+   inOffsets.clear();
+}
+
+//----------------------------------------------------------------------------
+// edges
+// Preconditions:   None
+// Postconditions:  Returns the edge arrays, or those of the loaded snapshot
+EdgeRows GraphL::edges() const {
+   if (snapshot) {
+      return EdgeRows{ size, snapshot->offsets(), snapshot->targets() };
+   }
+   return EdgeRows{ size, offsets.data(), targets.data() };
+}
+
+//----------------------------------------------------------------------------
+// placeEdges
+// Preconditions:   Pairs holds the origin and destination of each edge, in
+//                  the order read
+// Postconditions:  Edge arrays hold the edges grouped by origin, each node's
+//                  edges in the reverse of the order read
+void GraphL::placeEdges(const vector<int>& pairs) {
+   // First pass counts each node's edges, then a running sum leaves
+   // offsets[v] at the end of the edges of v
+   offsets.assign(size + 2, 0);
+   inOffsets.clear();
+   for (size_t k = 0; k < pairs.size(); k += 2) {
+      int from = pairs[k], to = pairs[k + 1];
+      if (from >= 1 && from <= size && to >= 1 && to <= size) {
+         offsets[from]++;
+      }
+   }
+   for (int v = 1; v <= size + 1; v++) {
+      offsets[v] += offsets[v - 1];
+   }
+
+   // Second pass fills each node's edges from the end back, so the last
+   // edge read comes first and offsets[v] ends at their start
+   targets.resize(offsets[size + 1]);
+   for (size_t k = 0; k < pairs.size(); k += 2) {
+      int from = pairs[k], to = pairs[k + 1];
+      if (from >= 1 && from <= size && to >= 1 && to <= size) {
+         targets[--offsets[from]] = to;
+      }
+   }
+}
+
+//----------------------------------------------------------------------------
+// reverseEdges
+// Preconditions:   None
+// Postconditions:  Reverse edge arrays hold the edges into each node, by
+//                  origin, made now if they are empty
+void GraphL::reverseEdges() {
+   if (!inOffsets.empty()) {
+      return;
+   }
+
+   // Counted and placed as placeEdges does, origins in increasing order
+   EdgeRows out = edges();
+   inOffsets.assign(size + 2, 0);
+   for (int e = 0; e < out.edgeCount(); e++) {
+      inOffsets[out.targets[e]]++;
+   }
+   for (int v = 1; v <= size + 1; v++) {
+      inOffsets[v] += inOffsets[v - 1];
+   }
+   sources.resize(out.edgeCount());
+   for (int v = size; v >= 1; v--) {
+      for (int e = out.end(v) - 1; e >= out.begin(v); e--) {
+         sources[--inOffsets[out.targets[e]]] = v;
+      }
+   }
+}
+
+//----------------------------------------------------------------------------
+// workers
+// Preconditions:   None
+// Postconditions:  Returns the pool of threadCount workers, made now if
+//                  needed, nullptr when threadCount is 1
+ThreadPool* GraphL::workers() {
+    if(threadCount == 1) {
+        return nullptr;
     }
-}
\ No newline at end of file
+    if(!pool || pool->threadCount() != threadCount) {
+        pool = make_shared<ThreadPool>(threadCount);
+    }
+    return pool.get();
+}
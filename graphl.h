@@ -6,14 +6,45 @@
 // GraphM: stores nodes and edges
 // and allows other features:
 //      --allows the building of a Graph from an input file
+//      --allows graphs to be read from a memory mapped file with GraphFile
+//      --allows the graph to be saved as a binary snapshot and loaded back
+//      --allows a node to be found by its information
 //      --allows output of the nodes and edges in the Graph
-//      --allows a depth-first search to be performed on the Graph
+//      --allows a depth-first search to be performed on the Graph, its
+//        ordering can be printed or read into a caller's vector
+//      --allows a breadth-first search from a node, giving the hop level and
+//        parent of every node, run on several threads if asked
+//      --allows the strongly connected components to be found, with the
+//        graph of the components, which answers whether one node can reach
+//        another
 //
 // Implementation and assumptions:
-//      --uses an internal Struct, GraphNode to store data of which edges
-//        a node has as well as information on the node
-//      --uses an array of GraphNodes to hold data on every node in the Graph
-//      --does not allow more than 100 nodes to be held in a Graph
+//      --edges are held in compressed sparse rows: offsets holds where the
+//        edges of each node begin in targets, which holds the destination
+//        of every edge, so an edge takes 4 bytes instead of a list node and
+//        the edges of a node are read in one sweep of memory
+//      --buildGraph reads every edge first, then counts the edges of each
+//        node and places them, the last edge read for a node first, the
+//        order adding each to the front of a list would give, edges with a
+//        node out of range are ignored
+//      --arrays are sized from the node count read, so there is no limit on
+//        nodes, the information on the nodes is held end to end in a
+//        LabelStore, so copying a Graph copies it in one piece
+//      --output is written through an OutputBuffer, which sends it to cout
+//        in large pieces instead of flushing every line
+//      --the depth-first search keeps an explicit stack of (node, next edge)
+//        pairs instead of recursing, so a chain of millions of nodes cannot
+//        overflow the call stack, visited nodes are kept in a BitArray, and
+//        the stack, bits and ordering are reused from search to search
+//      --the breadth-first search and the components are found by a
+//        BreadthFirst or Components held by the caller, they read the edge
+//        arrays and the reverse of them, made the first time one is needed
+//        after the Graph is built, on a ThreadPool shared by copies of the
+//        Graph
+//      --a snapshot holds the same compressed sparse rows, so a loaded one
+//        is kept mapped and its edges and labels are read in place, shared
+//        by copies of the Graph, edges keep the order they had in the lists,
+//        building the Graph again drops the file
 //      --assumes the input file used to build the graph begins with a
 //        nonnegative integer n which denotes the number of nodes in the graph
 //      --assumes that following n, the input file then has node information
@@ -29,18 +60,19 @@
 #define GRAPHL_H
 
 #include "nodedata.h"
-#include <list>
-#include <queue>
+#include "outputbuffer.h"
+#include "graphfile.h"
+#include "graphsnapshot.h"
+#include "labelstore.h"
+#include "bitarray.h"
+#include "breadthfirst.h"
+#include "components.h"
+#include "threadpool.h"
+#include <memory>
+#include <vector>
 
 using namespace std;
 
-const int MAX_NODES = 100;
-
-struct GraphNode {
-    list<int> edges;    // List of edge nodes
-    NodeData data;      // Node's information
-};
-
 class GraphL {
     public:
 //----------------------------------------------------------------------------
@@ -57,6 +89,39 @@ class GraphL {
 // Postconditions:  istream is read and Graph is now filled with data on nodes
     void buildGraph(istream&);
 
+//----------------------------------------------------------------------------
+// buildGraph
+// Preconditions:   Text held by the GraphFile is formatted as detailed at the
+//                  top of this file
+// Postconditions:  Next graph of the file is read and Graph is filled with
+//                  its data, returns false and Graph is empty if the file
+//                  holds no more graphs
+    bool buildGraph(GraphFile&);
+
+//----------------------------------------------------------------------------
+// saveSnapshot
+// Preconditions:   None
+// Postconditions:  Nodes, labels and edges are written to a snapshot file in
+//                  the order of the adjacency lists, returns false if it
+//                  could not be written
+    bool saveSnapshot(const string&) const;
+
+//----------------------------------------------------------------------------
+// loadSnapshot
+// Preconditions:   None
+// Postconditions:  Returns true and Graph holds the graph of the snapshot,
+//                  the whole file is checked against its checksum if asked,
+//                  otherwise, or if it is a snapshot of a GraphM, returns
+//                  false and Graph is empty
+    bool loadSnapshot(const string&, bool = true);
+
+//----------------------------------------------------------------------------
+// findNode
+// Preconditions:   None
+// Postconditions:  Returns the lowest node whose information is the
+//                  parameter, 0 if there is none
+    int findNode(string_view);
+
 //----------------------------------------------------------------------------
 // displayGraph
 // Preconditions:   None
@@ -64,6 +129,13 @@ class GraphL {
 //                  the console
     void displayGraph();
 
+//----------------------------------------------------------------------------
+// displayGraph
+// Preconditions:   None
+// Postconditions:  Same text displayGraph prints to the console is written to
+//                  the buffer and flushed
+    void displayGraph(OutputBuffer&);
+
 //----------------------------------------------------------------------------
 // depthFirstSearch
 // Preconditions:   None
@@ -71,16 +143,106 @@ class GraphL {
 //                  console as found in the depth-first search
     void depthFirstSearch();
 
+//----------------------------------------------------------------------------
+// depthFirstSearch
+// Preconditions:   None
+// Postconditions:  Same text depthFirstSearch prints to the console is
+//                  written to the buffer and flushed
+    void depthFirstSearch(OutputBuffer&);
+
+//----------------------------------------------------------------------------
+// depthFirstOrder
+// Preconditions:   None
+// Postconditions:  Returns the nodes in the order depthFirstSearch prints
+//                  them, valid until the next search or build
+    const vector<int>& depthFirstOrder();
+
+//----------------------------------------------------------------------------
+// breadthFirstSearch
+// Preconditions:   None
+// Postconditions:  Returns true and the search holds the hop level and
+//                  parent of every node from the source, found on
+//                  threadCount threads, returns false if the source is not
+//                  a node
+    bool breadthFirstSearch(int, BreadthFirst&);
+
+//----------------------------------------------------------------------------
+// strongComponents
+// Preconditions:   None
+// Postconditions:  Components hold the strongly connected component of
+//                  every node and the graph of the components, found on
+//                  threadCount threads when their method is parallel
+    void strongComponents(Components&);
+
+//----------------------------------------------------------------------------
+// setThreadCount
+// Preconditions:   None
+// Postconditions:  Later breadth-first searches and components spread their
+//                  work over the given number of threads, 0 or less uses
+//                  every hardware thread, the default is 1
+    void setThreadCount(int);
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the edge arrays and their
+//                  reverse, not counting a snapshot read in place
+    size_t memoryBytes() const;
+
     private:
-        GraphNode adjList[MAX_NODES];  // Adjacency array
+        // Node whose edges the search is part way through
+        struct SearchFrame {
+            int node;                  // node being searched
+            int next;                  // first edge not yet followed
+        };
+
+        vector<int> offsets;           // where each node's edges begin, n + 2
+        vector<int> targets;           // destination of each edge
+        shared_ptr<GraphSnapshot> snapshot;  // file read in place, if loaded
+        vector<int> inOffsets;         // reverse of offsets, empty until made
+        vector<int> sources;           // origin of each edge, by destination
+        LabelStore labels;             // Each node's information
         int size;
+        BitArray visited;              // nodes found by the search
+        vector<SearchFrame> frames;    // stack of the search
+        vector<int> order;             // nodes in the order found
+        int threadCount;               // threads of breadthFirstSearch
+        shared_ptr<ThreadPool> pool;   // workers, made when threadCount > 1
+
+//----------------------------------------------------------------------------
+// resetEdges
+// Preconditions:   None
+// Postconditions:  Edge arrays hold size nodes and no edges, their reverse
+//                  is empty, a loaded snapshot is dropped with its labels
+        void resetEdges();
+
+//----------------------------------------------------------------------------
+// edges
+// Preconditions:   None
+// Postconditions:  Returns the edge arrays, or those of the loaded snapshot
+        EdgeRows edges() const;
+
+//----------------------------------------------------------------------------
+// placeEdges
+// Preconditions:   Pairs holds the origin and destination of each edge, in
+//                  the order read
+// Postconditions:  Edge arrays hold the edges grouped by origin, each node's
+//                  edges in the reverse of the order read
+        void placeEdges(const vector<int>&);
+
+//----------------------------------------------------------------------------
+// reverseEdges
+// Preconditions:   None
+// Postconditions:  Reverse edge arrays hold the edges into each node, by
+//                  origin, made now if they are empty
+        void reverseEdges();
 
 //----------------------------------------------------------------------------
-// dfsHelper
+// workers
 // Preconditions:   None
-// Postconditions:  Bool array parameter is updated, current node is processed
-//                  by pushing it into the queue parameter       
-        void dfsHelper(int, bool*, queue<int>&);
+// Postconditions:  Returns the pool of threadCount workers, made now if
+//                  needed, nullptr when threadCount is 1
+        ThreadPool* workers();
 };
 
 #endif
\ No newline at end of file
@@ -8,17 +8,141 @@
 //      --insertion of an individual Edge
 //      --removal of an individual Edge
 //      --allows Dijkstra's algorithm to be performed on the Graph
+//      --allows choice of the priority queue used by Dijkstra's algorithm
+//      --allows Dijkstra's algorithm to run on several threads at once
+//      --allows blocked Floyd-Warshall in place of Dijkstra's algorithm for
+//        dense graphs, chosen from the edge density and node count unless
+//        set
+//      --allows parallel delta-stepping in place of Dijkstra's algorithm for
+//        large sparse graphs, when set
+//      --allows lazy shortest paths, where each source's row is only found
+//        the first time it is asked for
+//      --keeps rows already found current when an edge is inserted or
+//        removed, without finding them again
 //      --allows output of shortest paths between every node in the Graph
 //      --allows more detailed output of shortest path between 2 specified
-//        nodes in the graph
+//        nodes in the graph, without the full table when it is not there
+//      --allows output to a buffer on a file descriptor or stream, with rows
+//        rendered on several threads
+//      --allows landmarks to be chosen and saved or loaded, for A* searches
+//        (ALT) in display
+//      --allows a contraction hierarchy to be built, for fast searches in
+//        display on large, mostly static graphs
+//      --allows a batch of pairs of nodes to be answered at once into a
+//        caller's buffer, with one search per distinct origin
+//      --allows the nodes of a shortest path to be read into a caller's
+//        vector
+//      --allows graphs to be read from a memory mapped file with GraphFile
+//      --allows the graph to be saved as a binary snapshot and loaded back
+//        with one mmap, the edges and labels are read where they lie in the
+//        file
+//      --allows a node to be found by its label
+//      --allows the table to be kept in a memory mapped file instead of
+//        memory, with narrower distances, and finished after a crash
 //
 // Implementation and assumptions:
-//      --uses an array of NodeData objects to store text information about the
-//        nodes
-//      --uses a 2D array (adjacency matrix) to hold the 'cost array' showing
-//        the length of edges between nodes in the graph
-//      --uses an internal struct TableType to store data used for Dijkstra's
-//        algorithm (a 2D array of these structs holds data for the whole graph)
+//      --uses a LabelStore to hold the text information about the nodes end
+//        to end in one arena, with a hash index from a label to its node
+//      --uses a CSRGraph (compressed sparse rows) to hold the length of edges
+//        between nodes in the graph, sized from the number of nodes and edges
+//        read by buildGraph, so memory grows with the edges instead of nodes^2
+//      --uses a PathRow per source to store data used for Dijkstra's
+//        algorithm (a vector of these rows holds data for the whole graph, it
+//        is only allocated once findShortestPath is called), each row keeps
+//        distances and previous nodes in separate arrays, previous nodes in
+//        16 bits when there are fewer than 65536 nodes
+//      --whether a node has been visited is only needed while its row is
+//        being searched, so it is kept in a per-worker BitArray, not the table
+//      --Dijkstra's algorithm runs once per source node, the next node is taken
+//        from a binary heap, a 4-ary heap, a pairing heap or a linear scan of
+//        the table (the heap type is a template parameter of the search)
+//      --each source only writes its own row of the table, so with more than
+//        one thread the sources are spread over a work-stealing ThreadPool,
+//        each worker has its own cache-line aligned heaps, and the table is
+//        identical to the one built on a single thread
+//      --Floyd-Warshall finds every distance at once (see FloydWarshall), each
+//        row's previous nodes are then taken from the distances, for a node
+//        the last node Dijkstra's algorithm would finish with an edge on a
+//        shortest path into it, so the table is identical to Dijkstra's
+//      --DELTA_STEPPING runs one source at a time with DeltaStepping, whose
+//        buckets of each source are spread over the threads, delta is set
+//        with setDelta or picked from the edge lengths, the previous nodes
+//        are then taken from the distances as for Floyd-Warshall
+//      --Floyd-Warshall and delta-stepping are only used when every edge
+//        length is positive, otherwise Dijkstra's algorithm runs even if it
+//        was asked for
+//      --in lazy mode the rows are kept in a RowCache (least recently used)
+//        sized from a memory budget instead of the full table, findShortestPath
+//        only empties the cache, and distance and displayAll run Dijkstra
+//        for a source the first time its row is needed, display only reads
+//        rows already cached and otherwise runs its own pair search
+//      --on insertEdge, a row only changes if the new edge shortens the path
+//        to its destination, the improvement is then spread from there with
+//        a small Dijkstra search
+//      --on removeEdge, a row only changes if the edge is in its shortest
+//        path tree, the subtree under the edge is cleared and found again from
+//        the edges into it (Ramalingam-Reps), using a reverse CSRGraph that is
+//        built on the first removal or display search and kept in step after
+//        that
+//      --repaired distances match a full recompute, on paths of equal length
+//        a repaired row may keep a different previous node
+//      --display uses the row of the table or cache when there is one,
+//        otherwise it runs a bidirectional Dijkstra search, forward from the
+//        origin over the cost array and backward from the destination over
+//        the reverse cost array, until the two searches meet
+//      --the forward search of display is then carried on, skipping nodes
+//        the backward search shows cannot be on a shortest path, until it
+//        finishes the destination, so the path printed is the same one the
+//        full table would hold
+//      --in LANDMARKS mode, display runs Dijkstra's algorithm from the origin
+//        instead, and skips expanding any node whose distance plus the
+//        landmark lower bound to the destination (see Landmarks) is more
+//        than the best known path, as A* would, but nodes still finish in
+//        Dijkstra's order so the path printed is the table's
+//      --landmarks only hold for the edges they were found on, buildGraph,
+//        insertEdge and removeEdge drop them, with none held the LANDMARKS
+//        search is plain Dijkstra stopped at the destination
+//      --in CONTRACTION mode, display asks the ContractionHierarchy for the
+//        path, which is a shortest path but on paths of equal length may not
+//        be the one the table holds, buildGraph, insertEdge and removeEdge
+//        drop the hierarchy and display uses the bidirectional search until
+//        it is built again
+//      --with a table file set, findShortestPath runs Dijkstra's algorithm
+//        per source as usual but stores each row into a PathTable and drops
+//        it, so only a row per worker is held in memory, displayAll, display,
+//        distance and path read rows where they lie in the mapping
+//      --the table file's key is a checksum of the cost array, a file left
+//        by a run on the same graph keeps its finished rows and only the
+//        rest are found, any other file is started over
+//      --rows are committed to the file a block at a time, a crash loses at
+//        most the block being found, a row whose distances do not fit the
+//        width is left out of the file and found when it is needed
+//      --insertEdge and removeEdge close the table file, until the next
+//        findShortestPath every row is found when it is needed
+//      --a copy of the graph does not share the open table file, until its
+//        own findShortestPath opens the file again every row is found when
+//        it is needed, a move takes the open file with it
+//      --findPairs sorts the pairs by origin, each origin uses its table or
+//        cache row if there is one, otherwise one Dijkstra search fills the
+//        worker's own row, which is kept between calls so its arrays are
+//        not allocated again, the paths of the origin's pairs are read off
+//        that row, rows found this way are not added to the cache
+//      --with the parallel option the origins are spread over threadCount
+//        workers, each worker writes its paths to its own buffer and they
+//        are copied into the caller's buffer in the order of the pairs
+//      --paths are walked back from the destination over the row's previous
+//        nodes into a vector whose memory is reused, so printing a path
+//        allocates nothing once the vector is big enough
+//      --output is formatted into an OutputBuffer (64 KB, digits and padding
+//        by hand) and sent to cout in large pieces, without a flush per line,
+//        displayAll can also write to any buffer, such as one on a file
+//        descriptor
+//      --a parallel displayAll renders blocks of sources on the workers, one
+//        memory buffer per source, and writes each block out in order, it
+//        needs the full table since the lazy cache is not thread safe
+//      --inserted and removed edges are buffered by the CSRGraph and merged
+//        into it before each search, so each node's edges are walked in
+//        O(degree)
 //      --builds the graph from an input text file
 //      --assumes that the 1st line of an input file has an int n denoting the 
 //        number of nodes in the graph
@@ -28,7 +152,6 @@
 //        int data in the form: i j k
 //        for each line of text where i is the origin node, j is the destination
 //        node, and k is the length of the edge
-//      --assumes a maximum of 100 nodes
 //      --assumes no 0 nodes
 //      --assumes that three zeros on a line is the end of the file
 //----------------------------------------------------------------------------
@@ -36,43 +159,52 @@
 
 #include "graphm.h"
 
+// AUTO picks Floyd-Warshall once the edge density times log2 of the node
+// count reaches this, per source Dijkstra's algorithm costs about edges
+// times log nodes and Floyd-Warshall about nodes^2, measured with
+// benchEngines in benchmark.cpp
+static const double FLOYD_WARSHALL_DENSITY = 0.07;
+
+// Sources rendered per worker between writes by a parallel displayAll, so
+// chunks are big enough to share out but the text held stays small
+static const int ROWS_PER_WORKER = 16;
+
+// Sources found per worker between commits to a table file, each commit
+// waits for the disk, and a crash loses at most one block of rows
+static const int TABLE_ROWS_PER_WORKER = 64;
+
 //----------------------------------------------------------------------------
 // Default constructor
 // Preconditions:   None
-// Postconditions:  Cost array and Dijkstra table are initalized with
-//                  infinite (INT_MAX) and 0 values, size is set to 0
+// Postconditions:  Graph has no edges and no Dijkstra table, size is set to 0
 GraphM::GraphM() {
     size = 0;
-    initC();
-    initT();
-}
-
-//----------------------------------------------------------------------------
-// initC
-// Preconditions:   Cost array holds either garbage data or data from a 
-//                  previously built graph
-// Postconditions:  Cost array is reset to only holding infinite values
-void GraphM::initC() {
-    for(int i = 0; i < MAXNODES; i++) {
-        for(int j = 0; j < MAXNODES; j++) {
-            C[i][j] = INT_MAX;
-        }
-    }
+    heapType = BINARY_HEAP;
+    engine = AUTO;
+    delta = 0;
+    threadCount = 1;
+    lazy = false;
+    rowBudget = DEFAULT_ROW_BUDGET;
+    tableWidth = 4;
+    resumed = 0;
+    haveReverse = false;
+    updateStats.rowsTouched = 0;
+    updateStats.entriesTouched = 0;
+    query.settled = 0;
+    pairType = BIDIRECTIONAL;
 }
 
 //----------------------------------------------------------------------------
 // initT
-// Preconditions:   Dijkstra table holds either garbage data or data from a 
-//                  previously built graph
-// Postconditions:  Dijkstra table is reset, all distances are set to infinity,
-//                  all visited are set to false, and all paths are set to 0
+// Preconditions:   Dijkstra table is empty or holds data from a previously
+//                  built graph
+// Postconditions:  Dijkstra table is sized for the graph and reset, all
+//                  distances are set to infinity except each source's
+//                  distance to itself, which is 0, and all paths are set to 0
 void GraphM::initT() {
-    for(int i = 0; i < MAXNODES; i++) {
-        for(int j = 0; j < MAXNODES; j++) {
-            T[i][j].dist = INT_MAX;
-            T[i][j].visited = false;
-            T[i][j].path = 0;
-        }
+    T.resize(size + 1);
+    for(int source = 0; source <= size; source++) {
+        T[source].reset(size, source);
     }
 }
 
@@ -83,11 +215,15 @@ void GraphM::initT() {
 // Postconditions:  istream is read and Graph is now filled with data on nodes
 void GraphM::buildGraph(istream& infile) {
     int fromNode, toNode;      // from and to node ends of edge
+    vector<Edge> edges;        // edges read, placed in the cost array at end
 
-    initC();                   // Set/reset cost array
-    initT();                   // Set/reset dijkstra array
+    resetGraph();
 
     infile >> size;            // read the number of nodes
+    if(size < 0) {             // a negative count is no graph
+        size = 0;
+        return;
+    }
 
     if(infile.eof()) return;  // stop reading if no more data
 
@@ -96,7 +232,9 @@ void GraphM::buildGraph(istream& infile) {
 
     // read graph node information
     for(int i = 1; i <= size; i++) {
-        data[i].setData(infile);
+        s.clear();             // left empty if the line cannot be read
+        getline(infile, s);
+        labels.add(s);
     }
 
     for(;;) {
@@ -104,17 +242,117 @@ void GraphM::buildGraph(istream& infile) {
         if(fromNode == 0 && toNode == 0) {
             int garbage;
             infile >> garbage;
-            return; // end of edge data
+            break; // end of edge data
         } 
-        infile >> C[fromNode][toNode];
+        int length;
+        infile >> length;
+        edges.push_back(Edge{fromNode, toNode, length});
+    }
+    C.build(size, edges);
+}
+
+//----------------------------------------------------------------------------
+// buildGraph
+// Preconditions:   Text held by the GraphFile is formatted as detailed at the
+//                  top of this file
+// Postconditions:  Next graph of the file is read and Graph is filled with
+//                  its data, returns false and leaves Graph empty if the file
+//                  holds no more graphs
+bool GraphM::buildGraph(GraphFile& file) {
+    int fromNode, toNode, length;  // edge read
+    vector<Edge> edges;            // edges read, placed in the cost array at end
+
+    resetGraph();
+    if(!file.readCount(size) || size < 0) {
+        size = 0;
+        return false;
     }
+
+    for(int i = 1; i <= size; i++) {
+        labels.add(file.readLabel());
+    }
+    while(file.readEdge(fromNode, toNode, length)) {
+        edges.push_back(Edge{fromNode, toNode, length});
+    }
+    C.build(size, edges);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// saveSnapshot
+// Preconditions:   None
+// Postconditions:  Nodes, labels and edges are written to a snapshot file,
+//                  returns false if it could not be written
+bool GraphM::saveSnapshot(const string& path) {
+    C.merge();
+    return GraphSnapshot::write(path, GraphSnapshot::WEIGHTED, size,
+                                C.offsetData(), C.targetData(),
+                                C.weightData(), labels);
+}
+
+//----------------------------------------------------------------------------
+// loadSnapshot
+// Preconditions:   None
+// Postconditions:  Returns true and Graph holds the graph of the snapshot,
+//                  its edges read in place from the mapped file, the whole
+//                  file is checked against its checksum if asked, otherwise
+//                  returns false and Graph is empty
+bool GraphM::loadSnapshot(const string& path, bool check) {
+    resetGraph();
+    shared_ptr<GraphSnapshot> file = make_shared<GraphSnapshot>();
+    if(!file->open(path, check) || file->kind() != GraphSnapshot::WEIGHTED) {
+        return false;
+    }
+
+    size = file->nodeCount();
+    labels.attach(size, file->labelStarts(), file->labelText());
+    C.attach(size, file->edgeCount(), file->offsets(), file->targets(),
+             file->weights());
+    snapshot = file;        // kept mapped while C and labels read it
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// label
+// Preconditions:   Node is in the graph
+// Postconditions:  Returns the text information of the node, valid until the
+//                  graph is built again
+string_view GraphM::label(int v) const {
+    return labels.label(v);
+}
+
+//----------------------------------------------------------------------------
+// findNode
+// Preconditions:   None
+// Postconditions:  Returns the lowest node whose text information is the
+//                  parameter, 0 if there is none
+int GraphM::findNode(string_view name) {
+    return labels.find(name);
+}
+
+//----------------------------------------------------------------------------
+// resetGraph
+// Preconditions:   None
+// Postconditions:  Graph has no nodes, no edges and nothing found from them
+void GraphM::resetGraph() {
+    size = 0;
+    C.build(0, vector<Edge>());   // Set/reset cost array
+    labels.clear();
+    snapshot.reset();             // only after C and labels no longer read it
+    haveReverse = false;
+    marks.clear();
+    hierarchy.clear();
+    T.clear();                    // Set/reset dijkstra array
+    table.close();
+    cache.clear();
 }
 
 //----------------------------------------------------------------------------
 // insertEdge
 // Preconditions:   None
 // Postconditions:  Returns false if invalid parameters or a duplicate edge
-//                  otherwise adds the edge and returns true
+//                  otherwise adds the edge and returns true, rows already
+//                  found are updated for the new edge
 bool GraphM::insertEdge(int from, int to, int length) {
     // Boundary check
     if(from < 0 || from > size) {
@@ -124,22 +362,27 @@ bool GraphM::insertEdge(int from, int to, int length) {
     if(to < 0 || to > size) {
         return false;
     }
-    // Check for duplicate edge
-    if(C[from][to] != INT_MAX) {
+    // Check for duplicate edge, then add the edge
+    if(!C.insertEdge(from, to, length)) {
         return false;
     }
-    // Add the edge
-    C[from][to] = length;
-    return true;    
-
-    // Re-call Dijkstra to update the shortest paths for display
-    findShortestPath();
+    if(haveReverse) {
+        R.insertEdge(to, from, length);
+    }
+    marks.clear();
+    hierarchy.clear();
+    table.close();
+    // Update the shortest paths already found for display
+    maintainRows(from, to, INT_MAX, length);
+    return true;
 }
 
 //----------------------------------------------------------------------------
 // removeEdge
 // Preconditions:   None
-// Postconditions:  None  
+// Postconditions:  Returns false if invalid parameters or no such edge
+//                  otherwise removes the edge and returns true, rows already
+//                  found are updated for the missing edge
 bool GraphM::removeEdge(int from, int to) {
     // Boundary check
     if(from < 0 || from > size) {
@@ -149,16 +392,201 @@ bool GraphM::removeEdge(int from, int to) {
     if(to < 0 || to > size) {
         return false;
     }
-    // Checks if edge exists
-    if(C[from][to] == INT_MAX) {
+    // Checks if edge exists, then removes the edge
+    int length = C.length(from, to);
+    if(!C.removeEdge(from, to)) {
         return false;
     }
-    // Remove the edge
-    C[from][to] = INT_MAX;
+    if(haveReverse) {
+        R.removeEdge(to, from);
+    }
+    marks.clear();
+    hierarchy.clear();
+    table.close();
+    // Update the shortest paths already found to prevent weird behavior if
+    // display is called
+    maintainRows(from, to, length, INT_MAX);
     return true;
+}
+
+//----------------------------------------------------------------------------
+// setUpdateHook
+// Preconditions:   None
+// Postconditions:  Function is called with the work done after every
+//                  successful insertEdge or removeEdge
+void GraphM::setUpdateHook(function<void(const UpdateStats&)> hook) {
+    updateHook = hook;
+}
+
+//----------------------------------------------------------------------------
+// lastUpdate
+// Preconditions:   None
+// Postconditions:  Returns the work done by the last successful insertEdge or
+//                  removeEdge
+GraphM::UpdateStats GraphM::lastUpdate() const {
+    return updateStats;
+}
+
+//----------------------------------------------------------------------------
+// maintainRows
+// Preconditions:   Edge from node 1 to node 2 has already changed length in
+//                  the cost array, from the old to the new length parameter
+// Postconditions:  Every row in the table or the cache is updated for the
+//                  change, updateStats holds the work done, hook is called
+void GraphM::maintainRows(int from, int to, int oldLength, int newLength) {
+    updateStats.rowsTouched = 0;
+    updateStats.entriesTouched = 0;
+
+    vector<PathRow*> rows;
+    for(int i = 1; i < (int)T.size(); i++) {
+        rows.push_back(&T[i]);
+    }
+    for(size_t k = 0; k < cache.size(); k++) {
+        rows.push_back(&cache.rowAt(k));
+    }
+
+    if(!rows.empty()) {
+        C.merge();
+        bool longer = newLength > oldLength;
+        if(longer) {
+            // Repairs walk the edges into each node
+            reverseEdges();
+        }
+
+        // Each row is repaired on its own, so rows can run in any order
+        for(SearchScratch& space : scratch) {
+            space.work.rowsTouched = 0;
+            space.work.entriesTouched = 0;
+        }
+        runTasks(0, rows.size(), [&](int k, int worker) {
+            SearchScratch& space = scratch[worker];
+            long touched = longer
+                ? repairIncrease(*rows[k], from, to, space)
+                : repairDecrease(*rows[k], from, to, newLength, space);
+            if(touched > 0) {
+                space.work.rowsTouched++;
+                space.work.entriesTouched += touched;
+            }
+        });
+        for(SearchScratch& space : scratch) {
+            updateStats.rowsTouched += space.work.rowsTouched;
+            updateStats.entriesTouched += space.work.entriesTouched;
+        }
+    }
+
+    if(updateHook) {
+        updateHook(updateStats);
+    }
+}
+
+//----------------------------------------------------------------------------
+// repairDecrease
+// Preconditions:   Row is current except for the edge from node 1 to node 2
+//                  becoming the given shorter length, cost array is merged
+// Postconditions:  Row is current, returns the number of entries changed
+long GraphM::repairDecrease(PathRow& r, int from, int to, int length,
+                            SearchScratch& space) {
+    // Only rows where the edge shortens the path to its destination change
+    if(r.dist(from) == INT_MAX || r.dist(from) + length >= r.dist(to)) {
+        return 0;
+    }
+    long touched = 1;
+    r.setDist(to, r.dist(from) + length);
+    r.setPath(to, from);
 
-    // Re-call Dijkstra to prevent weird behavior if display is called
-    findShortestPath();
+    // Spread the improvement to the nodes whose paths now get shorter
+    BinaryHeap& heap = space.binaryHeap;
+    heap.resize(size);
+    heap.update(to, r.dist(to));
+    while(!heap.empty()) {
+        int v = heap.pop();
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            int throughV = r.dist(v) + C.weight(e);
+            if(throughV < r.dist(k)) {
+                r.setDist(k, throughV);
+                r.setPath(k, v);
+                heap.update(k, throughV);
+                touched++;
+            }
+        }
+    }
+    return touched;
+}
+
+//----------------------------------------------------------------------------
+// repairIncrease
+// Preconditions:   Row is current except for the edge from node 1 to node 2
+//                  becoming longer or removed, cost array and reverse cost
+//                  array are merged
+// Postconditions:  Row is current, returns the number of entries changed
+long GraphM::repairIncrease(PathRow& r, int from, int to,
+                            SearchScratch& space) {
+    // Only rows whose shortest path tree uses the edge change
+    if(r.dist(to) == INT_MAX || r.path(to) != from) {
+        return 0;
+    }
+
+    // Mark the subtree under the edge, its paths all went through it
+    vector<char>& mark = space.mark;
+    vector<int>& affected = space.affected;
+    mark.resize(size + 1, 0);
+    affected.clear();
+    affected.push_back(to);
+    mark[to] = 1;
+    for(size_t a = 0; a < affected.size(); a++) {
+        int v = affected[a];
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(!mark[k] && r.path(k) == v && r.dist(k) != INT_MAX) {
+                mark[k] = 1;
+                affected.push_back(k);
+            }
+        }
+    }
+    for(int v : affected) {
+        r.setDist(v, INT_MAX);
+        r.setPath(v, 0);
+    }
+
+    // Seed each marked node from its best edge out of the unmarked nodes
+    BinaryHeap& heap = space.binaryHeap;
+    heap.resize(size);
+    for(int v : affected) {
+        for(int e = R.begin(v); e < R.end(v); e++) {
+            int w = R.target(e);
+            if(mark[w] || r.dist(w) == INT_MAX) {
+                continue;
+            }
+            int throughW = r.dist(w) + R.weight(e);
+            if(throughW < r.dist(v)) {
+                r.setDist(v, throughW);
+                r.setPath(v, w);
+            }
+        }
+        if(r.dist(v) != INT_MAX) {
+            heap.update(v, r.dist(v));
+        }
+    }
+
+    // Dijkstra over the marked nodes only, the rest are already final
+    while(!heap.empty()) {
+        int v = heap.pop();
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            int throughV = r.dist(v) + C.weight(e);
+            if(mark[k] && throughV < r.dist(k)) {
+                r.setDist(k, throughV);
+                r.setPath(k, v);
+                heap.update(k, throughV);
+            }
+        }
+    }
+
+    for(int v : affected) {
+        mark[v] = 0;
+    }
+    return affected.size();
 }
 
 //----------------------------------------------------------------------------
@@ -166,43 +594,891 @@ bool GraphM::removeEdge(int from, int to) {
 // Preconditions:   Graph has been filled with nodes, Dijkstra table is in its
 //                  reset state (only 0's and infinities)
 // Postconditions:  Dijkstra table is filled with the shortest paths between
-//                  every node pairing in the Graph
+//                  every node pairing in the Graph, in lazy mode the row
+//                  cache is emptied instead and rows are found when needed,
+//                  with a table file set the rows not already in the file
+//                  are found and stored there instead
 bool GraphM::findShortestPath() {
-    // Set source distance to itself to 0
+    C.merge();
+    if(!tablePath.empty()) {
+        T.clear();
+        cache.clear();
+        fillTable();
+        return false;
+    }
+    if(lazy) {
+        T.clear();
+        cache.reset(rowBudget, PathRow::bytesFor(size));
+        return false;
+    }
+
+    // Set source distance to itself to 0, everything else to infinity
     initT();
-    for(int source = 1; source <= size; source++) {
-        T[source][source].dist = 0;
+
+    if(useFloydWarshall()) {
+        FloydWarshall all;
+        all.solve(C, workers());
+        runTasks(1, size + 1, [&](int i, int) {
+            for(int j = 1; j <= size; j++) {
+                if(j != i) {
+                    T[i].setDist(j, all.distance(i, j));
+                }
+            }
+            pathsFromDistances(i, T[i]);
+        });
+        return false;
     }
 
-    // Iterate through each source node
-    for(int i = 1; i <= size; i++) {
-        // Find paths to each node from this source node
-        for(int j = 1; j <= size; j++) {
-            // Find the min dist not yet visited node
-            int v = findV(i);
-            if(v == 0) {
-                break;
+    // One source at a time, each source's buckets spread over the workers
+    if(engine == DELTA_STEPPING && DeltaStepping::suits(C)) {
+        DeltaStepping solver;
+        solver.setDelta(delta > 0 ? delta : DeltaStepping::suggestDelta(C));
+        for(int i = 1; i <= size; i++) {
+            solver.solve(C, i, workers());
+            for(int j = 1; j <= size; j++) {
+                T[i].setDist(j, solver.distance(j));
+            }
+            pathsFromDistances(i, T[i]);
+        }
+        return false;
+    }
+
+    // Each source only writes its own row, so sources can run in any order
+    runTasks(1, size + 1, [this](int i, int worker) {
+        searchSource(i, T[i], scratch[worker]);
+    });
+
+    return false;
+}
+
+//----------------------------------------------------------------------------
+// setTableFile
+// Preconditions:   None
+// Postconditions:  Returns false if the width is not 1, 2 or 4, otherwise
+//                  later calls to findShortestPath keep the table in the file
+//                  at the path with distances of that many bytes, in place
+//                  of memory and of lazy mode, an empty path keeps it in
+//                  memory again, any table or table file held is dropped
+bool GraphM::setTableFile(const string& path, int width) {
+    if(width != 1 && width != 2 && width != 4) {
+        return false;
+    }
+    tablePath = path;
+    tableWidth = width;
+    table.close();
+    T.clear();
+    cache.clear();
+    resumed = 0;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// resumedRows
+// Preconditions:   None
+// Postconditions:  Returns the number of rows the last findShortestPath
+//                  found already done in the table file
+int GraphM::resumedRows() const {
+    return resumed;
+}
+
+//----------------------------------------------------------------------------
+// fillTable
+// Preconditions:   Table file is set, cost array is merged
+// Postconditions:  Table file is open for the graph and holds every row whose
+//                  distances fit its width, returns false if it could not be
+//                  opened or written
+bool GraphM::fillTable() {
+    resumed = 0;
+    if(!table.open(tablePath, size, tableWidth, graphKey())) {
+        return false;
+    }
+    resumed = table.doneCount();
+
+    // Each worker searches into its own row and stores it, the block is
+    // committed before the next one is started
+    bool written = true;
+    int block = threadCount * TABLE_ROWS_PER_WORKER;
+    for(int first = 1; first <= size && written; first += block) {
+        int last = min(size + 1, first + block);
+        runTasks(first, last, [this](int i, int worker) {
+            if(table.done(i)) {
+                return;
+            }
+            SearchScratch& space = scratch[worker];
+            space.row.reset(size, i);
+            searchSource(i, space.row, space);
+            table.store(i, space.row);
+        });
+        written = table.commit(first, last);
+    }
+    return written;
+}
+
+//----------------------------------------------------------------------------
+// graphKey
+// Preconditions:   Cost array is merged
+// Postconditions:  Returns a checksum of the node count and every edge
+uint64_t GraphM::graphKey() const {
+    uint64_t sum = GraphSnapshot::hash(GraphSnapshot::HASH_BASIS,
+                                       (const char*)&size, sizeof(size));
+    sum = GraphSnapshot::hash(sum, (const char*)C.offsetData(),
+                              (size + 2) * sizeof(int));
+    sum = GraphSnapshot::hash(sum, (const char*)C.targetData(),
+                              C.edgeCount() * sizeof(int));
+    return GraphSnapshot::hash(sum, (const char*)C.weightData(),
+                               C.edgeCount() * sizeof(int));
+}
+
+//----------------------------------------------------------------------------
+// useFloydWarshall
+// Preconditions:   Cost array is merged
+// Postconditions:  Returns true if findShortestPath should fill the table
+//                  with Floyd-Warshall rather than Dijkstra's algorithm
+bool GraphM::useFloydWarshall() const {
+    if((engine != AUTO && engine != FLOYD_WARSHALL) || size == 0 ||
+       !FloydWarshall::suits(C)) {
+        return false;
+    }
+    if(engine == FLOYD_WARSHALL) {
+        return true;
+    }
+    double density = C.edgeCount() / ((double)size * size);
+    return density * log2((double)size) >= FLOYD_WARSHALL_DENSITY;
+}
+
+//----------------------------------------------------------------------------
+// pathsFromDistances
+// Preconditions:   Row for the source holds its shortest distances and no
+//                  previous nodes, every edge length is positive
+// Postconditions:  Row holds the previous nodes Dijkstra's algorithm would
+//                  have picked
+void GraphM::pathsFromDistances(int i, PathRow& r) {
+    // Dijkstra finishes nodes in order of distance then index, and the last
+    // finished node with an edge on a shortest path into k sets k's path,
+    // with positive lengths that is the latest such node in that order
+    for(int v = 1; v <= size; v++) {
+        if(r.dist(v) == INT_MAX) {
+            continue;
+        }
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(k == i || r.dist(v) + C.weight(e) != r.dist(k)) {
+                continue;
+            }
+            int p = r.path(k);
+            if(p == 0 || r.dist(v) >= r.dist(p)) {
+                r.setPath(k, v);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// setLazy
+// Preconditions:   None
+// Postconditions:  Turns lazy mode on or off, in lazy mode rows are found on
+//                  demand and at most the budget's bytes of rows are kept,
+//                  any table or cached rows are dropped
+void GraphM::setLazy(bool on, size_t budgetBytes) {
+    lazy = on;
+    rowBudget = budgetBytes;
+    T.clear();
+    cache.reset(rowBudget, PathRow::bytesFor(size));
+}
+
+//----------------------------------------------------------------------------
+// distance
+// Preconditions:   findShortestPath has been called, or lazy mode is on
+// Postconditions:  Returns the shortest distance from parameter node 1 to
+//                  parameter node 2, INT_MAX if there is no path
+int GraphM::distance(int i, int j) {
+    if(inTable(i) && j >= 1 && j <= size) {
+        return table.row(i).dist(j);
+    }
+    const PathRow* r = row(i);
+    if(r == nullptr || j < 1 || j > size) {
+        return INT_MAX;
+    }
+    return r->dist(j);
+}
+
+//----------------------------------------------------------------------------
+// path
+// Preconditions:   None
+// Postconditions:  Returns the shortest distance from node 1 to node 2 and
+//                  the vector holds the nodes of the path display would
+//                  print, returns INT_MAX and an empty vector if there is no
+//                  path, the vector's memory is reused
+int GraphM::path(int i, int j, vector<int>& nodes) {
+    auto read = [&](const auto* r) {
+        if(r == nullptr || r->dist(j) == INT_MAX) {
+            nodes.clear();
+            return INT_MAX;
+        }
+        walkPath(*r, j, nodes);
+        return r->dist(j);
+    };
+    if(inTable(i) && j >= 1 && j <= size) {
+        PathTable::Row r = table.row(i);
+        return read(&r);
+    }
+    return read(pairRow(i, j));
+}
+
+//----------------------------------------------------------------------------
+// row
+// Preconditions:   None
+// Postconditions:  Returns the Dijkstra row for the source, found now if
+//                  in lazy mode and not cached, or if a table file is set
+//                  and the row is not in it, nullptr if the source is not
+//                  in the graph or findShortestPath has not filled the table
+const PathRow* GraphM::row(int source) {
+    if(source < 1 || source > size) {
+        return nullptr;
+    }
+    if(!tablePath.empty()) {
+        // Not in the table file, its distances are too long for the width or
+        // an edge has changed since, found into a spare row
+        C.merge();
+        if(scratch.empty()) {
+            scratch.resize(1);
+        }
+        PathRow& spare = scratch[0].row;
+        spare.reset(size, source);
+        searchSource(source, spare, scratch[0]);
+        return &spare;
+    }
+    if(!lazy) {
+        return source < (int)T.size() ? &T[source] : nullptr;
+    }
+    PathRow* found = cache.find(source);
+    if(found != nullptr) {
+        return found;
+    }
+
+    // First time this source is asked for, run Dijkstra for it alone
+    C.merge();
+    scratch.resize(1);
+    PathRow& fresh = cache.claim(source);
+    fresh.reset(size, source);
+    searchSource(source, fresh, scratch[0]);
+    return &fresh;
+}
+
+//----------------------------------------------------------------------------
+// inTable
+// Preconditions:   None
+// Postconditions:  Returns true if the source's row is done in the open
+//                  table file
+bool GraphM::inTable(int source) const {
+    return table.done(source);
+}
+
+//----------------------------------------------------------------------------
+// findPairs
+// Preconditions:   Array holds the given number of pairs
+// Postconditions:  Results hold the shortest distance and path of every
+//                  pair, a pair with a node not in the graph or no path has
+//                  INT_MAX and an empty path, origins are spread over
+//                  threadCount workers if the last parameter is true
+void GraphM::findPairs(const PairQuery* pairs, int count, PairResults& out,
+                       bool parallel) {
+    out.distance.assign(count, INT_MAX);
+    out.pathStart.assign(count + 1, 0);
+    out.nodes.clear();
+    batch.worker.assign(count, 0);
+    batch.offset.assign(count, 0);
+
+    // Pairs with the same origin end up next to each other, in given order
+    batch.order.clear();
+    for(int q = 0; q < count; q++) {
+        if(pairs[q].from >= 1 && pairs[q].from <= size &&
+           pairs[q].to >= 1 && pairs[q].to <= size) {
+            batch.order.push_back(q);
+        }
+    }
+    stable_sort(batch.order.begin(), batch.order.end(),
+                [pairs](int a, int b) {
+                    return pairs[a].from < pairs[b].from;
+                });
+    batch.groups.clear();
+    for(size_t k = 0; k < batch.order.size(); k++) {
+        if(k == 0 || pairs[batch.order[k]].from !=
+                     pairs[batch.order[k - 1]].from) {
+            batch.groups.push_back(k);
+        }
+    }
+    int groupCount = batch.groups.size();
+    batch.groups.push_back(batch.order.size());
+
+    // Rows already held are looked up here, the cache is not thread safe
+    C.merge();
+    batch.rows.assign(groupCount, nullptr);
+    for(int g = 0; g < groupCount; g++) {
+        int source = pairs[batch.order[batch.groups[g]]].from;
+        if(lazy) {
+            batch.rows[g] = cache.find(source);
+        }
+        else if(source < (int)T.size()) {
+            batch.rows[g] = &T[source];
+        }
+    }
+
+    auto answer = [&](int g, int worker) {
+        SearchScratch& space = scratch[worker];
+        const PathRow* r = batch.rows[g];
+        if(r == nullptr) {
+            int source = pairs[batch.order[batch.groups[g]]].from;
+            space.row.reset(size, source);
+            searchSource(source, space.row, space);
+            r = &space.row;
+        }
+        for(int k = batch.groups[g]; k < batch.groups[g + 1]; k++) {
+            int q = batch.order[k];
+            int j = pairs[q].to;
+            out.distance[q] = r->dist(j);
+            batch.worker[q] = worker;
+            batch.offset[q] = space.route.size();
+            if(r->dist(j) == INT_MAX) {
+                continue;
             }
-            T[i][v].visited = true;
 
-            // For each w adjacent to v
-            for(int k = 1; k <= size; k++) {
-                if(C[v][k] == INT_MAX) {
+            // Walked back from the destination, then turned around
+            for(int v = j; v != 0; v = r->path(v)) {
+                space.route.push_back(v);
+            }
+            reverse(space.route.begin() + batch.offset[q], space.route.end());
+            out.pathStart[q + 1] = space.route.size() - batch.offset[q];
+        }
+    };
+    if(parallel) {
+        scratch.resize(threadCount);
+    }
+    else if(scratch.empty()) {
+        scratch.resize(1);
+    }
+    for(SearchScratch& space : scratch) {
+        space.route.clear();
+    }
+    if(parallel) {
+        runTasks(0, groupCount, answer);
+    }
+    else {
+        for(int g = 0; g < groupCount; g++) {
+            answer(g, 0);
+        }
+    }
+
+    // pathStart holds each path's length so far, turn it into offsets
+    for(int q = 0; q < count; q++) {
+        out.pathStart[q + 1] += out.pathStart[q];
+    }
+    out.nodes.resize(out.pathStart[count]);
+    for(int q = 0; q < count; q++) {
+        const vector<int>& route = scratch[batch.worker[q]].route;
+        copy(route.begin() + batch.offset[q],
+             route.begin() + batch.offset[q] + out.pathStart[q + 1] -
+             out.pathStart[q], out.nodes.begin() + out.pathStart[q]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// setHeapType
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath use the given priority
+//                  queue, the default is BINARY_HEAP
+void GraphM::setHeapType(HeapType type) {
+    heapType = type;
+}
+
+//----------------------------------------------------------------------------
+// settledCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes settled by the last search
+//                  display ran for a pair of nodes, 0 if it used a row
+int GraphM::settledCount() const {
+    return query.settled;
+}
+
+//----------------------------------------------------------------------------
+// setPairSearch
+// Preconditions:   None
+// Postconditions:  Later calls to display without a row use the given
+//                  search, the default is BIDIRECTIONAL
+void GraphM::setPairSearch(PairType type) {
+    pairType = type;
+}
+
+//----------------------------------------------------------------------------
+// buildLandmarks
+// Preconditions:   Graph has been built
+// Postconditions:  Up to the given number of landmarks are chosen by the
+//                  method and their distances found
+void GraphM::buildLandmarks(int count, Landmarks::Method method) {
+    C.merge();
+    reverseEdges();
+    marks.build(C, R, count, method);
+}
+
+//----------------------------------------------------------------------------
+// saveLandmarks
+// Preconditions:   None
+// Postconditions:  Landmarks are written to the stream, returns false if the
+//                  stream failed
+bool GraphM::saveLandmarks(ostream& out) const {
+    return marks.save(out);
+}
+
+//----------------------------------------------------------------------------
+// loadLandmarks
+// Preconditions:   Graph has been built
+// Postconditions:  Returns true and holds the landmarks from the stream if
+//                  they were saved for this graph's edges, otherwise returns
+//                  false and holds none
+bool GraphM::loadLandmarks(istream& in) {
+    C.merge();
+    return marks.load(in, C);
+}
+
+//----------------------------------------------------------------------------
+// landmarkCount
+// Preconditions:   None
+// Postconditions:  Returns the number of landmarks held
+int GraphM::landmarkCount() const {
+    return marks.count();
+}
+
+//----------------------------------------------------------------------------
+// buildHierarchy
+// Preconditions:   Graph has been built
+// Postconditions:  Contraction hierarchy is built for the graph's edges, on
+//                  threadCount threads
+void GraphM::buildHierarchy() {
+    C.merge();
+    hierarchy.build(C, workers());
+}
+
+//----------------------------------------------------------------------------
+// setDelta
+// Preconditions:   None
+// Postconditions:  Later DELTA_STEPPING runs use buckets of the given width,
+//                  0 or less picks it from the edge lengths, the default
+void GraphM::setDelta(int width) {
+    delta = width;
+}
+
+//----------------------------------------------------------------------------
+// setEngine
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath use the given algorithm,
+//                  the default is AUTO
+void GraphM::setEngine(EngineType type) {
+    engine = type;
+}
+
+//----------------------------------------------------------------------------
+// setThreadCount
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath spread the sources over
+//                  the given number of threads, 0 or less uses every hardware
+//                  thread, the default is 1
+void GraphM::setThreadCount(int count) {
+    threadCount = count > 0 ? count : ThreadPool::hardwareThreads();
+}
+
+//----------------------------------------------------------------------------
+// runTasks
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index from begin up
+//                  to end, spread over threadCount workers, scratch holds one
+//                  entry per worker
+void GraphM::runTasks(int begin, int end,
+                      const function<void(int, int)>& task) {
+    scratch.resize(threadCount);
+    ThreadPool* threads = workers();
+    if(threads == nullptr) {
+        for(int i = begin; i < end; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    threads->parallelFor(begin, end, 1, task);
+}
+
+//----------------------------------------------------------------------------
+// workers
+// Preconditions:   None
+// Postconditions:  Returns the pool of threadCount workers, made now if
+//                  needed, nullptr when threadCount is 1
+ThreadPool* GraphM::workers() {
+    if(threadCount == 1) {
+        return nullptr;
+    }
+    if(!pool || pool->threadCount() != threadCount) {
+        pool = make_shared<ThreadPool>(threadCount);
+    }
+    return pool.get();
+}
+
+//----------------------------------------------------------------------------
+// searchSource
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled by the search for heapType,
+//                  using the scratch parameter for its queue
+void GraphM::searchSource(int i, PathRow& r, SearchScratch& space) {
+    if(heapType == LINEAR_SCAN) {
+        scanSearch(r, space.visited);
+    }
+    else if(heapType == FOUR_ARY_HEAP) {
+        heapSearch(i, r, space.fourAryHeap, space.visited);
+    }
+    else if(heapType == PAIRING_HEAP) {
+        heapSearch(i, r, space.pairingHeap, space.visited);
+    }
+    else {
+        heapSearch(i, r, space.binaryHeap, space.visited);
+    }
+}
+
+//----------------------------------------------------------------------------
+// scanSearch
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled using findV to pick each node
+void GraphM::scanSearch(PathRow& r, BitArray& visited) {
+    visited.resize(size);
+    // Find paths to each node from this source node
+    for(int j = 1; j <= size; j++) {
+        // Find the min dist not yet visited node
+        int v = findV(r, visited);
+        if(v == 0) {
+            break;
+        }
+        visited.set(v);
+
+        // For each w adjacent to v
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(!visited.test(k)) {
+                int original = r.dist(k);
+                int throughV = r.dist(v) + C.weight(e);
+                if(min(original, throughV) == throughV) {
+                    r.setDist(k, throughV);
+                    r.setPath(k, v);
+                }
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// heapSearch
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled using the heap parameter to
+//                  pick each node, the row is identical to scanSearch's
+template <class Heap>
+void GraphM::heapSearch(int i, PathRow& r, Heap& heap, BitArray& visited) {
+    visited.resize(size);
+    heap.reset(size);
+    heap.update(i, 0);
+    while(!heap.empty()) {
+        // Unvisited node with min dist, lowest index on ties like findV
+        int v = heap.pop();
+        visited.set(v);
+
+        // For each w adjacent to v
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(visited.test(k)) {
+                continue;
+            }
+            int original = r.dist(k);
+            int throughV = r.dist(v) + C.weight(e);
+            if(min(original, throughV) == throughV) {
+                r.setDist(k, throughV);
+                r.setPath(k, v);
+                if(throughV < original) {
+                    heap.update(k, throughV);
+                }
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// reverseEdges
+// Preconditions:   Cost array is merged
+// Postconditions:  Reverse cost array is built if it was not and is merged
+void GraphM::reverseEdges() {
+    if(!haveReverse) {
+        C.transpose(R);
+        haveReverse = true;
+    }
+    R.merge();
+}
+
+//----------------------------------------------------------------------------
+// pairRow
+// Preconditions:   None
+// Postconditions:  Returns a row whose path to node 2 from node 1 is the
+//                  one the full table would hold, the table or cache row if
+//                  there is one, else the row of a pair search, nullptr if
+//                  either node is not in the graph
+const PathRow* GraphM::pairRow(int i, int j) {
+    if(i < 1 || i > size || j < 1 || j > size) {
+        return nullptr;
+    }
+    query.settled = 0;
+    if(!lazy && i < (int)T.size()) {
+        return &T[i];
+    }
+    if(lazy) {
+        PathRow* found = cache.find(i);
+        if(found != nullptr) {
+            return found;
+        }
+    }
+    if(pairType == LANDMARKS) {
+        return landmarkSearch(i, j);
+    }
+    if(pairType == CONTRACTION && hierarchy.built()) {
+        return hierarchySearch(i, j);
+    }
+    return pairSearch(i, j);
+}
+
+//----------------------------------------------------------------------------
+// hierarchySearch
+// Preconditions:   Nodes are in the graph, hierarchy is built
+// Postconditions:  Returns a row holding the path the hierarchy finds from
+//                  node 1 to node 2, only the entries on that path are
+//                  meaningful, its distance is INT_MAX if there is no path
+const PathRow* GraphM::hierarchySearch(int i, int j) {
+    C.merge();
+    resetQuery();
+    PathRow& r = query.forward;
+    vector<int>& route = query.route;
+    hierarchy.query(i, j, route);
+    query.settled = hierarchy.settled();
+
+    // Lay the path out as a row so the display functions can walk it
+    for(size_t k = 0; k < route.size(); k++) {
+        int v = route[k];
+        query.touched.push_back(v);
+        if(k == 0) {
+            r.setDist(v, 0);
+            continue;
+        }
+        r.setDist(v, r.dist(route[k - 1]) + C.length(route[k - 1], v));
+        r.setPath(v, route[k - 1]);
+    }
+    return &r;
+}
+
+//----------------------------------------------------------------------------
+// resetQuery
+// Preconditions:   None
+// Postconditions:  Search space of display is sized for the graph and holds
+//                  no distances, only the entries touched last time are
+//                  cleared unless the graph changed size
+void GraphM::resetQuery() {
+    PathRow& r = query.forward;
+    if(r.size() != size + 1) {
+        r.reset(size, 0);
+        r.setDist(0, INT_MAX);
+        query.backward.assign(size + 1, INT_MAX);
+        query.forwardDone.resize(size);
+        query.backwardDone.resize(size);
+        query.forwardHeap.reset(size);
+        query.backwardHeap.reset(size);
+    }
+    else {
+        for(int v : query.touched) {
+            r.setDist(v, INT_MAX);
+            r.setPath(v, 0);
+            query.backward[v] = INT_MAX;
+            query.forwardDone.reset(v);
+            query.backwardDone.reset(v);
+        }
+        query.forwardHeap.clear();
+        query.backwardHeap.clear();
+    }
+    query.touched.clear();
+    query.settled = 0;
+}
+
+//----------------------------------------------------------------------------
+// landmarkSearch
+// Preconditions:   Nodes are in the graph
+// Postconditions:  Returns the row of a Dijkstra search from node 1 that
+//                  only expands nodes the landmarks allow on a shortest path
+//                  to node 2, only the entries on those paths are
+//                  meaningful, its distance is INT_MAX if there is no path
+const PathRow* GraphM::landmarkSearch(int i, int j) {
+    C.merge();
+    resetQuery();
+    PathRow& r = query.forward;
+    BinaryHeap& heap = query.forwardHeap;
+
+    r.setDist(i, 0);
+    query.touched.push_back(i);
+    heap.update(i, 0);
+    long long best = marks.upperBound(i, j);    // no path is longer
+
+    while(!query.forwardDone.test(j) && !heap.empty()) {
+        int v = heap.pop();
+        query.forwardDone.set(v);
+        query.settled++;
+
+        // Nodes that cannot be on a shortest path are finished, not expanded
+        long long remaining = marks.lowerBound(v, j);
+        if(remaining == LLONG_MAX || r.dist(v) + remaining > best) {
+            continue;
+        }
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(query.forwardDone.test(k)) {
+                continue;
+            }
+            int original = r.dist(k);
+            int throughV = r.dist(v) + C.weight(e);
+            if(min(original, throughV) == throughV) {
+                if(original == INT_MAX) {
+                    query.touched.push_back(k);
+                }
+                r.setDist(k, throughV);
+                r.setPath(k, v);
+                if(throughV < original) {
+                    heap.update(k, throughV);
+                }
+                if(k == j && throughV < best) {
+                    best = throughV;
+                }
+            }
+        }
+    }
+    return &r;
+}
+
+//----------------------------------------------------------------------------
+// pairSearch
+// Preconditions:   Nodes are in the graph
+// Postconditions:  Returns the forward row of a bidirectional search from
+//                  node 1 to node 2, only the entries on the shortest paths
+//                  to node 2 are meaningful, its distance is INT_MAX if
+//                  there is no path
+const PathRow* GraphM::pairSearch(int i, int j) {
+    C.merge();
+    reverseEdges();
+    resetQuery();
+    PathRow& r = query.forward;
+    vector<int>& back = query.backward;
+    BinaryHeap& forwardHeap = query.forwardHeap;
+    BinaryHeap& backwardHeap = query.backwardHeap;
+
+    r.setDist(i, 0);
+    back[j] = 0;
+    query.touched.push_back(i);
+    query.touched.push_back(j);
+    forwardHeap.update(i, 0);
+    backwardHeap.update(j, 0);
+    long long best = INT_MAX;       // shortest path length seen so far
+
+    // Grow the side with the nearer frontier until the frontiers pass best
+    while(!forwardHeap.empty() && !backwardHeap.empty()) {
+        if((long long)forwardHeap.topKey() + backwardHeap.topKey() > best) {
+            break;
+        }
+        if(forwardHeap.topKey() <= backwardHeap.topKey()) {
+            // Same steps as heapSearch, so the paths found are the table's
+            int v = forwardHeap.pop();
+            query.forwardDone.set(v);
+            query.settled++;
+            for(int e = C.begin(v); e < C.end(v); e++) {
+                int k = C.target(e);
+                if(query.forwardDone.test(k)) {
+                    continue;
+                }
+                int original = r.dist(k);
+                int throughV = r.dist(v) + C.weight(e);
+                if(min(original, throughV) == throughV) {
+                    if(original == INT_MAX) {
+                        query.touched.push_back(k);
+                    }
+                    r.setDist(k, throughV);
+                    r.setPath(k, v);
+                    if(throughV < original) {
+                        forwardHeap.update(k, throughV);
+                    }
+                }
+                if(back[k] != INT_MAX && (long long)r.dist(k) + back[k] < best) {
+                    best = (long long)r.dist(k) + back[k];
+                }
+            }
+        }
+        else {
+            int v = backwardHeap.pop();
+            query.backwardDone.set(v);
+            query.settled++;
+            for(int e = R.begin(v); e < R.end(v); e++) {
+                int k = R.target(e);
+                if(query.backwardDone.test(k)) {
                     continue;
                 }
-                if(!T[i][k].visited) {
-                    int original = T[i][k].dist;
-                    int throughV = T[i][v].dist + C[v][k];
-                    if(min(original, throughV) == throughV) {
-                        T[i][k].dist = throughV;
-                        T[i][k].path = v;
+                int throughV = back[v] + R.weight(e);
+                if(throughV < back[k]) {
+                    if(back[k] == INT_MAX) {
+                        query.touched.push_back(k);
                     }
+                    back[k] = throughV;
+                    backwardHeap.update(k, throughV);
+                }
+                if(r.dist(k) != INT_MAX && (long long)r.dist(k) + back[k] < best) {
+                    best = (long long)r.dist(k) + back[k];
                 }
             }
         }
     }
+    if(best == INT_MAX) {
+        return &r;
+    }
 
-    return false;
+    // Every node not settled backward is at least this far from node 2
+    long long farther = backwardHeap.empty() ? LLONG_MAX
+                                             : backwardHeap.topKey();
+
+    // Carry on forward until node 2 is finished, only expanding nodes that
+    // can still be on a shortest path
+    while(!query.forwardDone.test(j) && !forwardHeap.empty()) {
+        int v = forwardHeap.pop();
+        query.forwardDone.set(v);
+        query.settled++;
+        long long remaining = query.backwardDone.test(v) ? back[v] : farther;
+        if(remaining == LLONG_MAX || r.dist(v) + remaining > best) {
+            continue;
+        }
+        for(int e = C.begin(v); e < C.end(v); e++) {
+            int k = C.target(e);
+            if(query.forwardDone.test(k)) {
+                continue;
+            }
+            int original = r.dist(k);
+            int throughV = r.dist(v) + C.weight(e);
+            if(min(original, throughV) == throughV) {
+                if(original == INT_MAX) {
+                    query.touched.push_back(k);
+                }
+                r.setDist(k, throughV);
+                r.setPath(k, v);
+                if(throughV < original) {
+                    forwardHeap.update(k, throughV);
+                }
+            }
+        }
+    }
+    return &r;
 }
 
 //----------------------------------------------------------------------------
@@ -216,13 +1492,13 @@ int GraphM::min(int a, int b) {
 //----------------------------------------------------------------------------
 // findV
 // Preconditions:   Should only be called within the Dijkstra algorithm function
-//                  assumes meaningful data in the Dijkstra table
+//                  assumes meaningful data in the Dijkstra table row
 // Postconditions:  Returns the index for the unvisited node with the minimum
-//                  distance from the parameter node
-int GraphM::findV(int source) {
+//                  distance from the row's source node
+int GraphM::findV(const PathRow& r, const BitArray& visited) {
     int v = 0;
     for(int i = 1; i <= size; i++) {
-        if((T[source][i].dist < T[source][v].dist) && !T[source][i].visited) {
+        if((r.dist(i) < r.dist(v)) && !visited.test(i)) {
             v = i;
         }
     }
@@ -238,33 +1514,88 @@ int GraphM::findV(int source) {
 // Postconditions:  No internal changes to the Graph, path data has been printed
 //                  out to the console
 void GraphM::displayAll() {
-    cout << setw(26) << left << "Description";
-    cout << setw(11) << left << "From node";
-    cout << setw(9) << left << "To node";
-    cout << "Dijkstra's Path" << endl;
-    for(int i = 1; i <= size; i++) {
-        cout << data[i] << endl;
-        for(int j = 1; j <= size; j++) {
-            if(i == j) {
-                continue;
-            }
-            cout << setw(31) << left << "";
-            cout << setw(8) << left << i;
-            cout << setw(9) << j;
-            cout << setw(10) << left;
-            if(T[i][j].dist != INT_MAX) {
-                cout << T[i][j].dist;
-                cout << pathToString(i, j) << endl;
+    OutputBuffer out(cout);
+    displayAll(out);
+}
+
+//----------------------------------------------------------------------------
+// displayAll
+// Preconditions:   Same as displayAll to the console
+// Postconditions:  Same text displayAll prints to the console is written to
+//                  the buffer and flushed, rows are rendered on threadCount
+//                  workers if the last parameter is true and the table is
+//                  filled
+void GraphM::displayAll(OutputBuffer& out, bool parallel) {
+    out.putText("Description", 26);
+    out.putText("From node", 11);
+    out.putText("To node", 9);
+    out.putText("Dijkstra's Path\n");
+
+    // Lazy rows come from the cache, which only one thread may use
+    bool filled = table.isOpen() ? table.doneCount() == size
+                                 : !lazy && (int)T.size() == size + 1;
+    if(!parallel || threadCount == 1 || !filled) {
+        for(int i = 1; i <= size; i++) {
+            if(inTable(i)) {
+                PathTable::Row r = table.row(i);
+                renderRow(out, i, &r, route);
             }
             else {
-                cout << "---";
-                cout << endl;
+                renderRow(out, i, row(i), route);
+            }
+        }
+        out.flush();
+        return;
+    }
+
+    // Each block of sources is rendered into one chunk per source, then
+    // the chunks are written in order
+    int block = threadCount * ROWS_PER_WORKER;
+    vector<OutputBuffer> chunks(block);
+    for(int first = 1; first <= size; first += block) {
+        int last = min(size + 1, first + block);
+        runTasks(first, last, [&](int i, int worker) {
+            chunks[i - first].clear();
+            if(table.isOpen()) {
+                PathTable::Row r = table.row(i);
+                renderRow(chunks[i - first], i, &r, scratch[worker].route);
             }
-            
-            if(T[i][j].dist != INT_MAX) {
-                
+            else {
+                renderRow(chunks[i - first], i, &T[i], scratch[worker].route);
             }
+        });
+        for(int i = first; i < last; i++) {
+            out.append(chunks[i - first]);
+        }
+    }
+    out.flush();
+}
+
+//----------------------------------------------------------------------------
+// renderRow
+// Preconditions:   Row is the source's or nullptr, vector is not used by
+//                  another thread
+// Postconditions:  Source's block of displayAll is written to the buffer
+template <class Row>
+void GraphM::renderRow(OutputBuffer& out, int i, const Row* r,
+                       vector<int>& nodes) {
+    out.putText(labels.label(i));
+    out.put('\n');
+    for(int j = 1; j <= size; j++) {
+        if(i == j) {
+            continue;
+        }
+        out.spaces(31);
+        out.putInt(i, 8);
+        out.putInt(j, 9);
+        if(r != nullptr && r->dist(j) != INT_MAX) {
+            out.putInt(r->dist(j), 10);
+            printPath(out, *r, j, nodes);
         }
+        else {
+            out.putText("---", 10);
+        }
+        out.put('\n');
     }
 }
 
@@ -277,64 +1608,97 @@ void GraphM::displayAll() {
 // Postconditions:  No internal changes to the Graph, path data has been printed
 //                  out to the console
 void GraphM::display(int i, int j) {
-    cout << "\t" << i << "\t" << j << "\t";
-    if(T[i][j].dist == INT_MAX) {
-        cout << "---" << endl;
-        return;    
+    OutputBuffer out(cout);
+    display(out, i, j);
+}
+
+//----------------------------------------------------------------------------
+// display
+// Preconditions:   Same as display to the console
+// Postconditions:  Same text display prints to the console is written to the
+//                  buffer and flushed
+void GraphM::display(OutputBuffer& out, int i, int j) {
+    out.put('\t');
+    out.putInt(i);
+    out.put('\t');
+    out.putInt(j);
+    out.put('\t');
+    if(inTable(i) && j >= 1 && j <= size) {
+        PathTable::Row r = table.row(i);
+        renderPair(out, &r, j);
+    }
+    else {
+        renderPair(out, pairRow(i, j), j);
     }
-    cout << T[i][j].dist << "\t";
-    cout << pathToString(i,j) << endl;
-    cout << detailedPathToString(i,j) << endl;
+    out.flush();
 }
 
 //----------------------------------------------------------------------------
-// pathToString
-// Preconditions:   Should only be called within the display functions, assumes
-//                  that the Dijkstra algorithm has been perfomed on the graph
-//                  and that path values are meaningful
-// Postconditions:  Returns a string of each node visited on the shortest path
-//                  from parameter node 1 to parameter node 2
-string GraphM::pathToString(int i, int j) {
-    string path;
-    stack<int> route;
-    route.push(j);
-    while(j != 0) {
-        if(T[i][j].path == 0) {
-            break;
-        }
-        route.push(T[i][j].path);
-        j = T[i][j].path;
+// renderPair
+// Preconditions:   Row is node 1's or nullptr
+// Postconditions:  Distance and paths display prints after the two nodes are
+//                  written to the buffer, or "---" if there is no path
+template <class Row>
+void GraphM::renderPair(OutputBuffer& out, const Row* r, int j) {
+    if(r == nullptr || r->dist(j) == INT_MAX) {
+        out.putText("---\n");
+        return;
     }
-    while (!route.empty()) {
-        path.append(to_string(route.top()));
-        path.append(" ");
-        route.pop();
+    out.putInt(r->dist(j));
+    out.put('\t');
+    printPath(out, *r, j, route);
+    out.put('\n');
+    printDetailedPath(out, *r, j, route);
+    out.put('\n');
+}
+
+//----------------------------------------------------------------------------
+// walkPath
+// Preconditions:   Row's path values to the node are meaningful, Row is a
+//                  PathRow or a PathTable::Row
+// Postconditions:  Vector holds each node visited on the shortest path from
+//                  the row's source to the parameter node, in order, its
+//                  memory is reused so no allocation is made once it is big
+//                  enough
+template <class Row>
+void GraphM::walkPath(const Row& r, int j, vector<int>& nodes) const {
+    nodes.clear();
+    for(int v = j; v != 0; v = r.path(v)) {
+        nodes.push_back(v);
     }
-    return path;
+    reverse(nodes.begin(), nodes.end());
 }
 
 //----------------------------------------------------------------------------
-// detailedPathToString
-// Preconditions:   Should only be called within the display function, assumes
-//                  that the Dijkstra algorithm has been perfomed on the graph
-//                  and that path values are meaningful
-// Postconditions:  Returns a string of the information of each node visited on
-//                  the shortest path from parameter node 1 to parameter node 2
-string GraphM::detailedPathToString(int i, int j) {
-    stringstream ss;
-    stack<int> route;
-    route.push(j);
-    while(j != 0) {
-        if(T[i][j].path == 0) {
-            break;
-        }
-        route.push(T[i][j].path);
-        j = T[i][j].path;
+// printPath
+// Preconditions:   Should only be called within the display functions, assumes
+//                  that the row's path values to the node are meaningful
+// Postconditions:  Each node visited on the shortest path from the row's
+//                  source to the parameter node is written to the buffer,
+//                  each followed by a space, the vector is used to walk it
+template <class Row>
+void GraphM::printPath(OutputBuffer& out, const Row& r, int j,
+                       vector<int>& nodes) {
+    walkPath(r, j, nodes);
+    for(int v : nodes) {
+        out.putInt(v);
+        out.put(' ');
     }
-    while (!route.empty()) {
-        ss << data[route.top()];
-        ss << endl;
-        route.pop();
+}
+
+//----------------------------------------------------------------------------
+// printDetailedPath
+// Preconditions:   Should only be called within the display function, assumes
+//                  that the row's path values to the node are meaningful
+// Postconditions:  The information of each node visited on the shortest path
+//                  from the row's source to the parameter node is written to
+//                  the buffer, one node per line, the vector is used to walk it
+template <class Row>
+void GraphM::printDetailedPath(OutputBuffer& out, const Row& r, int j,
+                               vector<int>& nodes) {
+    walkPath(r, j, nodes);
+    for(int v : nodes) {
+        out.putText(labels.label(v));
+        out.put('\n');
     }
-    return ss.str();
-}
\ No newline at end of file
+}
@@ -8,17 +8,141 @@
 //      --insertion of an individual Edge
 //      --removal of an individual Edge
 //      --allows Dijkstra's algorithm to be performed on the Graph
+//      --allows choice of the priority queue used by Dijkstra's algorithm
+//      --allows Dijkstra's algorithm to run on several threads at once
+//      --allows blocked Floyd-Warshall in place of Dijkstra's algorithm for
+//        dense graphs, chosen from the edge density and node count unless
+//        set
+//      --allows parallel delta-stepping in place of Dijkstra's algorithm for
+//        large sparse graphs, when set
+//      --allows lazy shortest paths, where each source's row is only found
+//        the first time it is asked for
+//      --keeps rows already found current when an edge is inserted or
+//        removed, without finding them again
 //      --allows output of shortest paths between every node in the Graph
 //      --allows more detailed output of shortest path between 2 specified
-//        nodes in the graph
+//        nodes in the graph, without the full table when it is not there
+//      --allows output to a buffer on a file descriptor or stream, with rows
+//        rendered on several threads
+//      --allows landmarks to be chosen and saved or loaded, for A* searches
+//        (ALT) in display
+//      --allows a contraction hierarchy to be built, for fast searches in
+//        display on large, mostly static graphs
+//      --allows a batch of pairs of nodes to be answered at once into a
+//        caller's buffer, with one search per distinct origin
+//      --allows the nodes of a shortest path to be read into a caller's
+//        vector
+//      --allows graphs to be read from a memory mapped file with GraphFile
+//      --allows the graph to be saved as a binary snapshot and loaded back
+//        with one mmap, the edges and labels are read where they lie in the
+//        file
+//      --allows a node to be found by its label
+//      --allows the table to be kept in a memory mapped file instead of
+//        memory, with narrower distances, and finished after a crash
 //
 // Implementation and assumptions:
-//      --uses an array of NodeData objects to store text information about the
-//        nodes
-//      --uses a 2D array (adjacency matrix) to hold the 'cost array' showing
-//        the length of edges between nodes in the graph
-//      --uses an internal struct TableType to store data used for Dijkstra's
-//        algorithm (a 2D array of these structs holds data for the whole graph)
+//      --uses a LabelStore to hold the text information about the nodes end
+//        to end in one arena, with a hash index from a label to its node
+//      --uses a CSRGraph (compressed sparse rows) to hold the length of edges
+//        between nodes in the graph, sized from the number of nodes and edges
+//        read by buildGraph, so memory grows with the edges instead of nodes^2
+//      --uses a PathRow per source to store data used for Dijkstra's
+//        algorithm (a vector of these rows holds data for the whole graph, it
+//        is only allocated once findShortestPath is called), each row keeps
+//        distances and previous nodes in separate arrays, previous nodes in
+//        16 bits when there are fewer than 65536 nodes
+//      --whether a node has been visited is only needed while its row is
+//        being searched, so it is kept in a per-worker BitArray, not the table
+//      --Dijkstra's algorithm runs once per source node, the next node is taken
+//        from a binary heap, a 4-ary heap, a pairing heap or a linear scan of
+//        the table (the heap type is a template parameter of the search)
+//      --each source only writes its own row of the table, so with more than
+//        one thread the sources are spread over a work-stealing ThreadPool,
+//        each worker has its own cache-line aligned heaps, and the table is
+//        identical to the one built on a single thread
+//      --Floyd-Warshall finds every distance at once (see FloydWarshall), each
+//        row's previous nodes are then taken from the distances, for a node
+//        the last node Dijkstra's algorithm would finish with an edge on a
+//        shortest path into it, so the table is identical to Dijkstra's
+//      --DELTA_STEPPING runs one source at a time with DeltaStepping, whose
+//        buckets of each source are spread over the threads, delta is set
+//        with setDelta or picked from the edge lengths, the previous nodes
+//        are then taken from the distances as for Floyd-Warshall
+//      --Floyd-Warshall and delta-stepping are only used when every edge
+//        length is positive, otherwise Dijkstra's algorithm runs even if it
+//        was asked for
+//      --in lazy mode the rows are kept in a RowCache (least recently used)
+//        sized from a memory budget instead of the full table, findShortestPath
+//        only empties the cache, and distance and displayAll run Dijkstra
+//        for a source the first time its row is needed, display only reads
+//        rows already cached and otherwise runs its own pair search
+//      --on insertEdge, a row only changes if the new edge shortens the path
+//        to its destination, the improvement is then spread from there with
+//        a small Dijkstra search
+//      --on removeEdge, a row only changes if the edge is in its shortest
+//        path tree, the subtree under the edge is cleared and found again from
+//        the edges into it (Ramalingam-Reps), using a reverse CSRGraph that is
+//        built on the first removal or display search and kept in step after
+//        that
+//      --repaired distances match a full recompute, on paths of equal length
+//        a repaired row may keep a different previous node
+//      --display uses the row of the table or cache when there is one,
+//        otherwise it runs a bidirectional Dijkstra search, forward from the
+//        origin over the cost array and backward from the destination over
+//        the reverse cost array, until the two searches meet
+//      --the forward search of display is then carried on, skipping nodes
+//        the backward search shows cannot be on a shortest path, until it
+//        finishes the destination, so the path printed is the same one the
+//        full table would hold
+//      --in LANDMARKS mode, display runs Dijkstra's algorithm from the origin
+//        instead, and skips expanding any node whose distance plus the
+//        landmark lower bound to the destination (see Landmarks) is more
+//        than the best known path, as A* would, but nodes still finish in
+//        Dijkstra's order so the path printed is the table's
+//      --landmarks only hold for the edges they were found on, buildGraph,
+//        insertEdge and removeEdge drop them, with none held the LANDMARKS
+//        search is plain Dijkstra stopped at the destination
+//      --in CONTRACTION mode, display asks the ContractionHierarchy for the
+//        path, which is a shortest path but on paths of equal length may not
+//        be the one the table holds, buildGraph, insertEdge and removeEdge
+//        drop the hierarchy and display uses the bidirectional search until
+//        it is built again
+//      --with a table file set, findShortestPath runs Dijkstra's algorithm
+//        per source as usual but stores each row into a PathTable and drops
+//        it, so only a row per worker is held in memory, displayAll, display,
+//        distance and path read rows where they lie in the mapping
+//      --the table file's key is a checksum of the cost array, a file left
+//        by a run on the same graph keeps its finished rows and only the
+//        rest are found, any other file is started over
+//      --rows are committed to the file a block at a time, a crash loses at
+//        most the block being found, a row whose distances do not fit the
+//        width is left out of the file and found when it is needed
+//      --insertEdge and removeEdge close the table file, until the next
+//        findShortestPath every row is found when it is needed
+//      --a copy of the graph does not share the open table file, until its
+//        own findShortestPath opens the file again every row is found when
+//        it is needed, a move takes the open file with it
+//      --findPairs sorts the pairs by origin, each origin uses its table or
+//        cache row if there is one, otherwise one Dijkstra search fills the
+//        worker's own row, which is kept between calls so its arrays are
+//        not allocated again, the paths of the origin's pairs are read off
+//        that row, rows found this way are not added to the cache
+//      --with the parallel option the origins are spread over threadCount
+//        workers, each worker writes its paths to its own buffer and they
+//        are copied into the caller's buffer in the order of the pairs
+//      --paths are walked back from the destination over the row's previous
+//        nodes into a vector whose memory is reused, so printing a path
+//        allocates nothing once the vector is big enough
+//      --output is formatted into an OutputBuffer (64 KB, digits and padding
+//        by hand) and sent to cout in large pieces, without a flush per line,
+//        displayAll can also write to any buffer, such as one on a file
+//        descriptor
+//      --a parallel displayAll renders blocks of sources on the workers, one
+//        memory buffer per source, and writes each block out in order, it
+//        needs the full table since the lazy cache is not thread safe
+//      --inserted and removed edges are buffered by the CSRGraph and merged
+//        into it before each search, so each node's edges are walked in
+//        O(degree)
 //      --builds the graph from an input text file
 //      --assumes that the 1st line of an input file has an int n denoting the 
 //        number of nodes in the graph
@@ -28,7 +152,6 @@
 //        int data in the form: i j k
 //        for each line of text where i is the origin node, j is the destination
 //        node, and k is the length of the edge
-//      --assumes a maximum of 100 nodes
 //      --assumes no 0 nodes
 //      --assumes that three zeros on a line is the end of the file
 //----------------------------------------------------------------------------
@@ -37,26 +160,91 @@
 #define GRAPHM_H
 
 #include "nodedata.h"
+#include "csrgraph.h"
+#include "dheap.h"
+#include "pairingheap.h"
+#include "threadpool.h"
+#include "rowcache.h"
+#include "floydwarshall.h"
+#include "deltastepping.h"
+#include "landmarks.h"
+#include "contractionhierarchy.h"
+#include "pathrow.h"
+#include "bitarray.h"
+#include "outputbuffer.h"
+#include "graphfile.h"
+#include "graphsnapshot.h"
+#include "labelstore.h"
+#include "pathtable.h"
+#include <algorithm>
 #include <climits>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include <string>
 #include <sstream>
-#include <stack>
+#include <vector>
 
 using namespace std;
 
-const int MAXNODES = 100;
-
 class GraphM {
 public:
+    // Priority queue used to pick the next node in Dijkstra's algorithm
+    enum HeapType { LINEAR_SCAN, BINARY_HEAP, FOUR_ARY_HEAP, PAIRING_HEAP };
+
+    // Algorithm findShortestPath fills the table with, AUTO picks by density
+    enum EngineType { AUTO, DIJKSTRA, FLOYD_WARSHALL, DELTA_STEPPING };
+
+    // Search display runs when it has no row for the origin
+    enum PairType { BIDIRECTIONAL, LANDMARKS, CONTRACTION };
+
+    // Memory for cached rows in lazy mode unless another budget is given
+    static const size_t DEFAULT_ROW_BUDGET = 64 << 20;
+
+    // Pair of nodes asked for by findPairs
+    struct PairQuery {
+        int from;               // origin node
+        int to;                 // destination node
+    };
+
+    // Answers of findPairs, in the order the pairs were given
+    struct PairResults {
+        vector<int> distance;   // shortest distance, INT_MAX if no path
+        vector<int> pathStart;  // first entry of each path in nodes, with
+                                // one more entry than pairs at the end
+        vector<int> nodes;      // every path, origin to destination
+    };
+
+    // Work done by an insertEdge or removeEdge to keep the rows current
+    struct UpdateStats {
+        int rowsTouched;        // rows with at least one entry changed
+        long entriesTouched;    // entries whose distance or path changed
+    };
+
 //----------------------------------------------------------------------------
 // Default constructor
 // Preconditions:   None
-// Postconditions:  Cost array and Dijkstra table are initalized with
-//                  infinite (INT_MAX) and 0 values, size is set to 0
+// Postconditions:  Graph has no edges and no Dijkstra table, size is set to 0
     GraphM();
 
+//----------------------------------------------------------------------------
+// Copy constructor, operator=
+// Preconditions:   None
+// Postconditions:  Graph holds the other's nodes, edges, settings and rows
+//                  found, but not its open table file
+    GraphM(const GraphM&) = default;
+    GraphM& operator=(const GraphM&) = default;
+
+//----------------------------------------------------------------------------
+// Move constructor, move operator=
+// Preconditions:   None
+// Postconditions:  Graph holds what the other held, its open table file
+//                  included
+    GraphM(GraphM&&) = default;
+    GraphM& operator=(GraphM&&) = default;
+
 //----------------------------------------------------------------------------
 // buildGraph
 // Preconditions:   istream object passed as parameter is correctly formatted as
@@ -64,27 +252,214 @@ public:
 // Postconditions:  istream is read and Graph is now filled with data on nodes
     void buildGraph(istream&);
 
+//----------------------------------------------------------------------------
+// buildGraph
+// Preconditions:   Text held by the GraphFile is formatted as detailed at the
+//                  top of this file
+// Postconditions:  Next graph of the file is read and Graph is filled with
+//                  its data, returns false and leaves Graph empty if the file
+//                  holds no more graphs
+    bool buildGraph(GraphFile&);
+
+//----------------------------------------------------------------------------
+// saveSnapshot
+// Preconditions:   None
+// Postconditions:  Nodes, labels and edges are written to a snapshot file,
+//                  returns false if it could not be written
+    bool saveSnapshot(const string&);
+
+//----------------------------------------------------------------------------
+// loadSnapshot
+// Preconditions:   None
+// Postconditions:  Returns true and Graph holds the graph of the snapshot,
+//                  its edges read in place from the mapped file, the whole
+//                  file is checked against its checksum if asked, otherwise
+//                  returns false and Graph is empty
+    bool loadSnapshot(const string&, bool = true);
+
+//----------------------------------------------------------------------------
+// label
+// Preconditions:   Node is in the graph
+// Postconditions:  Returns the text information of the node, valid until the
+//                  graph is built again
+    string_view label(int) const;
+
+//----------------------------------------------------------------------------
+// findNode
+// Preconditions:   None
+// Postconditions:  Returns the lowest node whose text information is the
+//                  parameter, 0 if there is none
+    int findNode(string_view);
+
 //----------------------------------------------------------------------------
 // insertEdge
 // Preconditions:   None
 // Postconditions:  Returns false if invalid parameters or a duplicate edge
-//                  otherwise adds the edge and returns true
+//                  otherwise adds the edge and returns true, rows already
+//                  found are updated for the new edge
     bool insertEdge(int, int, int);
 
 //----------------------------------------------------------------------------
 // removeEdge
 // Preconditions:   None
-// Postconditions:  None    
+// Postconditions:  Returns false if invalid parameters or no such edge
+//                  otherwise removes the edge and returns true, rows already
+//                  found are updated for the missing edge
     bool removeEdge(int, int);
 
+//----------------------------------------------------------------------------
+// setUpdateHook
+// Preconditions:   None
+// Postconditions:  Function is called with the work done after every
+//                  successful insertEdge or removeEdge
+    void setUpdateHook(function<void(const UpdateStats&)>);
+
+//----------------------------------------------------------------------------
+// lastUpdate
+// Preconditions:   None
+// Postconditions:  Returns the work done by the last successful insertEdge or
+//                  removeEdge
+    UpdateStats lastUpdate() const;
+
 //----------------------------------------------------------------------------
 // findShortestPath
 // Preconditions:   Graph has been filled with nodes, Dijkstra table is in its
 //                  reset state (only 0's and infinities)
 // Postconditions:  Dijkstra table is filled with the shortest paths between
-//                  every node pairing in the Graph
+//                  every node pairing in the Graph, in lazy mode the row
+//                  cache is emptied instead and rows are found when needed,
+//                  with a table file set the rows not already in the file
+//                  are found and stored there instead
     bool findShortestPath();
 
+//----------------------------------------------------------------------------
+// setTableFile
+// Preconditions:   None
+// Postconditions:  Returns false if the width is not 1, 2 or 4, otherwise
+//                  later calls to findShortestPath keep the table in the file
+//                  at the path with distances of that many bytes, in place
+//                  of memory and of lazy mode, an empty path keeps it in
+//                  memory again, any table or table file held is dropped
+    bool setTableFile(const string&, int = 4);
+
+//----------------------------------------------------------------------------
+// resumedRows
+// Preconditions:   None
+// Postconditions:  Returns the number of rows the last findShortestPath
+//                  found already done in the table file
+    int resumedRows() const;
+
+//----------------------------------------------------------------------------
+// setLazy
+// Preconditions:   None
+// Postconditions:  Turns lazy mode on or off, in lazy mode rows are found on
+//                  demand and at most the budget's bytes of rows are kept,
+//                  any table or cached rows are dropped
+    void setLazy(bool, size_t = DEFAULT_ROW_BUDGET);
+
+//----------------------------------------------------------------------------
+// distance
+// Preconditions:   findShortestPath has been called, or lazy mode is on
+// Postconditions:  Returns the shortest distance from parameter node 1 to
+//                  parameter node 2, INT_MAX if there is no path
+    int distance(int, int);
+
+//----------------------------------------------------------------------------
+// path
+// Preconditions:   None
+// Postconditions:  Returns the shortest distance from node 1 to node 2 and
+//                  the vector holds the nodes of the path display would
+//                  print, returns INT_MAX and an empty vector if there is no
+//                  path, the vector's memory is reused
+    int path(int, int, vector<int>&);
+
+//----------------------------------------------------------------------------
+// findPairs
+// Preconditions:   Array holds the given number of pairs
+// Postconditions:  Results hold the shortest distance and path of every
+//                  pair, a pair with a node not in the graph or no path has
+//                  INT_MAX and an empty path, origins are spread over
+//                  threadCount workers if the last parameter is true
+    void findPairs(const PairQuery*, int, PairResults&, bool = false);
+
+//----------------------------------------------------------------------------
+// setHeapType
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath use the given priority
+//                  queue, the default is BINARY_HEAP
+    void setHeapType(HeapType);
+
+//----------------------------------------------------------------------------
+// settledCount
+// Preconditions:   None
+// Postconditions:  Returns the number of nodes settled by the last search
+//                  display ran for a pair of nodes, 0 if it used a row
+    int settledCount() const;
+
+//----------------------------------------------------------------------------
+// setPairSearch
+// Preconditions:   None
+// Postconditions:  Later calls to display without a row use the given
+//                  search, the default is BIDIRECTIONAL
+    void setPairSearch(PairType);
+
+//----------------------------------------------------------------------------
+// buildLandmarks
+// Preconditions:   Graph has been built
+// Postconditions:  Up to the given number of landmarks are chosen by the
+//                  method and their distances found
+    void buildLandmarks(int, Landmarks::Method = Landmarks::AVOID);
+
+//----------------------------------------------------------------------------
+// saveLandmarks
+// Preconditions:   None
+// Postconditions:  Landmarks are written to the stream, returns false if the
+//                  stream failed
+    bool saveLandmarks(ostream&) const;
+
+//----------------------------------------------------------------------------
+// loadLandmarks
+// Preconditions:   Graph has been built
+// Postconditions:  Returns true and holds the landmarks from the stream if
+//                  they were saved for this graph's edges, otherwise returns
+//                  false and holds none
+    bool loadLandmarks(istream&);
+
+//----------------------------------------------------------------------------
+// landmarkCount
+// Preconditions:   None
+// Postconditions:  Returns the number of landmarks held
+    int landmarkCount() const;
+
+//----------------------------------------------------------------------------
+// buildHierarchy
+// Preconditions:   Graph has been built
+// Postconditions:  Contraction hierarchy is built for the graph's edges, on
+//                  threadCount threads
+    void buildHierarchy();
+
+//----------------------------------------------------------------------------
+// setDelta
+// Preconditions:   None
+// Postconditions:  Later DELTA_STEPPING runs use buckets of the given width,
+//                  0 or less picks it from the edge lengths, the default
+    void setDelta(int);
+
+//----------------------------------------------------------------------------
+// setEngine
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath use the given algorithm,
+//                  the default is AUTO
+    void setEngine(EngineType);
+
+//----------------------------------------------------------------------------
+// setThreadCount
+// Preconditions:   None
+// Postconditions:  Later calls to findShortestPath spread the sources over
+//                  the given number of threads, 0 or less uses every hardware
+//                  thread, the default is 1
+    void setThreadCount(int);
+
 //----------------------------------------------------------------------------
 // displayAll
 // Preconditions:   Dijkstra's algorithm has been correctly executed on the
@@ -95,6 +470,15 @@ public:
 //                  out to the console
     void displayAll();
 
+//----------------------------------------------------------------------------
+// displayAll
+// Preconditions:   Same as displayAll to the console
+// Postconditions:  Same text displayAll prints to the console is written to
+//                  the buffer and flushed, rows are rendered on threadCount
+//                  workers if the last parameter is true and the table is
+//                  filled
+    void displayAll(OutputBuffer&, bool = false);
+
 //----------------------------------------------------------------------------
 // display
 // Preconditions:   Dijkstra's algorithm has been correctly executed on the
@@ -105,32 +489,177 @@ public:
 //                  out to the console
     void display(int, int);
 
+//----------------------------------------------------------------------------
+// display
+// Preconditions:   Same as display to the console
+// Postconditions:  Same text display prints to the console is written to the
+//                  buffer and flushed
+    void display(OutputBuffer&, int, int);
+
 private:
-    struct TableType {
-        bool visited;   // whether node has been visited
-        int dist;       // currently known shortest distance from source
-        int path;       // previous node in path of min dist
+    struct alignas(64) SearchScratch {
+        BinaryHeap binaryHeap;          // queue for BINARY_HEAP
+        FourAryHeap fourAryHeap;        // queue for FOUR_ARY_HEAP
+        PairingHeap pairingHeap;        // queue for PAIRING_HEAP
+        BitArray visited;               // nodes finished by the search
+        vector<char> mark;              // nodes under a removed edge
+        vector<int> affected;           // list of the marked nodes
+        UpdateStats work;               // work done by this worker
+        PathRow row;                    // row of findPairs' last origin
+        vector<int> route;              // paths found by findPairs
+    };
+    struct PairSearch {
+        PathRow forward;                // distance and path from the origin
+        vector<int> backward;           // distance to the destination
+        BitArray forwardDone;           // nodes settled going forward
+        BitArray backwardDone;          // nodes settled going backward
+        BinaryHeap forwardHeap;         // queue of the forward search
+        BinaryHeap backwardHeap;        // queue of the backward search
+        vector<int> touched;            // nodes to reset before next search
+        vector<int> route;              // nodes of a hierarchy path
+        int settled;                    // nodes settled by the last search
+    };
+    // Open table file, a copy of the graph starts with none open
+    struct OpenTable : PathTable {
+        OpenTable() = default;
+        OpenTable(const OpenTable&) : PathTable() {}
+        OpenTable(OpenTable&&) = default;
+        OpenTable& operator=(const OpenTable&) {
+            close();
+            return *this;
+        }
+        OpenTable& operator=(OpenTable&&) = default;
     };
-    NodeData data[MAXNODES];            // data for graph nodes information
-    int C[MAXNODES][MAXNODES];          // Cost array, the adjacency matrix
+    struct BatchSpace {
+        vector<int> order;              // valid pairs sorted by origin
+        vector<int> groups;             // first entry in order per origin
+        vector<const PathRow*> rows;    // row already held per origin
+        vector<int> worker;             // worker holding each pair's path
+        vector<int> offset;             // start of the path in its route
+    };
+    LabelStore labels;                  // text information of each node
+    CSRGraph C;                         // Cost array, the edges by origin
+    shared_ptr<GraphSnapshot> snapshot; // mapped file C reads, if loaded
+    CSRGraph R;                         // Reverse cost array, by destination
+    bool haveReverse;                   // whether R has been built
     int size;                           // number of ndoes in the graph
-    TableType T[MAXNODES][MAXNODES];    // stores Dijkstra information
+    vector<PathRow> T;                  // stores Dijkstra information
+    OpenTable table;                    // rows in the table file, if open
+    string tablePath;                   // table file, empty for memory
+    int tableWidth;                     // bytes of a distance in the file
+    int resumed;                        // rows already in the file
+    HeapType heapType;                  // queue used by findShortestPath
+    EngineType engine;                  // algorithm used by findShortestPath
+    int delta;                          // bucket width of DELTA_STEPPING
+    int threadCount;                    // threads used by findShortestPath
+    shared_ptr<ThreadPool> pool;        // workers, made when threadCount > 1
+    vector<SearchScratch> scratch;      // per-worker search space
+    PairSearch query;                   // search space of display
+    BatchSpace batch;                   // bookkeeping of findPairs
+    vector<int> route;                  // path being printed by display
+    PairType pairType;                  // search display runs without a row
+    Landmarks marks;                    // lower bounds for LANDMARKS
+    ContractionHierarchy hierarchy;     // index for CONTRACTION
+    bool lazy;                          // whether rows are found on demand
+    size_t rowBudget;                   // bytes of rows kept in lazy mode
+    RowCache<PathRow> cache;            // rows found so far in lazy mode
+    UpdateStats updateStats;            // work of the last edge update
+    function<void(const UpdateStats&)> updateHook;  // told of each update
 
 //----------------------------------------------------------------------------
-// initC
-// Preconditions:   Cost array holds either garbage data or data from a 
-//                  previously built graph
-// Postconditions:  Cost array is reset to only holding infinite values
-    void initC(); // Initializes cost array
+// resetGraph
+// Preconditions:   None
+// Postconditions:  Graph has no nodes, no edges and nothing found from them
+    void resetGraph();
 
 //----------------------------------------------------------------------------
 // initT
-// Preconditions:   Dijkstra table holds either garbage data or data from a 
-//                  previously built graph
-// Postconditions:  Dijkstra table is reset, all distances are set to infinity,
-//                  all visited are set to false, and all paths are set to 0
+// Preconditions:   Dijkstra table is empty or holds data from a previously
+//                  built graph
+// Postconditions:  Dijkstra table is sized for the graph and reset, all
+//                  distances are set to infinity except each source's
+//                  distance to itself, which is 0, and all paths are set to 0
     void initT(); // Initializes dijkstra array
 
+//----------------------------------------------------------------------------
+// row
+// Preconditions:   None
+// Postconditions:  Returns the Dijkstra row for the source, found now if
+//                  in lazy mode and not cached, or if a table file is set
+//                  and the row is not in it, nullptr if the source is not
+//                  in the graph or findShortestPath has not filled the table
+    const PathRow* row(int);
+
+//----------------------------------------------------------------------------
+// inTable
+// Preconditions:   None
+// Postconditions:  Returns true if the source's row is done in the open
+//                  table file
+    bool inTable(int) const;
+
+//----------------------------------------------------------------------------
+// fillTable
+// Preconditions:   Table file is set, cost array is merged
+// Postconditions:  Table file is open for the graph and holds every row whose
+//                  distances fit its width, returns false if it could not be
+//                  opened or written
+    bool fillTable();
+
+//----------------------------------------------------------------------------
+// graphKey
+// Preconditions:   Cost array is merged
+// Postconditions:  Returns a checksum of the node count and every edge
+    uint64_t graphKey() const;
+
+//----------------------------------------------------------------------------
+// pairRow
+// Preconditions:   None
+// Postconditions:  Returns a row whose path to node 2 from node 1 is the
+//                  one the full table would hold, the table or cache row if
+//                  there is one, else the row of a pair search, nullptr if
+//                  either node is not in the graph
+    const PathRow* pairRow(int, int);
+
+//----------------------------------------------------------------------------
+// pairSearch
+// Preconditions:   Nodes are in the graph
+// Postconditions:  Returns the forward row of a bidirectional search from
+//                  node 1 to node 2, only the entries on the shortest paths
+//                  to node 2 are meaningful, its distance is INT_MAX if
+//                  there is no path
+    const PathRow* pairSearch(int, int);
+
+//----------------------------------------------------------------------------
+// landmarkSearch
+// Preconditions:   Nodes are in the graph
+// Postconditions:  Returns the row of a Dijkstra search from node 1 that
+//                  only expands nodes the landmarks allow on a shortest path
+//                  to node 2, only the entries on those paths are
+//                  meaningful, its distance is INT_MAX if there is no path
+    const PathRow* landmarkSearch(int, int);
+
+//----------------------------------------------------------------------------
+// hierarchySearch
+// Preconditions:   Nodes are in the graph, hierarchy is built
+// Postconditions:  Returns a row holding the path the hierarchy finds from
+//                  node 1 to node 2, only the entries on that path are
+//                  meaningful, its distance is INT_MAX if there is no path
+    const PathRow* hierarchySearch(int, int);
+
+//----------------------------------------------------------------------------
+// resetQuery
+// Preconditions:   None
+// Postconditions:  Search space of display is sized for the graph and holds
+//                  no distances, only the entries touched last time are
+//                  cleared unless the graph changed size
+    void resetQuery();
+
+//----------------------------------------------------------------------------
+// reverseEdges
+// Preconditions:   Cost array is merged
+// Postconditions:  Reverse cost array is built if it was not and is merged
+    void reverseEdges();
+
 //----------------------------------------------------------------------------
 // min
 // Preconditions:   None
@@ -140,28 +669,136 @@ private:
 //----------------------------------------------------------------------------
 // findV
 // Preconditions:   Should only be called within the Dijkstra algorithm function
-//                  assumes meaningful data in the Dijkstra table
+//                  assumes meaningful data in the Dijkstra table row
 // Postconditions:  Returns the index for the unvisited node with the minimum
-//                  distance from the parameter node
-    int findV(int);       // Finds not yet visited node with min dist
+//                  distance from the row's source node
+    int findV(const PathRow&, const BitArray&); // Finds unvisited min node
+
+//----------------------------------------------------------------------------
+// useFloydWarshall
+// Preconditions:   Cost array is merged
+// Postconditions:  Returns true if findShortestPath should fill the table
+//                  with Floyd-Warshall rather than Dijkstra's algorithm
+    bool useFloydWarshall() const;
+
+//----------------------------------------------------------------------------
+// pathsFromDistances
+// Preconditions:   Row for the source holds its shortest distances and no
+//                  previous nodes, every edge length is positive
+// Postconditions:  Row holds the previous nodes Dijkstra's algorithm would
+//                  have picked
+    void pathsFromDistances(int, PathRow&);
+
+//----------------------------------------------------------------------------
+// workers
+// Preconditions:   None
+// Postconditions:  Returns the pool of threadCount workers, made now if
+//                  needed, nullptr when threadCount is 1
+    ThreadPool* workers();
+
+//----------------------------------------------------------------------------
+// runTasks
+// Preconditions:   None
+// Postconditions:  task(index, worker) has run for every index from begin up
+//                  to end, spread over threadCount workers, scratch holds one
+//                  entry per worker
+    void runTasks(int, int, const function<void(int, int)>&);
+
+//----------------------------------------------------------------------------
+// maintainRows
+// Preconditions:   Edge from node 1 to node 2 has already changed length in
+//                  the cost array, from the old to the new length parameter
+// Postconditions:  Every row in the table or the cache is updated for the
+//                  change, updateStats holds the work done, hook is called
+    void maintainRows(int, int, int, int);
+
+//----------------------------------------------------------------------------
+// repairDecrease
+// Preconditions:   Row is current except for the edge from node 1 to node 2
+//                  becoming the given shorter length, cost array is merged
+// Postconditions:  Row is current, returns the number of entries changed
+    long repairDecrease(PathRow&, int, int, int, SearchScratch&);
+
+//----------------------------------------------------------------------------
+// repairIncrease
+// Preconditions:   Row is current except for the edge from node 1 to node 2
+//                  becoming longer or removed, cost array and reverse cost
+//                  array are merged
+// Postconditions:  Row is current, returns the number of entries changed
+    long repairIncrease(PathRow&, int, int, SearchScratch&);
+
+//----------------------------------------------------------------------------
+// searchSource
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled by the search for heapType,
+//                  using the scratch parameter for its queue
+    void searchSource(int, PathRow&, SearchScratch&);
+
+//----------------------------------------------------------------------------
+// scanSearch
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled using findV to pick each node,
+//                  the bit array is left holding the visited nodes
+    void scanSearch(PathRow&, BitArray&);
+
+//----------------------------------------------------------------------------
+// heapSearch
+// Preconditions:   Row for the source is in its reset state with the source
+//                  distance set to 0, cost array is merged
+// Postconditions:  Row for the source is filled using the heap parameter to
+//                  pick each node, the row is identical to scanSearch's, the
+//                  bit array is left holding the visited nodes
+    template <class Heap>
+    void heapSearch(int, PathRow&, Heap&, BitArray&);
+
+//----------------------------------------------------------------------------
+// walkPath
+// Preconditions:   Row's path values to the node are meaningful, Row is a
+//                  PathRow or a PathTable::Row
+// Postconditions:  Vector holds each node visited on the shortest path from
+//                  the row's source to the parameter node, in order, its
+//                  memory is reused so no allocation is made once it is big
+//                  enough
+    template <class Row>
+    void walkPath(const Row&, int, vector<int>&) const;
+
+//----------------------------------------------------------------------------
+// renderRow
+// Preconditions:   Row is the source's or nullptr, vector is not used by
+//                  another thread
+// Postconditions:  Source's block of displayAll is written to the buffer
+    template <class Row>
+    void renderRow(OutputBuffer&, int, const Row*, vector<int>&);
+
+//----------------------------------------------------------------------------
+// renderPair
+// Preconditions:   Row is node 1's or nullptr, node 2 is in the graph
+// Postconditions:  Distance and paths display prints after the two nodes are
+//                  written to the buffer, or "---" if there is no path
+    template <class Row>
+    void renderPair(OutputBuffer&, const Row*, int);
 
 //----------------------------------------------------------------------------
-// pathToString
+// printPath
 // Preconditions:   Should only be called within the display functions, assumes
-//                  that the Dijkstra algorithm has been perfomed on the graph
-//                  and that path values are meaningful
-// Postconditions:  Returns a string of each node visited on the shortest path
-//                  from parameter node 1 to parameter node 2
-    string pathToString(int, int); // Makes a path between nodes into a string
+//                  that the row's path values to the node are meaningful
+// Postconditions:  Each node visited on the shortest path from the row's
+//                  source to the parameter node is written to the buffer,
+//                  each followed by a space, the vector is used to walk it
+    template <class Row>
+    void printPath(OutputBuffer&, const Row&, int, vector<int>&);
 
 //----------------------------------------------------------------------------
-// detailedPathToString
+// printDetailedPath
 // Preconditions:   Should only be called within the display function, assumes
-//                  that the Dijkstra algorithm has been perfomed on the graph
-//                  and that path values are meaningful
-// Postconditions:  Returns a string of the information of each node visited on
-//                  the shortest path from parameter node 1 to parameter node 2
-    string detailedPathToString(int, int); // Makes a detailed path string
+//                  that the row's path values to the node are meaningful
+// Postconditions:  The information of each node visited on the shortest path
+//                  from the row's source to the parameter node is written to
+//                  the buffer, one node per line, the vector is used to walk it
+    template <class Row>
+    void printDetailedPath(OutputBuffer&, const Row&, int, vector<int>&);
 };
 
 #endif
\ No newline at end of file
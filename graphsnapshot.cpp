@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------
+// GRAPHSNAPSHOT.CPP
+// Implementation for GraphSnapshot Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// GraphSnapshot: stores the nodes, labels and edges of a graph in a file
+// and allows other features:
+//      --writing a graph from its edge arrays and labels
+//      --opening a snapshot with one mmap, the edge and label arrays are
+//        used where they lie in the file with nothing parsed or copied
+//      --checking the whole file against its checksum, or only its header
+//
+// Implementation and assumptions:
+//      --the file is a header followed by 5 sections, each starting on an 8
+//        byte boundary and padded with zeros: the offsets (node count + 2
+//        ints), targets and weights (edge count ints each) of compressed
+//        sparse rows, where each label starts in the label text (node count
+//        + 2 64-bit ints), and the label text with nothing between labels
+//      --the header holds a magic number, a version, a byte order marker,
+//        the kind of graph, the counts, a checksum of the sections and a
+//        checksum of the header, a file written on a machine of the other
+//        byte order or by another version is refused
+//      --WEIGHTED snapshots have each node's edges sorted by destination, as
+//        a CSRGraph holds them, LISTS snapshots have them in the order of an
+//        adjacency list and no weights
+//      --open always checks the header and that the sections fit the file,
+//        the sections are only read for their checksum when asked to, an
+//        unchecked file is trusted
+//      --node ids are in the range 1 to the node count, node 0 is not used
+//----------------------------------------------------------------------------
+
+#include "graphsnapshot.h"
+#include "outputbuffer.h"
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Zeros written after a section to bring the next one to an 8 byte boundary
+static const char PADDING[8] = { 0 };
+
+//----------------------------------------------------------------------------
+// padded
+// Preconditions:   None
+// Postconditions:  Returns the bytes rounded up to a multiple of 8
+static size_t padded(size_t bytes) {
+    return (bytes + 7) & ~(size_t)7;
+}
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No snapshot is open
+GraphSnapshot::GraphSnapshot() : base(nullptr), bytes(0) {
+    memset(&header, 0, sizeof(header));
+    memset(&layout, 0, sizeof(layout));
+}
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  File is unmapped
+GraphSnapshot::~GraphSnapshot() {
+    close();
+}
+
+//----------------------------------------------------------------------------
+// write
+// Preconditions:   Offsets has node count + 2 entries, targets and weights
+//                  have as many as its last entry, weights is nullptr for
+//                  LISTS, labels holds node count labels
+// Postconditions:  Snapshot of the graph is written to the file, returns
+//                  false if it could not be written
+bool GraphSnapshot::write(const string& path, Kind kind, int nodes,
+                          const int* offsets, const int* targets,
+                          const int* weights, const LabelStore& labels) {
+
+    Header head;
+    memset(&head, 0, sizeof(head));
+    head.magic = MAGIC;
+    head.version = VERSION;
+    head.order = ORDER_MARK;
+    head.kind = kind;
+    head.nodes = nodes;
+    head.edges = offsets[nodes + 1];
+    head.labelBytes = labels.textBytes();
+
+    const char* sections[5] = {
+        (const char*)offsets, (const char*)targets,
+        kind == WEIGHTED ? (const char*)weights : nullptr,
+        (const char*)labels.startData(), labels.textData()
+    };
+    size_t lengths[5] = {
+        (nodes + 2) * sizeof(int), head.edges * sizeof(int),
+        kind == WEIGHTED ? head.edges * sizeof(int) : 0,
+        (nodes + 2) * sizeof(int64_t), labels.textBytes()
+    };
+    uint64_t sum = HASH_BASIS;
+    for(int s = 0; s < 5; s++) {
+        sum = hash(sum, sections[s], lengths[s]);
+    }
+    head.checksum = sum;
+    head.headerSum = hash(HASH_BASIS, (const char*)&head,
+                          offsetof(Header, headerSum));
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+        return false;
+    }
+    bool written;
+    {
+        OutputBuffer out(fd);
+        out.write((const char*)&head, sizeof(head));
+        for(int s = 0; s < 5; s++) {
+            out.write(sections[s], lengths[s]);
+            out.write(PADDING, padded(lengths[s]) - lengths[s]);
+        }
+        out.flush();
+        written = out.good();
+    }
+    return ::close(fd) == 0 && written;
+}
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   None
+// Postconditions:  Returns true and holds the mapped snapshot if its header
+//                  is sound and its sections fit the file, and when asked
+//                  to, its sections match the checksum, otherwise returns
+//                  false and holds none
+bool GraphSnapshot::open(const string& path, bool check) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* start = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(start == MAP_FAILED) {
+        return false;
+    }
+    base = (const char*)start;
+    bytes = info.st_size;
+    memcpy(&header, base, sizeof(header));
+
+    // Header first, nothing else can be trusted until it is
+    bool sound = header.magic == MAGIC && header.version == VERSION &&
+                 header.order == ORDER_MARK &&
+                 header.headerSum == hash(HASH_BASIS, base,
+                                          offsetof(Header, headerSum)) &&
+                 (header.kind == WEIGHTED || header.kind == LISTS) &&
+                 header.nodes >= 0 && header.nodes < INT_MAX - 1 &&
+                 header.edges >= 0 && header.edges <= INT_MAX &&
+                 header.labelBytes >= 0;
+    if(sound) {
+        layout = plan((Kind)header.kind, header.nodes, header.edges,
+                      header.labelBytes);
+        const int64_t* starts = (const int64_t*)(base + layout.labelStarts);
+        sound = layout.total == bytes && offsets()[0] == 0 &&
+                offsets()[header.nodes + 1] == header.edges &&
+                starts[header.nodes + 1] == header.labelBytes;
+    }
+    if(sound && check) {
+        sound = hash(HASH_BASIS, base + layout.offsets,
+                     bytes - layout.offsets) == header.checksum;
+    }
+    if(!sound) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No snapshot is open, the file is unmapped
+void GraphSnapshot::close() {
+    if(base != nullptr) {
+        munmap((void*)base, bytes);
+    }
+    base = nullptr;
+    bytes = 0;
+    memset(&header, 0, sizeof(header));
+    memset(&layout, 0, sizeof(layout));
+}
+
+//----------------------------------------------------------------------------
+// kind, nodeCount, edgeCount
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the kind and counts of the graph
+GraphSnapshot::Kind GraphSnapshot::kind() const {
+    return (Kind)header.kind;
+}
+int GraphSnapshot::nodeCount() const {
+    return header.nodes;
+}
+int GraphSnapshot::edgeCount() const {
+    return header.edges;
+}
+
+//----------------------------------------------------------------------------
+// offsets, targets, weights
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the edge arrays in the mapped file, weights is
+//                  nullptr for LISTS
+const int* GraphSnapshot::offsets() const {
+    return (const int*)(base + layout.offsets);
+}
+const int* GraphSnapshot::targets() const {
+    return (const int*)(base + layout.targets);
+}
+const int* GraphSnapshot::weights() const {
+    return header.kind == WEIGHTED ? (const int*)(base + layout.weights)
+                                   : nullptr;
+}
+
+//----------------------------------------------------------------------------
+// labelStarts, labelText
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the label arrays in the mapped file, laid out as a
+//                  LabelStore can view them
+const int64_t* GraphSnapshot::labelStarts() const {
+    return (const int64_t*)(base + layout.labelStarts);
+}
+const char* GraphSnapshot::labelText() const {
+    return base + layout.labels;
+}
+
+//----------------------------------------------------------------------------
+// fileBytes
+// Preconditions:   None
+// Postconditions:  Returns the size of the open file, 0 if none
+size_t GraphSnapshot::fileBytes() const {
+    return bytes;
+}
+
+//----------------------------------------------------------------------------
+// plan
+// Preconditions:   Counts are not negative
+// Postconditions:  Returns where each section of a file with the counts is
+GraphSnapshot::Layout GraphSnapshot::plan(Kind kind, int nodes, int64_t edges,
+                                          int64_t labelBytes) {
+    Layout where;
+    where.offsets = sizeof(Header);
+    where.targets = where.offsets + padded((nodes + 2) * sizeof(int));
+    where.weights = where.targets + padded(edges * sizeof(int));
+    where.labelStarts = where.weights +
+                        (kind == WEIGHTED ? padded(edges * sizeof(int)) : 0);
+    where.labels = where.labelStarts + (nodes + 2) * sizeof(int64_t);
+    where.total = where.labels + padded(labelBytes);
+    return where;
+}
+
+//----------------------------------------------------------------------------
+// hash
+// Preconditions:   None
+// Postconditions:  Returns the running checksum with the bytes added, taken
+//                  8 at a time, a last part shorter than 8 is padded with 0
+uint64_t GraphSnapshot::hash(uint64_t sum, const char* text, size_t length) {
+    // FNV-1a on 64-bit words instead of bytes, 8 times fewer multiplies
+    const uint64_t PRIME = 0x100000001b3ULL;
+    size_t whole = length & ~(size_t)7;
+    for(size_t i = 0; i < whole; i += 8) {
+        uint64_t word;
+        memcpy(&word, text + i, 8);
+        sum = (sum ^ word) * PRIME;
+    }
+    if(whole < length) {
+        uint64_t word = 0;
+        memcpy(&word, text + whole, length - whole);
+        sum = (sum ^ word) * PRIME;
+    }
+    return sum;
+}
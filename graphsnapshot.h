@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------------
+// GRAPHSNAPSHOT.H
+// Class for a binary snapshot of a graph, read in place from a mapped file
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// GraphSnapshot: stores the nodes, labels and edges of a graph in a file
+// and allows other features:
+//      --writing a graph from its edge arrays and labels
+//      --opening a snapshot with one mmap, the edge and label arrays are
+//        used where they lie in the file with nothing parsed or copied
+//      --checking the whole file against its checksum, or only its header
+//
+// Implementation and assumptions:
+//      --the file is a header followed by 5 sections, each starting on an 8
+//        byte boundary and padded with zeros: the offsets (node count + 2
+//        ints), targets and weights (edge count ints each) of compressed
+//        sparse rows, where each label starts in the label text (node count
+//        + 2 64-bit ints), and the label text with nothing between labels
+//      --the header holds a magic number, a version, a byte order marker,
+//        the kind of graph, the counts, a checksum of the sections and a
+//        checksum of the header, a file written on a machine of the other
+//        byte order or by another version is refused
+//      --WEIGHTED snapshots have each node's edges sorted by destination, as
+//        a CSRGraph holds them, LISTS snapshots have them in the order of an
+//        adjacency list and no weights
+//      --open always checks the header and that the sections fit the file,
+//        the sections are only read for their checksum when asked to, an
+//        unchecked file is trusted
+//      --node ids are in the range 1 to the node count, node 0 is not used
+//----------------------------------------------------------------------------
+
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include "labelstore.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+class GraphSnapshot {
+public:
+    enum Kind {
+        WEIGHTED = 1,       // edges with lengths, sorted by destination
+        LISTS = 2           // edges without lengths, in adjacency list order
+    };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No snapshot is open
+    GraphSnapshot();
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  File is unmapped
+    ~GraphSnapshot();
+
+    GraphSnapshot(const GraphSnapshot&) = delete;
+    GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+
+//----------------------------------------------------------------------------
+// write
+// Preconditions:   Offsets has node count + 2 entries, targets and weights
+//                  have as many as its last entry, weights is nullptr for
+//                  LISTS, labels holds node count labels
+// Postconditions:  Snapshot of the graph is written to the file, returns
+//                  false if it could not be written
+    static bool write(const string&, Kind, int, const int*, const int*,
+                      const int*, const LabelStore&);
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   None
+// Postconditions:  Returns true and holds the mapped snapshot if its header
+//                  is sound and its sections fit the file, and when asked
+//                  to, its sections match the checksum, otherwise returns
+//                  false and holds none
+    bool open(const string&, bool = true);
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No snapshot is open, the file is unmapped
+    void close();
+
+//----------------------------------------------------------------------------
+// kind, nodeCount, edgeCount
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the kind and counts of the graph
+    Kind kind() const;
+    int nodeCount() const;
+    int edgeCount() const;
+
+//----------------------------------------------------------------------------
+// offsets, targets, weights
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the edge arrays in the mapped file, weights is
+//                  nullptr for LISTS
+    const int* offsets() const;
+    const int* targets() const;
+    const int* weights() const;
+
+//----------------------------------------------------------------------------
+// labelStarts, labelText
+// Preconditions:   A snapshot is open
+// Postconditions:  Returns the label arrays in the mapped file, laid out as a
+//                  LabelStore can view them
+    const int64_t* labelStarts() const;
+    const char* labelText() const;
+
+//----------------------------------------------------------------------------
+// fileBytes
+// Preconditions:   None
+// Postconditions:  Returns the size of the open file, 0 if none
+    size_t fileBytes() const;
+
+    // Checksums start from the FNV-1a offset basis
+    static const uint64_t HASH_BASIS = 0xcbf29ce484222325ULL;
+
+//----------------------------------------------------------------------------
+// hash
+// Preconditions:   None
+// Postconditions:  Returns the running checksum with the bytes added, taken
+//                  8 at a time, a last part shorter than 8 is padded with 0
+    static uint64_t hash(uint64_t, const char*, size_t);
+
+private:
+    static const uint64_t MAGIC = 0x314e534850415247ULL;  // "GRAPHSN1"
+    static const uint32_t VERSION = 1;                     // file layout
+    static const uint32_t ORDER_MARK = 0x01020304;         // reads swapped
+
+    struct Header {
+        uint64_t magic;             // MAGIC
+        uint32_t version;           // VERSION
+        uint32_t order;             // ORDER_MARK as the writer stored it
+        uint32_t kind;              // Kind of the graph
+        int32_t nodes;              // number of nodes
+        int64_t edges;              // number of edges
+        int64_t labelBytes;         // length of the label text
+        uint64_t checksum;          // of every section
+        uint64_t headerSum;         // of the fields above
+    };
+
+    struct Layout {
+        size_t offsets;             // start of each section in the file
+        size_t targets;
+        size_t weights;
+        size_t labelStarts;
+        size_t labels;
+        size_t total;               // bytes of the whole file
+    };
+
+    const char* base;               // start of the mapping, nullptr if none
+    size_t bytes;                   // length of the mapping
+    Header header;                  // copy of the file's header
+    Layout layout;                  // where the sections of the file are
+
+//----------------------------------------------------------------------------
+// plan
+// Preconditions:   Counts are not negative
+// Postconditions:  Returns where each section of a file with the counts is
+    static Layout plan(Kind, int, int64_t, int64_t);
+};
+
+#endif
@@ -16,6 +16,7 @@
 #include <fstream>
 #include "graphl.h"
 #include "graphm.h"
+#include "batchrunner.h"
 using namespace std;
 
 int main() {
@@ -27,16 +28,17 @@ int main() {
    }
 
    //for each graph, find the shortest path from every node to all other nodes
-   for(;;){
-      GraphM G;
-      G.buildGraph(infile1);
-      if (infile1.eof()) 
-         break;
+   //graphs are built, solved and printed by a pipeline of threads, the
+   //output comes out in the order of the file
+   BatchRunner runner;
+   runner.setTask([](GraphM& G, OutputBuffer& out) {
       G.findShortestPath();        
-      G.displayAll();              // display shortest distance, path to cout
-      G.display(3,1);              // display path from node 3 to 1 to cout
+      G.displayAll(out);           // display shortest distance, path
+      G.display(out, 3, 1);        // display path from node 3 to 1
       // may be other calls to display 
-   }
+   });
+   OutputBuffer console(cout);
+   runner.run(infile1, console);   // output goes to cout
 
    // part 2 
    ifstream infile2("data32.txt");
@@ -0,0 +1,267 @@
+//----------------------------------------------------------------------------
+// LABELSTORE.CPP
+// Implementation for LabelStore Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// LabelStore: holds the text label of every node of a graph
+// and allows other features:
+//      --adding labels one after another, node 1 first
+//      --reading a label as a string_view, with no copy
+//      --finding the node of a label through a hash index
+//      --viewing labels held elsewhere, such as in a mapped snapshot file
+//
+// Implementation and assumptions:
+//      --the text of every label is kept end to end in one string, label i
+//        is the text from starts[i] to starts[i + 1], so a store is 2
+//        allocations however many labels it holds and copies in 2 copies
+//      --the starts are laid out as a GraphSnapshot holds them, node count
+//        + 2 64-bit ints with starts[0] unused, so a snapshot's labels can
+//        be viewed where they lie
+//      --a view is never written, the first label added copies it into the
+//        store's own arrays
+//      --the index is an open addressing hash table of node ids, it is
+//        built the first time find is called and extended to labels added
+//        since on later calls, where labels repeat the lowest id is found
+//      --a string_view from label is only valid until the next add or
+//        clear, and for a view while the viewed memory lives
+//      --node ids are in the range 1 to the count of labels
+//----------------------------------------------------------------------------
+
+#include "labelstore.h"
+#include <functional>
+#include <utility>
+
+// Starts of a store with no labels, so label arrays are never null
+static const int64_t NO_STARTS[2] = { 0, 0 };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Store holds no labels
+LabelStore::LabelStore() : labels(0), view(false), indexed(0) {
+    clear();
+}
+
+//----------------------------------------------------------------------------
+// Copy constructor
+// Preconditions:   None
+// Postconditions:  Store is a copy of the parameter, a view stays a view of
+//                  the same memory
+LabelStore::LabelStore(const LabelStore& other) {
+    *this = other;
+}
+
+//----------------------------------------------------------------------------
+// Move constructor
+// Preconditions:   None
+// Postconditions:  Store takes the parameter's arrays, the parameter holds
+//                  no labels
+LabelStore::LabelStore(LabelStore&& other) noexcept {
+    *this = move(other);
+}
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  Store is a copy of the parameter, a view stays a view of
+//                  the same memory
+LabelStore& LabelStore::operator=(const LabelStore& other) {
+    if(this != &other) {
+        labels = other.labels;
+        view = other.view;
+        heldStarts = other.heldStarts;
+        heldText = other.heldText;
+        slots = other.slots;
+        indexed = other.indexed;
+        starts = other.starts;
+        text = other.text;
+        if(!view) {
+            hold();         // point at the copied arrays, not the parameter's
+        }
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  Store takes the parameter's arrays, the parameter holds
+//                  no labels
+LabelStore& LabelStore::operator=(LabelStore&& other) noexcept {
+    if(this != &other) {
+        labels = other.labels;
+        view = other.view;
+        heldStarts = move(other.heldStarts);
+        heldText = move(other.heldText);
+        slots = move(other.slots);
+        indexed = other.indexed;
+        starts = other.starts;
+        text = other.text;
+        if(!view) {
+            hold();
+        }
+        other.labels = 0;
+        other.view = false;
+        other.indexed = 0;
+        other.hold();
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Store holds no labels, its memory is kept for reuse
+void LabelStore::clear() {
+    labels = 0;
+    view = false;
+    heldStarts.clear();
+    heldText.clear();
+    slots.clear();
+    indexed = 0;
+    hold();
+}
+
+//----------------------------------------------------------------------------
+// reserve
+// Preconditions:   None
+// Postconditions:  Room is made for the given number of labels and bytes of
+//                  text
+void LabelStore::reserve(int count, size_t bytes) {
+    if(!view) {
+        heldStarts.reserve(count + 2);
+        heldText.reserve(bytes);
+        hold();
+    }
+}
+
+//----------------------------------------------------------------------------
+// add
+// Preconditions:   None
+// Postconditions:  Label is held by the next node id, which is returned
+int LabelStore::add(string_view name) {
+    detach();
+    heldText.append(name.data(), name.size());
+    heldStarts.push_back(heldText.size());
+    labels++;
+    hold();
+    return labels;
+}
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Starts has count + 2 entries laid out as described at the
+//                  top of this file, both arrays outlive this store and its
+//                  copies
+// Postconditions:  Store is a view of the given number of labels
+void LabelStore::attach(int count, const int64_t* startArray,
+                        const char* textArray) {
+    clear();
+    labels = count;
+    view = true;
+    starts = startArray;
+    text = textArray;
+}
+
+//----------------------------------------------------------------------------
+// detach
+// Preconditions:   None
+// Postconditions:  Store holds its own copy of the labels of a view, nothing
+//                  changes if it is not one
+void LabelStore::detach() {
+    // An empty store's starts are NO_STARTS until something is added
+    if(view || heldStarts.empty()) {
+        heldStarts.assign(starts, starts + labels + 2);
+        heldText.assign(text, starts[labels + 1]);
+        view = false;
+        hold();
+    }
+}
+
+//----------------------------------------------------------------------------
+// count
+// Preconditions:   None
+// Postconditions:  Returns the number of labels held
+int LabelStore::count() const {
+    return labels;
+}
+
+//----------------------------------------------------------------------------
+// find
+// Preconditions:   None
+// Postconditions:  Returns the lowest node id whose label is the text, 0 if
+//                  none is
+int LabelStore::find(string_view name) {
+    // Grow to keep the table at most half full, which puts every id back
+    if(slots.size() < 2 * (size_t)labels + 2) {
+        size_t size = 16;
+        while(size < 4 * (size_t)labels) {
+            size *= 2;
+        }
+        slots.assign(size, 0);
+        indexed = 0;
+    }
+    while(indexed < labels) {
+        insert(++indexed);
+    }
+
+    size_t mask = slots.size() - 1;
+    for(size_t at = hash<string_view>()(name) & mask; slots[at] != 0;
+        at = (at + 1) & mask) {
+        if(label(slots[at]) == name) {
+            return slots[at];
+        }
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+// startData, textData, textBytes
+// Preconditions:   None
+// Postconditions:  Returns the starts (count + 2 entries) and the text of
+//                  every label, and the length of the text
+const int64_t* LabelStore::startData() const {
+    return starts;
+}
+const char* LabelStore::textData() const {
+    return text;
+}
+size_t LabelStore::textBytes() const {
+    return starts[labels + 1];
+}
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the arrays and the index, a
+//                  view's memory is not counted
+size_t LabelStore::memoryBytes() const {
+    return heldStarts.capacity() * sizeof(int64_t) + heldText.capacity() +
+           slots.capacity() * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// hold
+// Preconditions:   Store is not a view
+// Postconditions:  Arrays read are the ones held by this store
+void LabelStore::hold() {
+    starts = heldStarts.empty() ? NO_STARTS : heldStarts.data();
+    text = heldText.data();
+}
+
+//----------------------------------------------------------------------------
+// insert
+// Preconditions:   Index has a free slot
+// Postconditions:  Node is in the index unless a lower id has its label
+void LabelStore::insert(int v) {
+    string_view key = label(v);
+    size_t mask = slots.size() - 1;
+    size_t at = hash<string_view>()(key) & mask;
+    while(slots[at] != 0) {
+        if(label(slots[at]) == key) {
+            return;
+        }
+        at = (at + 1) & mask;
+    }
+    slots[at] = v;
+}
@@ -0,0 +1,159 @@
+//----------------------------------------------------------------------------
+// LABELSTORE.H
+// Class for the labels of the nodes of a graph, packed in one arena
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// LabelStore: holds the text label of every node of a graph
+// and allows other features:
+//      --adding labels one after another, node 1 first
+//      --reading a label as a string_view, with no copy
+//      --finding the node of a label through a hash index
+//      --viewing labels held elsewhere, such as in a mapped snapshot file
+//
+// Implementation and assumptions:
+//      --the text of every label is kept end to end in one string, label i
+//        is the text from starts[i] to starts[i + 1], so a store is 2
+//        allocations however many labels it holds and copies in 2 copies
+//      --the starts are laid out as a GraphSnapshot holds them, node count
+//        + 2 64-bit ints with starts[0] unused, so a snapshot's labels can
+//        be viewed where they lie
+//      --a view is never written, the first label added copies it into the
+//        store's own arrays
+//      --the index is an open addressing hash table of node ids, it is
+//        built the first time find is called and extended to labels added
+//        since on later calls, where labels repeat the lowest id is found
+//      --a string_view from label is only valid until the next add or
+//        clear, and for a view while the viewed memory lives
+//      --node ids are in the range 1 to the count of labels
+//----------------------------------------------------------------------------
+
+#ifndef LABELSTORE_H
+#define LABELSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class LabelStore {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Store holds no labels
+    LabelStore();
+
+//----------------------------------------------------------------------------
+// Copy constructor, move constructor
+// Preconditions:   None
+// Postconditions:  Store is a copy of the parameter, or takes its arrays and
+//                  leaves it with no labels, a view stays a view of the
+//                  same memory
+    LabelStore(const LabelStore&);
+    LabelStore(LabelStore&&) noexcept;
+
+//----------------------------------------------------------------------------
+// operator=
+// Preconditions:   None
+// Postconditions:  As the copy and move constructors
+    LabelStore& operator=(const LabelStore&);
+    LabelStore& operator=(LabelStore&&) noexcept;
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Store holds no labels, its memory is kept for reuse
+    void clear();
+
+//----------------------------------------------------------------------------
+// reserve
+// Preconditions:   None
+// Postconditions:  Room is made for the given number of labels and bytes of
+//                  text
+    void reserve(int, size_t);
+
+//----------------------------------------------------------------------------
+// add
+// Preconditions:   None
+// Postconditions:  Label is held by the next node id, which is returned
+    int add(string_view);
+
+//----------------------------------------------------------------------------
+// attach
+// Preconditions:   Starts has count + 2 entries laid out as described at the
+//                  top of this file, both arrays outlive this store and its
+//                  copies
+// Postconditions:  Store is a view of the given number of labels
+    void attach(int, const int64_t*, const char*);
+
+//----------------------------------------------------------------------------
+// detach
+// Preconditions:   None
+// Postconditions:  Store holds its own copy of the labels of a view, nothing
+//                  changes if it is not one
+    void detach();
+
+//----------------------------------------------------------------------------
+// label
+// Preconditions:   Node is in the range 1 to count
+// Postconditions:  Returns the text of the node's label
+    string_view label(int v) const {
+        return string_view(text + starts[v], starts[v + 1] - starts[v]);
+    }
+
+//----------------------------------------------------------------------------
+// count
+// Preconditions:   None
+// Postconditions:  Returns the number of labels held
+    int count() const;
+
+//----------------------------------------------------------------------------
+// find
+// Preconditions:   None
+// Postconditions:  Returns the lowest node id whose label is the text, 0 if
+//                  none is
+    int find(string_view);
+
+//----------------------------------------------------------------------------
+// startData, textData, textBytes
+// Preconditions:   None
+// Postconditions:  Returns the starts (count + 2 entries) and the text of
+//                  every label, and the length of the text
+    const int64_t* startData() const;
+    const char* textData() const;
+    size_t textBytes() const;
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the arrays and the index, a
+//                  view's memory is not counted
+    size_t memoryBytes() const;
+
+private:
+    int labels;                 // number of labels
+    bool view;                  // whether the arrays are held elsewhere
+    const int64_t* starts;      // start of each label in text
+    const char* text;           // every label end to end
+    vector<int64_t> heldStarts; // arrays read, unless a view
+    string heldText;
+    vector<int> slots;          // hash index of node ids, 0 = empty
+    int indexed;                // labels 1 to this are in the index
+
+//----------------------------------------------------------------------------
+// hold
+// Preconditions:   Store is not a view
+// Postconditions:  Arrays read are the ones held by this store
+    void hold();
+
+//----------------------------------------------------------------------------
+// insert
+// Preconditions:   Index has a free slot
+// Postconditions:  Node is in the index unless a lower id has its label
+    void insert(int);
+};
+
+#endif
@@ -0,0 +1,385 @@
+//----------------------------------------------------------------------------
+// LANDMARKS.CPP
+// Implementation for Landmarks Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// Landmarks: shortest distances from and to a few chosen nodes of a graph
+// and allows other features:
+//      --choosing the landmarks by the farthest point or avoid heuristic
+//      --a lower bound on the distance between any 2 nodes, from the
+//        triangle inequality, for use as an A* heuristic
+//      --an upper bound on the distance between any 2 nodes
+//      --saving the distances to a stream and loading them back, so they do
+//        not have to be found again each time a program starts
+//
+// Implementation and assumptions:
+//      --for each landmark L, the distance from L to every node is found on
+//        the graph and the distance from every node to L on the reversed
+//        graph, both are kept in one array per direction, landmark by
+//        landmark
+//      --d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L), the
+//        lower bound is the largest of these over the landmarks, when one
+//        side is reachable and the other is not, v cannot reach t at all
+//      --farthest point picks each landmark as the node farthest from the
+//        landmarks so far, avoid (Goldberg and Werneck) grows a shortest
+//        path tree from a random root, weighs each node by how badly the
+//        landmarks so far bound its distance, and picks a leaf under the
+//        heaviest subtree that holds no landmark yet
+//      --the saved form starts with a magic number, a version, a byte order
+//        marker and a fingerprint of the graph's edges, load refuses data
+//        saved for another graph or on a machine of the other byte order
+//      --the distances are only valid for the graph they were found on, any
+//        change to the edges makes them useless
+//      --edge lengths are assumed to be 0 or more, node ids are in the range
+//        1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "landmarks.h"
+#include <random>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No landmarks are held
+Landmarks::Landmarks() {
+    clear();
+}
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Second graph is the first one reversed, both are merged
+// Postconditions:  Up to the given number of landmarks are chosen by the
+//                  method and their distances found, the seed picks the
+//                  random nodes the methods start from
+void Landmarks::build(const CSRGraph& g, const CSRGraph& reverse, int k,
+                      Method method, unsigned seed) {
+    clear();
+    nodes = g.nodeCount();
+    signature = fingerprint(g);
+    if(k > nodes) {
+        k = nodes;
+    }
+    mt19937 rng(seed);
+    BinaryHeap heap;
+    vector<char> isMark(nodes + 1, 0);
+
+    while((int)marks.size() < k) {
+        int next = 0;
+        if(method == AVOID) {
+            // Random root that is not a landmark yet
+            int root;
+            do {
+                root = rng() % nodes + 1;
+            } while(isMark[root]);
+            next = avoid(g, root, isMark, heap);
+        }
+        if(next == 0 && marks.empty()) {
+            // First farthest point is the node farthest from a random one
+            int root = rng() % nodes + 1;
+            add(g, reverse, root, heap);
+            next = farthest(isMark);
+            marks.pop_back();
+            from.resize(0);
+            to.resize(0);
+        }
+        if(next == 0) {
+            next = farthest(isMark);
+        }
+        isMark[next] = 1;
+        add(g, reverse, next, heap);
+    }
+}
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  No landmarks are held
+void Landmarks::clear() {
+    nodes = 0;
+    signature = 0;
+    marks.clear();
+    from.clear();
+    to.clear();
+}
+
+//----------------------------------------------------------------------------
+// count, landmark
+// Preconditions:   Index is below count
+// Postconditions:  Returns the number of landmarks held, and the node of
+//                  the landmark at the index
+int Landmarks::count() const {
+    return marks.size();
+}
+int Landmarks::landmark(int index) const {
+    return marks[index];
+}
+
+//----------------------------------------------------------------------------
+// lowerBound
+// Preconditions:   Nodes are in the graph the landmarks were built for
+// Postconditions:  Returns a distance no longer than the shortest path from
+//                  node 1 to node 2, LLONG_MAX if there is no such path,
+//                  0 if no landmarks are held
+long long Landmarks::lowerBound(int v, int t) const {
+    long long best = 0;
+    for(size_t l = 0; l < marks.size(); l++) {
+        const int* fromL = &from[l * (nodes + 1)];
+        const int* toL = &to[l * (nodes + 1)];
+
+        // d(v, t) >= d(L, t) - d(L, v)
+        if(fromL[v] != INT_MAX) {
+            if(fromL[t] == INT_MAX) {
+                return LLONG_MAX;       // L reaches v but not t
+            }
+            if(fromL[t] - fromL[v] > best) {
+                best = fromL[t] - fromL[v];
+            }
+        }
+        // d(v, t) >= d(v, L) - d(t, L)
+        if(toL[t] != INT_MAX) {
+            if(toL[v] == INT_MAX) {
+                return LLONG_MAX;       // t reaches L but v does not
+            }
+            if(toL[v] - toL[t] > best) {
+                best = toL[v] - toL[t];
+            }
+        }
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------
+// upperBound
+// Preconditions:   Nodes are in the graph the landmarks were built for
+// Postconditions:  Returns a distance no shorter than the shortest path from
+//                  node 1 to node 2, LLONG_MAX if none is known
+long long Landmarks::upperBound(int s, int t) const {
+    long long best = LLONG_MAX;
+    for(size_t l = 0; l < marks.size(); l++) {
+        int toL = to[l * (nodes + 1) + s];
+        int fromL = from[l * (nodes + 1) + t];
+        if(toL != INT_MAX && fromL != INT_MAX &&
+           (long long)toL + fromL < best) {
+            best = (long long)toL + fromL;
+        }
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------
+// save
+// Preconditions:   None
+// Postconditions:  Landmarks and their distances are written to the stream,
+//                  returns false if the stream failed
+bool Landmarks::save(ostream& out) const {
+    uint32_t header[4] = { MAGIC, VERSION, ORDER_MARK, (uint32_t)nodes };
+    uint32_t k = marks.size();
+    out.write((const char*)header, sizeof(header));
+    out.write((const char*)&signature, sizeof(signature));
+    out.write((const char*)&k, sizeof(k));
+    out.write((const char*)marks.data(), k * sizeof(int));
+    out.write((const char*)from.data(), from.size() * sizeof(int));
+    out.write((const char*)to.data(), to.size() * sizeof(int));
+    return (bool)out;
+}
+
+//----------------------------------------------------------------------------
+// load
+// Preconditions:   Graph is merged
+// Postconditions:  Returns true and holds the landmarks read from the stream
+//                  if they were saved for this graph, otherwise returns
+//                  false and holds no landmarks
+bool Landmarks::load(istream& in, const CSRGraph& g) {
+    clear();
+    uint32_t header[4];
+    uint64_t saved;
+    uint32_t k;
+    in.read((char*)header, sizeof(header));
+    in.read((char*)&saved, sizeof(saved));
+    in.read((char*)&k, sizeof(k));
+    if(!in || header[0] != MAGIC || header[1] != VERSION ||
+       header[2] != ORDER_MARK || (int)header[3] != g.nodeCount() ||
+       saved != fingerprint(g) || (int)k > g.nodeCount()) {
+        return false;
+    }
+
+    size_t entries = (size_t)k * (g.nodeCount() + 1);
+    marks.resize(k);
+    from.resize(entries);
+    to.resize(entries);
+    in.read((char*)marks.data(), k * sizeof(int));
+    in.read((char*)from.data(), entries * sizeof(int));
+    in.read((char*)to.data(), entries * sizeof(int));
+    if(!in) {
+        clear();
+        return false;
+    }
+    nodes = g.nodeCount();
+    signature = saved;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the distances
+size_t Landmarks::memoryBytes() const {
+    return (from.capacity() + to.capacity() + marks.capacity()) * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// fingerprint
+// Preconditions:   Graph is merged
+// Postconditions:  Returns a hash of the node count and every edge
+uint64_t Landmarks::fingerprint(const CSRGraph& g) {
+    // 64-bit FNV-1a over the numbers
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint32_t value) {
+        for(int b = 0; b < 4; b++) {
+            hash ^= (value >> (8 * b)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(g.nodeCount());
+    for(int v = 1; v <= g.nodeCount(); v++) {
+        mix(g.end(v) - g.begin(v));
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            mix(g.target(e));
+            mix(g.weight(e));
+        }
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------
+// search
+// Preconditions:   Graph is merged, dist holds nodes + 1 entries
+// Postconditions:  dist holds the distance from the source to each node,
+//                  INT_MAX if unreachable, the optional vectors hold each
+//                  node's previous node and the nodes in the order finished
+void Landmarks::search(const CSRGraph& g, int source, int* dist,
+                       BinaryHeap& heap, vector<int>* previous,
+                       vector<int>* order) const {
+    for(int v = 0; v <= nodes; v++) {
+        dist[v] = INT_MAX;
+    }
+    if(previous != nullptr) {
+        previous->assign(nodes + 1, 0);
+    }
+    if(order != nullptr) {
+        order->clear();
+    }
+    heap.reset(nodes);
+    dist[source] = 0;
+    heap.update(source, 0);
+    while(!heap.empty()) {
+        int v = heap.pop();
+        if(order != nullptr) {
+            order->push_back(v);
+        }
+        for(int e = g.begin(v); e < g.end(v); e++) {
+            int k = g.target(e);
+            int throughV = dist[v] + g.weight(e);
+            if(throughV < dist[k]) {
+                dist[k] = throughV;
+                heap.update(k, throughV);
+                if(previous != nullptr) {
+                    (*previous)[k] = v;
+                }
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// farthest
+// Preconditions:   At least one node is not a landmark
+// Postconditions:  Returns the node whose nearest landmark is farthest away,
+//                  nodes no landmark reaches count as farthest
+int Landmarks::farthest(const vector<char>& isMark) const {
+    int best = 0;
+    long long bestGap = -1;
+    for(int v = 1; v <= nodes; v++) {
+        if(isMark[v]) {
+            continue;
+        }
+        long long gap = LLONG_MAX;
+        for(size_t l = 0; l < marks.size(); l++) {
+            long long there = from[l * (nodes + 1) + v];
+            long long back = to[l * (nodes + 1) + v];
+            long long nearer = there < back ? there : back;
+            if(nearer < gap) {
+                gap = nearer;
+            }
+        }
+        if(gap > bestGap) {
+            best = v;
+            bestGap = gap;
+        }
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------
+// avoid
+// Preconditions:   At least one node is not a landmark
+// Postconditions:  Returns the leaf under the heaviest landmark-free subtree
+//                  of a shortest path tree from the root, 0 if every subtree
+//                  is already bounded exactly or holds a landmark
+int Landmarks::avoid(const CSRGraph& g, int root, const vector<char>& isMark,
+                     BinaryHeap& heap) const {
+    vector<int> dist(nodes + 1);
+    vector<int> previous;
+    vector<int> order;
+    search(g, root, dist.data(), heap, &previous, &order);
+
+    // Weight of a node is how far its lower bound falls short, summed up
+    // the tree in reverse finishing order so children come before parents
+    vector<long long> weight(nodes + 1, 0);
+    vector<char> holdsMark(nodes + 1, 0);
+    vector<int> heaviest(nodes + 1, 0);
+    for(int n = order.size() - 1; n >= 0; n--) {
+        int v = order[n];
+        holdsMark[v] |= isMark[v];
+        if(holdsMark[v]) {
+            weight[v] = 0;
+        }
+        else {
+            weight[v] += dist[v] - lowerBound(root, v);
+        }
+        if(v == root) {
+            continue;
+        }
+        int parent = previous[v];
+        weight[parent] += weight[v];
+        holdsMark[parent] |= holdsMark[v];
+        if(weight[v] > 0 &&
+           (heaviest[parent] == 0 || weight[v] > weight[heaviest[parent]])) {
+            heaviest[parent] = v;
+        }
+    }
+    if(heaviest[root] == 0) {
+        return 0;
+    }
+
+    // Follow the heaviest child down to a leaf
+    int v = root;
+    while(heaviest[v] != 0) {
+        v = heaviest[v];
+    }
+    return v;
+}
+
+//----------------------------------------------------------------------------
+// add
+// Preconditions:   Node is in the graph
+// Postconditions:  Node is a landmark, its distances are found
+void Landmarks::add(const CSRGraph& g, const CSRGraph& reverse, int node,
+                    BinaryHeap& heap) {
+    size_t first = marks.size() * (nodes + 1);
+    marks.push_back(node);
+    from.resize(first + nodes + 1);
+    to.resize(first + nodes + 1);
+    search(g, node, &from[first], heap);
+    search(reverse, node, &to[first], heap);
+}
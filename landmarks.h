@@ -0,0 +1,167 @@
+//----------------------------------------------------------------------------
+// LANDMARKS.H
+// Class for landmark distances used as A* lower bounds (ALT)
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// Landmarks: shortest distances from and to a few chosen nodes of a graph
+// and allows other features:
+//      --choosing the landmarks by the farthest point or avoid heuristic
+//      --a lower bound on the distance between any 2 nodes, from the
+//        triangle inequality, for use as an A* heuristic
+//      --an upper bound on the distance between any 2 nodes
+//      --saving the distances to a stream and loading them back, so they do
+//        not have to be found again each time a program starts
+//
+// Implementation and assumptions:
+//      --for each landmark L, the distance from L to every node is found on
+//        the graph and the distance from every node to L on the reversed
+//        graph, both are kept in one array per direction, landmark by
+//        landmark
+//      --d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L), the
+//        lower bound is the largest of these over the landmarks, when one
+//        side is reachable and the other is not, v cannot reach t at all
+//      --farthest point picks each landmark as the node farthest from the
+//        landmarks so far, avoid (Goldberg and Werneck) grows a shortest
+//        path tree from a random root, weighs each node by how badly the
+//        landmarks so far bound its distance, and picks a leaf under the
+//        heaviest subtree that holds no landmark yet
+//      --the saved form starts with a magic number, a version, a byte order
+//        marker and a fingerprint of the graph's edges, load refuses data
+//        saved for another graph or on a machine of the other byte order
+//      --the distances are only valid for the graph they were found on, any
+//        change to the edges makes them useless
+//      --edge lengths are assumed to be 0 or more, node ids are in the range
+//        1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "csrgraph.h"
+#include "dheap.h"
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+class Landmarks {
+public:
+    // How build chooses the landmarks
+    enum Method { FARTHEST, AVOID };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No landmarks are held
+    Landmarks();
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Second graph is the first one reversed, both are merged
+// Postconditions:  Up to the given number of landmarks are chosen by the
+//                  method and their distances found, the seed picks the
+//                  random nodes the methods start from
+    void build(const CSRGraph&, const CSRGraph&, int, Method,
+               unsigned = 1);
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  No landmarks are held
+    void clear();
+
+//----------------------------------------------------------------------------
+// count, landmark
+// Preconditions:   Index is below count
+// Postconditions:  Returns the number of landmarks held, and the node of
+//                  the landmark at the index
+    int count() const;
+    int landmark(int) const;
+
+//----------------------------------------------------------------------------
+// lowerBound
+// Preconditions:   Nodes are in the graph the landmarks were built for
+// Postconditions:  Returns a distance no longer than the shortest path from
+//                  node 1 to node 2, LLONG_MAX if there is no such path,
+//                  0 if no landmarks are held
+    long long lowerBound(int, int) const;
+
+//----------------------------------------------------------------------------
+// upperBound
+// Preconditions:   Nodes are in the graph the landmarks were built for
+// Postconditions:  Returns a distance no shorter than the shortest path from
+//                  node 1 to node 2, LLONG_MAX if none is known
+    long long upperBound(int, int) const;
+
+//----------------------------------------------------------------------------
+// save
+// Preconditions:   None
+// Postconditions:  Landmarks and their distances are written to the stream,
+//                  returns false if the stream failed
+    bool save(ostream&) const;
+
+//----------------------------------------------------------------------------
+// load
+// Preconditions:   Graph is merged
+// Postconditions:  Returns true and holds the landmarks read from the stream
+//                  if they were saved for this graph, otherwise returns
+//                  false and holds no landmarks
+    bool load(istream&, const CSRGraph&);
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the distances
+    size_t memoryBytes() const;
+
+private:
+    static const uint32_t MAGIC = 0x31544c41;       // "ALT1" little-endian
+    static const uint32_t VERSION = 1;              // saved layout
+    static const uint32_t ORDER_MARK = 0x01020304;  // reads back swapped
+
+    int nodes;                  // number of nodes of the graph
+    uint64_t signature;         // fingerprint of the graph's edges
+    vector<int> marks;          // node of each landmark
+    vector<int> from;           // distance from each landmark to each node
+    vector<int> to;             // distance from each node to each landmark
+
+//----------------------------------------------------------------------------
+// fingerprint
+// Preconditions:   Graph is merged
+// Postconditions:  Returns a hash of the node count and every edge
+    static uint64_t fingerprint(const CSRGraph&);
+
+//----------------------------------------------------------------------------
+// search
+// Preconditions:   Graph is merged, dist holds nodes + 1 entries
+// Postconditions:  dist holds the distance from the source to each node,
+//                  INT_MAX if unreachable, the optional vectors hold each
+//                  node's previous node and the nodes in the order finished
+    void search(const CSRGraph&, int, int*, BinaryHeap&,
+                vector<int>* = nullptr, vector<int>* = nullptr) const;
+
+//----------------------------------------------------------------------------
+// farthest
+// Preconditions:   At least one node is not a landmark
+// Postconditions:  Returns the node whose nearest landmark is farthest away,
+//                  nodes no landmark reaches count as farthest
+    int farthest(const vector<char>&) const;
+
+//----------------------------------------------------------------------------
+// avoid
+// Preconditions:   At least one node is not a landmark
+// Postconditions:  Returns the leaf under the heaviest landmark-free subtree
+//                  of a shortest path tree from the root, 0 if every subtree
+//                  is already bounded exactly or holds a landmark
+    int avoid(const CSRGraph&, int, const vector<char>&, BinaryHeap&) const;
+
+//----------------------------------------------------------------------------
+// add
+// Preconditions:   Node is in the graph
+// Postconditions:  Node is a landmark, its distances are found
+    void add(const CSRGraph&, const CSRGraph&, int, BinaryHeap&);
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "nodedata.h"
+#include <utility>
 
 //----------------------------------------------------------------------------
 // constructors/destructor  
@@ -9,6 +10,8 @@ NodeData::~NodeData() { }            // needed so strings are deleted properly
 
 NodeData::NodeData(const NodeData& nd) { data = nd.data; }  // copy
 
+NodeData::NodeData(NodeData&& nd) noexcept : data(move(nd.data)) { } // move
+
 NodeData::NodeData(const string& s) { data = s; }    // cast string to NodeData
 
 //----------------------------------------------------------------------------
@@ -21,6 +24,13 @@ NodeData& NodeData::operator=(const NodeData& rhs) {
    return *this;
 }
 
+NodeData& NodeData::operator=(NodeData&& rhs) noexcept {
+   if (this != &rhs) {
+      data = move(rhs.data);
+   }
+   return *this;
+}
+
 //----------------------------------------------------------------------------
 // operator==,!= 
 
@@ -16,7 +16,9 @@ public:
    ~NodeData();          
    NodeData(const string &);      // data is set equal to parameter
    NodeData(const NodeData &);    // copy constructor
+   NodeData(NodeData &&) noexcept;   // move constructor, takes the string
    NodeData& operator=(const NodeData &);
+   NodeData& operator=(NodeData &&) noexcept;
 
    // set class data from data file
    // returns true if the data is set, false when bad data, i.e., is eof
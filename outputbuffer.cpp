@@ -0,0 +1,253 @@
+//----------------------------------------------------------------------------
+// OUTPUTBUFFER.CPP
+// Implementation for OutputBuffer Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// OutputBuffer: collects text and writes it out in large pieces
+// and allows other features:
+//      --writing to a file descriptor, to an ostream, or only to memory
+//      --integers and text left justified in a field of a given width, the
+//        same bytes setw and left give on an ostream
+//      --appending the text held by another buffer, so pieces rendered
+//        separately can be written out in order
+//
+// Implementation and assumptions:
+//      --text is copied into one array allocated when the buffer is made,
+//        which is written out only when full or flushed, never at the end
+//        of a line
+//      --a buffer with a file descriptor or ostream writes what it holds on
+//        flush and when it is destroyed, a piece bigger than the array is
+//        written out directly
+//      --a buffer with neither only grows, what it holds is read with data
+//        and size and emptied with clear, its memory is kept
+//      --integers are turned into digits by hand, no locale is used
+//      --if writing to the file descriptor fails the rest of the text is
+//        dropped and good returns false
+//----------------------------------------------------------------------------
+
+#include "outputbuffer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Buffer is empty and only writes to memory
+OutputBuffer::OutputBuffer()
+    : used(0), fd(-1), stream(nullptr), failed(false) {
+}
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   File descriptor is open for writing
+// Postconditions:  Buffer is empty and writes to the file descriptor once it
+//                  holds the given number of bytes
+OutputBuffer::OutputBuffer(int descriptor, size_t capacity)
+    : bytes(max(capacity, (size_t)1)), used(0), fd(descriptor),
+      stream(nullptr), failed(false) {
+}
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   Stream outlives the buffer
+// Postconditions:  Buffer is empty and writes to the stream once it holds
+//                  the given number of bytes
+OutputBuffer::OutputBuffer(ostream& out, size_t capacity)
+    : bytes(max(capacity, (size_t)1)), used(0), fd(-1), stream(&out),
+      failed(false) {
+}
+
+//----------------------------------------------------------------------------
+// Move constructor
+// Preconditions:   None
+// Postconditions:  Buffer takes the parameter's text and destination, the
+//                  parameter is left empty, writing only to memory
+OutputBuffer::OutputBuffer(OutputBuffer&& other) noexcept
+    : bytes(move(other.bytes)), used(other.used), fd(other.fd),
+      stream(other.stream), failed(other.failed) {
+    other.bytes.clear();
+    other.used = 0;
+    other.fd = -1;
+    other.stream = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  Text held is written out
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+//----------------------------------------------------------------------------
+// write
+// Preconditions:   Array holds the given number of characters
+// Postconditions:  Characters are added to the end of the text
+void OutputBuffer::write(const char* text, size_t count) {
+    // An empty string_view may have no array at all
+    if(count == 0) {
+        return;
+    }
+    if(used + count > bytes.size()) {
+        make(count);
+        if(count > bytes.size()) {
+            emit(text, count);
+            return;
+        }
+    }
+    memcpy(bytes.data() + used, text, count);
+    used += count;
+}
+
+//----------------------------------------------------------------------------
+// putText
+// Preconditions:   None
+// Postconditions:  Text is added to the end, followed by spaces up to the
+//                  width if it is shorter
+void OutputBuffer::putText(const char* text, int width) {
+    int length = strlen(text);
+    write(text, length);
+    if(length < width) {
+        spaces(width - length);
+    }
+}
+void OutputBuffer::putText(string_view text, int width) {
+    write(text.data(), text.size());
+    if((int)text.size() < width) {
+        spaces(width - text.size());
+    }
+}
+
+//----------------------------------------------------------------------------
+// putInt
+// Preconditions:   None
+// Postconditions:  Digits of the value are added to the end, with a leading
+//                  '-' if negative, followed by spaces up to the width if
+//                  shorter
+void OutputBuffer::putInt(long long value, int width) {
+    // Digits are made from the end of the array back
+    char digits[24];
+    char* start = digits + sizeof(digits);
+    unsigned long long rest = value < 0 ? 0ULL - (unsigned long long)value
+                                        : (unsigned long long)value;
+    do {
+        *--start = '0' + rest % 10;
+        rest /= 10;
+    } while(rest != 0);
+    if(value < 0) {
+        *--start = '-';
+    }
+    int length = digits + sizeof(digits) - start;
+    write(start, length);
+    if(length < width) {
+        spaces(width - length);
+    }
+}
+
+//----------------------------------------------------------------------------
+// spaces
+// Preconditions:   None
+// Postconditions:  Given number of spaces are added to the end
+void OutputBuffer::spaces(int count) {
+    static const char blank[] = "                                ";
+    const int most = sizeof(blank) - 1;
+    for(; count > most; count -= most) {
+        write(blank, most);
+    }
+    if(count > 0) {
+        write(blank, count);
+    }
+}
+
+//----------------------------------------------------------------------------
+// append
+// Preconditions:   Parameter is not this buffer
+// Postconditions:  Text held by the parameter is added to the end
+void OutputBuffer::append(const OutputBuffer& other) {
+    write(other.data(), other.size());
+}
+
+//----------------------------------------------------------------------------
+// flush
+// Preconditions:   None
+// Postconditions:  Text held is written out and the buffer is empty, does
+//                  nothing to a buffer that only writes to memory
+void OutputBuffer::flush() {
+    if(fd < 0 && stream == nullptr) {
+        return;
+    }
+    emit(bytes.data(), used);
+    used = 0;
+    if(stream != nullptr) {
+        stream->flush();
+    }
+}
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Text held is dropped without being written, memory is kept
+void OutputBuffer::clear() {
+    used = 0;
+}
+
+//----------------------------------------------------------------------------
+// data, size
+// Preconditions:   None
+// Postconditions:  Returns the text held and its length in bytes
+const char* OutputBuffer::data() const {
+    return bytes.data();
+}
+size_t OutputBuffer::size() const {
+    return used;
+}
+
+//----------------------------------------------------------------------------
+// good
+// Preconditions:   None
+// Postconditions:  Returns false if writing out has failed
+bool OutputBuffer::good() const {
+    return !failed && (stream == nullptr || stream->good());
+}
+
+//----------------------------------------------------------------------------
+// make
+// Preconditions:   None
+// Postconditions:  Array has room for the given number of bytes, by writing
+//                  out or growing, unless more than the whole array is asked
+//                  of a buffer that writes out
+void OutputBuffer::make(size_t count) {
+    if(fd >= 0 || stream != nullptr) {
+        emit(bytes.data(), used);
+        used = 0;
+        return;
+    }
+    bytes.resize(max(max(bytes.size() * 2, used + count), (size_t)256));
+}
+
+//----------------------------------------------------------------------------
+// emit
+// Preconditions:   Array holds the given number of characters
+// Postconditions:  Characters are written to the file descriptor or stream
+void OutputBuffer::emit(const char* text, size_t count) {
+    if(stream != nullptr) {
+        stream->write(text, count);
+        return;
+    }
+
+    // write may take only part of the text, or be interrupted by a signal
+    while(count > 0 && fd >= 0 && !failed) {
+        ssize_t done = ::write(fd, text, count);
+        if(done < 0 && errno == EINTR) {
+            continue;
+        }
+        if(done <= 0) {
+            failed = true;
+            return;
+        }
+        text += done;
+        count -= done;
+    }
+}
@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------
+// OUTPUTBUFFER.H
+// Class for a buffered writer of formatted text
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// OutputBuffer: collects text and writes it out in large pieces
+// and allows other features:
+//      --writing to a file descriptor, to an ostream, or only to memory
+//      --integers and text left justified in a field of a given width, the
+//        same bytes setw and left give on an ostream
+//      --appending the text held by another buffer, so pieces rendered
+//        separately can be written out in order
+//
+// Implementation and assumptions:
+//      --text is copied into one array allocated when the buffer is made,
+//        which is written out only when full or flushed, never at the end
+//        of a line
+//      --a buffer with a file descriptor or ostream writes what it holds on
+//        flush and when it is destroyed, a piece bigger than the array is
+//        written out directly
+//      --a buffer with neither only grows, what it holds is read with data
+//        and size and emptied with clear, its memory is kept
+//      --integers are turned into digits by hand, no locale is used
+//      --if writing to the file descriptor fails the rest of the text is
+//        dropped and good returns false
+//----------------------------------------------------------------------------
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class OutputBuffer {
+public:
+    // Bytes held before a buffer with somewhere to write flushes itself
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Buffer is empty and only writes to memory
+    OutputBuffer();
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   File descriptor is open for writing
+// Postconditions:  Buffer is empty and writes to the file descriptor once it
+//                  holds the given number of bytes
+    explicit OutputBuffer(int, size_t = DEFAULT_CAPACITY);
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   Stream outlives the buffer
+// Postconditions:  Buffer is empty and writes to the stream once it holds
+//                  the given number of bytes
+    explicit OutputBuffer(ostream&, size_t = DEFAULT_CAPACITY);
+
+//----------------------------------------------------------------------------
+// Move constructor
+// Preconditions:   None
+// Postconditions:  Buffer takes the parameter's text and destination, the
+//                  parameter is left empty, writing only to memory
+    OutputBuffer(OutputBuffer&&) noexcept;
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  Text held is written out
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+//----------------------------------------------------------------------------
+// put
+// Preconditions:   None
+// Postconditions:  Character is added to the end of the text
+    void put(char c) {
+        if(used == bytes.size()) {
+            make(1);
+        }
+        bytes[used++] = c;
+    }
+
+//----------------------------------------------------------------------------
+// write
+// Preconditions:   Array holds the given number of characters
+// Postconditions:  Characters are added to the end of the text
+    void write(const char*, size_t);
+
+//----------------------------------------------------------------------------
+// putText
+// Preconditions:   None
+// Postconditions:  Text is added to the end, followed by spaces up to the
+//                  width if it is shorter
+    void putText(const char*, int = 0);
+    void putText(string_view, int = 0);
+
+//----------------------------------------------------------------------------
+// putInt
+// Preconditions:   None
+// Postconditions:  Digits of the value are added to the end, with a leading
+//                  '-' if negative, followed by spaces up to the width if
+//                  shorter
+    void putInt(long long, int = 0);
+
+//----------------------------------------------------------------------------
+// spaces
+// Preconditions:   None
+// Postconditions:  Given number of spaces are added to the end
+    void spaces(int);
+
+//----------------------------------------------------------------------------
+// append
+// Preconditions:   Parameter is not this buffer
+// Postconditions:  Text held by the parameter is added to the end
+    void append(const OutputBuffer&);
+
+//----------------------------------------------------------------------------
+// flush
+// Preconditions:   None
+// Postconditions:  Text held is written out and the buffer is empty, does
+//                  nothing to a buffer that only writes to memory
+    void flush();
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Text held is dropped without being written, memory is kept
+    void clear();
+
+//----------------------------------------------------------------------------
+// data, size
+// Preconditions:   None
+// Postconditions:  Returns the text held and its length in bytes
+    const char* data() const;
+    size_t size() const;
+
+//----------------------------------------------------------------------------
+// good
+// Preconditions:   None
+// Postconditions:  Returns false if writing out has failed
+    bool good() const;
+
+private:
+    vector<char> bytes;             // text not yet written out
+    size_t used;                    // bytes of the array in use
+    int fd;                         // file descriptor written to, -1 if none
+    ostream* stream;                // stream written to, nullptr if none
+    bool failed;                    // whether writing out has failed
+
+//----------------------------------------------------------------------------
+// make
+// Preconditions:   None
+// Postconditions:  Array has room for the given number of bytes, by writing
+//                  out or growing, unless more than the whole array is asked
+//                  of a buffer that writes out
+    void make(size_t);
+
+//----------------------------------------------------------------------------
+// emit
+// Preconditions:   Array holds the given number of characters
+// Postconditions:  Characters are written to the file descriptor or stream
+    void emit(const char*, size_t);
+};
+
+#endif
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+// PAIRINGHEAP.H
+// Class for an indexed pairing min heap
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// PairingHeap: priority queue of vertex ids keyed by distance
+// and allows other features:
+//      --insertion of a vertex, or lowering the key of a vertex already held
+//        (decrease-key) through a single update call
+//      --removal of the vertex with the minimum key
+//
+// Implementation and assumptions:
+//      --every vertex id owns one tree node, nodes are linked through the
+//        child, sibling and prev arrays so no memory is allocated per call
+//      --prev holds the parent for a leftmost child and the left sibling for
+//        every other child
+//      --decrease-key cuts the subtree of the vertex and melds it with the
+//        root, pop uses the standard two-pass pairing of the root's children
+//      --ties between equal keys are broken by the lower vertex id, this
+//        matches the order GraphM::findV picks vertices in
+//      --vertex ids are assumed to be in the range 0 to n given to reset
+//----------------------------------------------------------------------------
+
+#ifndef PAIRINGHEAP_H
+#define PAIRINGHEAP_H
+
+#include <vector>
+
+using namespace std;
+
+class PairingHeap {
+public:
+//----------------------------------------------------------------------------
+// reset
+// Preconditions:   None
+// Postconditions:  Heap is emptied and can hold vertex ids 0 to n
+    void reset(int n) {
+        root = -1;
+        child.assign(n + 1, -1);
+        sibling.assign(n + 1, -1);
+        prev.assign(n + 1, -1);
+        key.resize(n + 1);
+        held.assign(n + 1, false);
+    }
+
+//----------------------------------------------------------------------------
+// empty
+// Preconditions:   None
+// Postconditions:  Returns true if no vertices are held in the heap
+    bool empty() const {
+        return root == -1;
+    }
+
+//----------------------------------------------------------------------------
+// update
+// Preconditions:   k is not greater than the key currently held for v
+// Postconditions:  v is inserted with key k, or its key is lowered to k if v
+//                  is already in the heap
+    void update(int v, int k) {
+        key[v] = k;
+        if(!held[v]) {
+            held[v] = true;
+            child[v] = sibling[v] = prev[v] = -1;
+            root = root == -1 ? v : meld(root, v);
+            return;
+        }
+        if(v == root) {
+            return;
+        }
+        // Cut v and its subtree away from its parent
+        if(child[prev[v]] == v) {
+            child[prev[v]] = sibling[v];
+        }
+        else {
+            sibling[prev[v]] = sibling[v];
+        }
+        if(sibling[v] != -1) {
+            prev[sibling[v]] = prev[v];
+        }
+        sibling[v] = prev[v] = -1;
+        root = meld(root, v);
+    }
+
+//----------------------------------------------------------------------------
+// pop
+// Preconditions:   Heap is not empty
+// Postconditions:  Vertex with the minimum key is removed and returned
+    int pop() {
+        int top = root;
+        held[top] = false;
+
+        // First pass, meld the children in pairs from left to right
+        pairs.clear();
+        int c = child[top];
+        while(c != -1) {
+            int next = sibling[c];
+            sibling[c] = prev[c] = -1;
+            if(next == -1) {
+                pairs.push_back(c);
+                break;
+            }
+            int after = sibling[next];
+            sibling[next] = prev[next] = -1;
+            pairs.push_back(meld(c, next));
+            c = after;
+        }
+
+        // Second pass, meld the pairs from right to left
+        root = -1;
+        for(int i = (int)pairs.size() - 1; i >= 0; i--) {
+            root = root == -1 ? pairs[i] : meld(pairs[i], root);
+        }
+        return top;
+    }
+
+private:
+    int root = -1;          // vertex at the root of the heap, -1 if empty
+    vector<int> child;      // leftmost child of each vertex
+    vector<int> sibling;    // right sibling of each vertex
+    vector<int> prev;       // parent or left sibling of each vertex
+    vector<int> key;        // key of each vertex
+    vector<bool> held;      // whether vertex is in the heap
+    vector<int> pairs;      // scratch space for pop
+
+//----------------------------------------------------------------------------
+// less
+// Preconditions:   None
+// Postconditions:  Returns true if vertex a comes before vertex b
+    bool less(int a, int b) const {
+        return key[a] < key[b] || (key[a] == key[b] && a < b);
+    }
+
+//----------------------------------------------------------------------------
+// meld
+// Preconditions:   a and b are roots of separate trees with no siblings
+// Postconditions:  The higher root becomes the leftmost child of the lower
+//                  root, the lower root is returned
+    int meld(int a, int b) {
+        if(less(b, a)) {
+            int temp = a;
+            a = b;
+            b = temp;
+        }
+        sibling[b] = child[a];
+        if(child[a] != -1) {
+            prev[child[a]] = b;
+        }
+        prev[b] = a;
+        child[a] = b;
+        return a;
+    }
+};
+
+#endif
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+// PATHROW.H
+// Class for one source's row of a shortest path table
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// PathRow: shortest distance and previous node of every node from a source
+// and allows other features:
+//      --resetting the row for a source and a number of nodes
+//      --reading and writing the distance and previous node of a node
+//
+// Implementation and assumptions:
+//      --stored as a structure of arrays: one array of int distances and one
+//        array of previous nodes, so a loop that only reads distances does
+//        not pull previous nodes into the cache
+//      --previous nodes are stored in 16 bits when there are fewer than 65536
+//        nodes and in 32 bits otherwise, so an entry takes 6 or 8 bytes
+//      --a distance of INT_MAX means the node cannot be reached, a previous
+//        node of 0 means there is none
+//      --node ids are assumed to be in the range 0 to n given to reset
+//----------------------------------------------------------------------------
+
+#ifndef PATHROW_H
+#define PATHROW_H
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class PathRow {
+public:
+//----------------------------------------------------------------------------
+// reset
+// Preconditions:   source is in the range 0 to n
+// Postconditions:  Row holds nodes 0 to n, every distance is infinity except
+//                  the source's 0, every previous node is 0
+    void reset(int n, int source) {
+        dists.assign(n + 1, INT_MAX);
+        wide = n >= 65536;
+        if(wide) {
+            narrow.clear();
+            broad.assign(n + 1, 0);
+        }
+        else {
+            broad.clear();
+            narrow.assign(n + 1, 0);
+        }
+        dists[source] = 0;
+    }
+
+//----------------------------------------------------------------------------
+// size
+// Preconditions:   None
+// Postconditions:  Returns the number of entries, nodes + 1
+    int size() const {
+        return dists.size();
+    }
+
+//----------------------------------------------------------------------------
+// dist, setDist
+// Preconditions:   v is in range
+// Postconditions:  Returns or sets the shortest known distance to v
+    int dist(int v) const {
+        return dists[v];
+    }
+    void setDist(int v, int d) {
+        dists[v] = d;
+    }
+
+//----------------------------------------------------------------------------
+// path, setPath
+// Preconditions:   v is in range
+// Postconditions:  Returns or sets the previous node on the path to v
+    int path(int v) const {
+        return wide ? broad[v] : narrow[v];
+    }
+    void setPath(int v, int p) {
+        if(wide) {
+            broad[v] = p;
+        }
+        else {
+            narrow[v] = p;
+        }
+    }
+
+//----------------------------------------------------------------------------
+// memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the bytes held by the row
+    size_t memoryBytes() const {
+        return dists.capacity() * sizeof(int) +
+               narrow.capacity() * sizeof(uint16_t) +
+               broad.capacity() * sizeof(uint32_t);
+    }
+
+//----------------------------------------------------------------------------
+// bytesFor
+// Preconditions:   None
+// Postconditions:  Returns the bytes a row reset for n nodes holds
+    static size_t bytesFor(int n) {
+        return (size_t)(n + 1) * (sizeof(int) +
+               (n >= 65536 ? sizeof(uint32_t) : sizeof(uint16_t)));
+    }
+
+private:
+    vector<int> dists;          // shortest known distance of each node
+    vector<uint16_t> narrow;    // previous node of each node, small graphs
+    vector<uint32_t> broad;     // previous node of each node, large graphs
+    bool wide = false;          // whether broad is in use
+};
+
+#endif
@@ -0,0 +1,377 @@
+//----------------------------------------------------------------------------
+// PATHTABLE.CPP
+// Implementation for PathTable Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// PathTable: shortest distance and previous node of every pair of nodes,
+// held in a file instead of memory
+// and allows other features:
+//      --storing a source's PathRow into the file, from any thread
+//      --reading a row where it lies in the mapping, with no copy
+//      --distances in 1, 2 or 4 bytes, for tables too big for 4
+//      --keeping the rows already done when a file for the same graph is
+//        opened again, so a table can be finished after a crash
+//
+// Implementation and assumptions:
+//      --the file is a header, one done flag per row, then the rows in order
+//        of source, each row holding the distances of nodes 0 to n then
+//        their previous nodes, each part padded to 8 bytes, so the place of
+//        any entry is found from the source and node alone
+//      --previous nodes are stored in 16 bits when there are fewer than 65536
+//        nodes and in 32 bits otherwise, as a PathRow holds them
+//      --1 and 2 byte distances are unsigned and their largest value means
+//        the node cannot be reached, a row with a distance that does not fit
+//        is not stored
+//      --the header holds a key given by the caller, such as a checksum of
+//        the graph, a file whose header does not match the graph, width and
+//        key asked for is made again with no rows done
+//      --stored rows only count as done once commit has written them to
+//        disk and then set their flags, so a flag never outlives its row,
+//        commit then drops the rows from memory, the page cache holds them
+//      --the file is mapped shared and grows as rows are written, a table of
+//        n nodes takes about n^2 times the bytes of a distance and a
+//        previous node on disk, a disk that fills up while rows are
+//        written ends the program with SIGBUS, as for any shared mapping
+//      --a table can be moved but not copied, only one object ever unmaps
+//        the file
+//      --store may run on several threads for different sources, every
+//        other call must come from one thread
+//      --node ids are in the range 1 to the node count, node 0 is not used
+//----------------------------------------------------------------------------
+
+#include "pathtable.h"
+#include "graphsnapshot.h"
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+// Rows start on a boundary of this many bytes, a page on common machines,
+// so syncing and dropping rows never touches the page of the flags
+static const size_t ROW_ALIGN = 4096;
+
+//----------------------------------------------------------------------------
+// padded
+// Preconditions:   None
+// Postconditions:  Returns the bytes rounded up to a multiple of 8
+static size_t padded(size_t bytes) {
+    return (bytes + 7) & ~(size_t)7;
+}
+
+//----------------------------------------------------------------------------
+// narrowDistances
+// Preconditions:   Row holds nodes 0 to n
+// Postconditions:  Row's distances are written to the array, INT_MAX as the
+//                  largest value of the type, returns false if one does not
+//                  fit below that
+template <class Narrow>
+static bool narrowDistances(const PathRow& r, int n, Narrow* to) {
+    const int unreachable = numeric_limits<Narrow>::max();
+    for(int v = 0; v <= n; v++) {
+        int d = r.dist(v);
+        if(d == INT_MAX) {
+            d = unreachable;
+        }
+        else if(d < 0 || d >= unreachable) {
+            return false;
+        }
+        to[v] = d;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No table is open
+PathTable::PathTable() : base(nullptr), bytes(0), rowsStart(0), rowsDone(0) {
+    memset(&header, 0, sizeof(header));
+}
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  Rows committed are on disk and the file is unmapped
+PathTable::~PathTable() {
+    close();
+}
+
+//----------------------------------------------------------------------------
+// Move constructor
+// Preconditions:   None
+// Postconditions:  Table holds the other's mapping and rows stored, the
+//                  other holds none
+PathTable::PathTable(PathTable&& other) noexcept : PathTable() {
+    *this = move(other);
+}
+
+//----------------------------------------------------------------------------
+// move operator=
+// Preconditions:   None
+// Postconditions:  Table holds the other's mapping and rows stored, any
+//                  table held before is closed, the other holds none
+PathTable& PathTable::operator=(PathTable&& other) noexcept {
+    if(this == &other) {
+        return *this;
+    }
+    close();
+    base = other.base;
+    bytes = other.bytes;
+    header = other.header;
+    rowsStart = other.rowsStart;
+    stored = move(other.stored);
+    rowsDone = other.rowsDone;
+
+    // Left as close leaves it, so the mapping is only unmapped once
+    other.base = nullptr;
+    other.bytes = 0;
+    memset(&other.header, 0, sizeof(other.header));
+    other.rowsStart = 0;
+    other.stored.clear();
+    other.rowsDone = 0;
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   Width is 1, 2 or 4
+// Postconditions:  Returns true and holds the mapped table for the number
+//                  of nodes, with the rows already done kept if the file's
+//                  header matches the count, width and key, otherwise made
+//                  again with none done, returns false and holds none if the
+//                  file cannot be made
+bool PathTable::open(const string& path, int nodes, int width, uint64_t key) {
+    close();
+    if(nodes < 0 || (width != 1 && width != 2 && width != 4)) {
+        return false;
+    }
+
+    Header want;
+    memset(&want, 0, sizeof(want));
+    want.magic = MAGIC;
+    want.version = VERSION;
+    want.order = ORDER_MARK;
+    want.nodes = nodes;
+    want.distBytes = width;
+    want.pathBytes = nodes >= 65536 ? 4 : 2;
+    want.rowBytes = padded((size_t)(nodes + 1) * want.distBytes) +
+                    padded((size_t)(nodes + 1) * want.pathBytes);
+    want.key = key;
+    want.headerSum = GraphSnapshot::hash(GraphSnapshot::HASH_BASIS,
+                                         (const char*)&want,
+                                         offsetof(Header, headerSum));
+    size_t start = (sizeof(Header) + nodes + 1 + ROW_ALIGN - 1) &
+                   ~(ROW_ALIGN - 1);
+    size_t total = start + (size_t)nodes * want.rowBytes;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd < 0) {
+        return false;
+    }
+
+    // A file of another graph, or one cut short, starts over
+    struct stat info;
+    Header found;
+    bool keep = fstat(fd, &info) == 0 && info.st_size == (off_t)total &&
+                pread(fd, &found, sizeof(found), 0) == sizeof(found) &&
+                memcmp(&found, &want, sizeof(want)) == 0;
+    if(!keep && (ftruncate(fd, 0) != 0 || ftruncate(fd, total) != 0)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED) {
+        return false;
+    }
+    base = (char*)mapped;
+    bytes = total;
+    header = want;
+    rowsStart = start;
+    if(!keep) {
+        memcpy(base, &want, sizeof(want));
+    }
+
+    stored.assign(nodes + 1, 0);
+    rowsDone = 0;
+    for(int s = 1; s <= nodes; s++) {
+        rowsDone += done(s);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No table is open, rows committed are on disk and the file
+//                  is unmapped, rows stored but not committed may be lost
+void PathTable::close() {
+    if(base != nullptr) {
+        munmap(base, bytes);
+    }
+    base = nullptr;
+    bytes = 0;
+    memset(&header, 0, sizeof(header));
+    rowsStart = 0;
+    stored.clear();
+    rowsDone = 0;
+}
+
+//----------------------------------------------------------------------------
+// isOpen
+// Preconditions:   None
+// Postconditions:  Returns true if a table is open
+bool PathTable::isOpen() const {
+    return base != nullptr;
+}
+
+//----------------------------------------------------------------------------
+// store
+// Preconditions:   Table is open, row is the source's and sized for the
+//                  table's nodes
+// Postconditions:  Row is written to the file and returns true, returns false
+//                  and leaves the source not done if a distance does not fit
+//                  the width, the row is only done once committed
+bool PathTable::store(int source, const PathRow& r) {
+    int n = header.nodes;
+    char* dists = rowAt(source);
+    char* paths = dists + padded((size_t)(n + 1) * header.distBytes);
+
+    bool fits = true;
+    if(header.distBytes == 4) {
+        int32_t* to = (int32_t*)dists;
+        for(int v = 0; v <= n; v++) {
+            to[v] = r.dist(v);
+        }
+    }
+    else if(header.distBytes == 2) {
+        fits = narrowDistances(r, n, (uint16_t*)dists);
+    }
+    else {
+        fits = narrowDistances(r, n, (uint8_t*)dists);
+    }
+    if(!fits) {
+        return false;
+    }
+
+    if(header.pathBytes == 4) {
+        uint32_t* to = (uint32_t*)paths;
+        for(int v = 0; v <= n; v++) {
+            to[v] = r.path(v);
+        }
+    }
+    else {
+        uint16_t* to = (uint16_t*)paths;
+        for(int v = 0; v <= n; v++) {
+            to[v] = r.path(v);
+        }
+    }
+    stored[source] = 1;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// commit
+// Preconditions:   Table is open, no store is running
+// Postconditions:  Rows stored from source 1 up to source 2 are written to
+//                  disk, then marked done and their flags written, returns
+//                  false if the file could not be written
+bool PathTable::commit(int first, int last) {
+    first = first < 1 ? 1 : first;
+    last = last > header.nodes + 1 ? header.nodes + 1 : last;
+    bool any = false;
+    for(int s = first; s < last; s++) {
+        any = any || stored[s];
+    }
+    if(!any) {
+        return true;
+    }
+
+    // Rows reach the disk before the flags that say they are there
+    size_t from = rowAt(first) - base;
+    size_t length = (size_t)(last - first) * header.rowBytes;
+    if(!flush(from, length)) {
+        return false;
+    }
+    char* flags = base + sizeof(Header);
+    for(int s = first; s < last; s++) {
+        if(stored[s]) {
+            flags[s] = 1;
+            stored[s] = 0;
+            rowsDone++;
+        }
+    }
+    bool written = flush(sizeof(Header), header.nodes + 1);
+
+    // Written pages stay in the page cache, the process need not hold them
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t begin = from & ~(page - 1);
+    madvise(base + begin, from + length - begin, MADV_DONTNEED);
+    return written;
+}
+
+//----------------------------------------------------------------------------
+// done, doneCount
+// Preconditions:   None
+// Postconditions:  Returns whether the source's row is done, and the number
+//                  of rows done
+bool PathTable::done(int source) const {
+    return base != nullptr && source >= 1 && source <= header.nodes &&
+           base[sizeof(Header) + source] != 0;
+}
+int PathTable::doneCount() const {
+    return rowsDone;
+}
+
+//----------------------------------------------------------------------------
+// row
+// Preconditions:   Source's row is done
+// Postconditions:  Returns the source's row, valid until the table is closed
+PathTable::Row PathTable::row(int source) const {
+    Row r;
+    r.dists = rowAt(source);
+    r.paths = r.dists + padded((size_t)(header.nodes + 1) * header.distBytes);
+    r.distBytes = header.distBytes;
+    r.pathBytes = header.pathBytes;
+    r.unreachable = header.distBytes == 1 ? UINT8_MAX : UINT16_MAX;
+    return r;
+}
+
+//----------------------------------------------------------------------------
+// nodeCount, distBytes, fileBytes
+// Preconditions:   None
+// Postconditions:  Returns the nodes and the width of a distance of the open
+//                  table, and the size of its file, 0 if none is open
+int PathTable::nodeCount() const {
+    return header.nodes;
+}
+int PathTable::distBytes() const {
+    return header.distBytes;
+}
+size_t PathTable::fileBytes() const {
+    return bytes;
+}
+
+//----------------------------------------------------------------------------
+// rowAt
+// Preconditions:   Table is open, source is in range
+// Postconditions:  Returns where the source's row starts in the mapping
+char* PathTable::rowAt(int source) const {
+    return base + rowsStart + (size_t)(source - 1) * header.rowBytes;
+}
+
+//----------------------------------------------------------------------------
+// flush
+// Preconditions:   Table is open
+// Postconditions:  Bytes of the mapping from the offset on are written to
+//                  disk, returns false if they could not be, the range is
+//                  widened to whole pages
+bool PathTable::flush(size_t from, size_t length) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t begin = from & ~(page - 1);
+    return msync(base + begin, from + length - begin, MS_SYNC) == 0;
+}
@@ -0,0 +1,217 @@
+//----------------------------------------------------------------------------
+// PATHTABLE.H
+// Class for a shortest path table kept in a memory mapped file
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// PathTable: shortest distance and previous node of every pair of nodes,
+// held in a file instead of memory
+// and allows other features:
+//      --storing a source's PathRow into the file, from any thread
+//      --reading a row where it lies in the mapping, with no copy
+//      --distances in 1, 2 or 4 bytes, for tables too big for 4
+//      --keeping the rows already done when a file for the same graph is
+//        opened again, so a table can be finished after a crash
+//
+// Implementation and assumptions:
+//      --the file is a header, one done flag per row, then the rows in order
+//        of source, each row holding the distances of nodes 0 to n then
+//        their previous nodes, each part padded to 8 bytes, so the place of
+//        any entry is found from the source and node alone
+//      --previous nodes are stored in 16 bits when there are fewer than 65536
+//        nodes and in 32 bits otherwise, as a PathRow holds them
+//      --1 and 2 byte distances are unsigned and their largest value means
+//        the node cannot be reached, a row with a distance that does not fit
+//        is not stored
+//      --the header holds a key given by the caller, such as a checksum of
+//        the graph, a file whose header does not match the graph, width and
+//        key asked for is made again with no rows done
+//      --stored rows only count as done once commit has written them to
+//        disk and then set their flags, so a flag never outlives its row,
+//        commit then drops the rows from memory, the page cache holds them
+//      --the file is mapped shared and grows as rows are written, a table of
+//        n nodes takes about n^2 times the bytes of a distance and a
+//        previous node on disk, a disk that fills up while rows are
+//        written ends the program with SIGBUS, as for any shared mapping
+//      --a table can be moved but not copied, only one object ever unmaps
+//        the file
+//      --store may run on several threads for different sources, every
+//        other call must come from one thread
+//      --node ids are in the range 1 to the node count, node 0 is not used
+//----------------------------------------------------------------------------
+
+#ifndef PATHTABLE_H
+#define PATHTABLE_H
+
+#include "pathrow.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class PathTable {
+public:
+    // Source's row as it lies in the mapped file, read like a PathRow
+    class Row {
+    public:
+//----------------------------------------------------------------------------
+// dist
+// Preconditions:   v is in range
+// Postconditions:  Returns the shortest distance to v, INT_MAX if there is
+//                  no path
+        int dist(int v) const {
+            if(distBytes == 4) {
+                return ((const int32_t*)dists)[v];
+            }
+            unsigned d = distBytes == 2 ? ((const uint16_t*)dists)[v]
+                                        : ((const uint8_t*)dists)[v];
+            return d == unreachable ? INT_MAX : (int)d;
+        }
+
+//----------------------------------------------------------------------------
+// path
+// Preconditions:   v is in range
+// Postconditions:  Returns the previous node on the path to v
+        int path(int v) const {
+            return pathBytes == 4 ? (int)((const uint32_t*)paths)[v]
+                                  : ((const uint16_t*)paths)[v];
+        }
+
+    private:
+        friend class PathTable;
+        const char* dists;      // distances of the row in the file
+        const char* paths;      // previous nodes of the row in the file
+        int distBytes;          // bytes of a distance
+        int pathBytes;          // bytes of a previous node
+        unsigned unreachable;   // narrow distance meaning INT_MAX
+    };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  No table is open
+    PathTable();
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   None
+// Postconditions:  Rows committed are on disk and the file is unmapped
+    ~PathTable();
+
+    PathTable(const PathTable&) = delete;
+    PathTable& operator=(const PathTable&) = delete;
+
+//----------------------------------------------------------------------------
+// Move constructor, move operator=
+// Preconditions:   None
+// Postconditions:  Table holds the other's mapping and rows stored, any
+//                  table held before is closed, the other holds none
+    PathTable(PathTable&&) noexcept;
+    PathTable& operator=(PathTable&&) noexcept;
+
+//----------------------------------------------------------------------------
+// open
+// Preconditions:   Width is 1, 2 or 4
+// Postconditions:  Returns true and holds the mapped table for the number
+//                  of nodes, with the rows already done kept if the file's
+//                  header matches the count, width and key, otherwise made
+//                  again with none done, returns false and holds none if the
+//                  file cannot be made
+    bool open(const string&, int, int, uint64_t);
+
+//----------------------------------------------------------------------------
+// close
+// Preconditions:   None
+// Postconditions:  No table is open, rows committed are on disk and the file
+//                  is unmapped, rows stored but not committed may be lost
+    void close();
+
+//----------------------------------------------------------------------------
+// isOpen
+// Preconditions:   None
+// Postconditions:  Returns true if a table is open
+    bool isOpen() const;
+
+//----------------------------------------------------------------------------
+// store
+// Preconditions:   Table is open, row is the source's and sized for the
+//                  table's nodes
+// Postconditions:  Row is written to the file and returns true, returns false
+//                  and leaves the source not done if a distance does not fit
+//                  the width, the row is only done once committed
+    bool store(int, const PathRow&);
+
+//----------------------------------------------------------------------------
+// commit
+// Preconditions:   Table is open, no store is running
+// Postconditions:  Rows stored from source 1 up to source 2 are written to
+//                  disk, then marked done and their flags written, returns
+//                  false if the file could not be written
+    bool commit(int, int);
+
+//----------------------------------------------------------------------------
+// done, doneCount
+// Preconditions:   None
+// Postconditions:  Returns whether the source's row is done, and the number
+//                  of rows done
+    bool done(int) const;
+    int doneCount() const;
+
+//----------------------------------------------------------------------------
+// row
+// Preconditions:   Source's row is done
+// Postconditions:  Returns the source's row, valid until the table is closed
+    Row row(int) const;
+
+//----------------------------------------------------------------------------
+// nodeCount, distBytes, fileBytes
+// Preconditions:   None
+// Postconditions:  Returns the nodes and the width of a distance of the open
+//                  table, and the size of its file, 0 if none is open
+    int nodeCount() const;
+    int distBytes() const;
+    size_t fileBytes() const;
+
+private:
+    static const uint64_t MAGIC = 0x314c425448544150ULL;  // "PATHTBL1"
+    static const uint32_t VERSION = 1;                     // file layout
+    static const uint32_t ORDER_MARK = 0x01020304;         // reads swapped
+
+    struct Header {
+        uint64_t magic;             // MAGIC
+        uint32_t version;           // VERSION
+        uint32_t order;             // ORDER_MARK as the writer stored it
+        int32_t nodes;              // number of nodes
+        uint32_t distBytes;         // bytes of a distance
+        uint32_t pathBytes;         // bytes of a previous node
+        uint32_t unused;            // 0, keeps the fields below aligned
+        uint64_t rowBytes;          // bytes of one row
+        uint64_t key;               // caller's key, such as a graph checksum
+        uint64_t headerSum;         // of the fields above
+    };
+
+    char* base;                     // start of the mapping, nullptr if none
+    size_t bytes;                   // length of the mapping
+    Header header;                  // copy of the file's header
+    size_t rowsStart;               // where the row of source 1 starts
+    vector<char> stored;            // rows stored but not yet committed
+    int rowsDone;                   // number of done flags set
+
+//----------------------------------------------------------------------------
+// rowAt
+// Preconditions:   Table is open, source is in range
+// Postconditions:  Returns where the source's row starts in the mapping
+    char* rowAt(int) const;
+
+//----------------------------------------------------------------------------
+// flush
+// Preconditions:   Table is open
+// Postconditions:  Bytes of the mapping from the offset on are written to
+//                  disk, returns false if they could not be, the range is
+//                  widened to whole pages
+    bool flush(size_t, size_t);
+};
+
+#endif
@@ -0,0 +1,273 @@
+//----------------------------------------------------------------------------
+// REACHINDEX.CPP
+// Implementation for ReachIndex Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ReachIndex: answers whether one node can reach another with no search
+// and allows other features:
+//      --a transitive closure for small and medium graphs, or 2-hop labels
+//        for large ones, picked from the size of the condensation
+//      --the time it took to build and the memory it holds
+//
+// Implementation and assumptions:
+//      --built over the condensation of a Components, so nodes of the same
+//        component reach each other, a component numbered after another
+//        cannot reach it, and only the components are indexed
+//      --the closure holds a row of bits per component, bit d of row c set
+//        if c reaches d, rows are made from the last component back, each
+//        row the OR of the rows of the components its edges go to, a word
+//        at a time from the word of that component on, as bits before it
+//        are never set, a query is one bit
+//      --the closure takes components^2 / 8 bytes, AUTO uses it while that
+//        is at most CLOSURE_BYTES
+//      --2-hop labels give each component a list of landmarks it reaches and
+//        a list of landmarks that reach it, c reaches d if the lists share a
+//        landmark, the labels are made by pruned searches (Akiba, Iwata and
+//        Yoshida) from each component in order of edges in times edges out,
+//        a search stops at a component already answered by the labels made
+//        so far, a query merges 2 short sorted lists
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#include "reachindex.h"
+#include <algorithm>
+#include <chrono>
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Index is empty, the method is AUTO
+ReachIndex::ReachIndex()
+    : chosen(AUTO), used(AUTO), buildTime(0), rowWords(0) {
+}
+
+//----------------------------------------------------------------------------
+// setMethod
+// Preconditions:   None
+// Postconditions:  Later calls to build use the given method, the default is
+//                  AUTO
+void ReachIndex::setMethod(Method value) {
+    chosen = value;
+}
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Components have been solved
+// Postconditions:  Index answers reaches for the graph of the components
+void ReachIndex::build(const Components& found) {
+    auto start = chrono::steady_clock::now();
+    ids.resize(found.nodeCount() + 1);
+    ids[0] = 0;
+    for(int v = 1; v <= found.nodeCount(); v++) {
+        ids[v] = found.component(v);
+    }
+
+    EdgeRows dag = found.condensation();
+    size_t closureBytes = (size_t)(dag.nodes + 1) *
+                          (dag.nodes / 64 + 1) * sizeof(uint64_t);
+    used = chosen;
+    if(used == AUTO) {
+        used = closureBytes <= CLOSURE_BYTES ? CLOSURE : TWO_HOP;
+    }
+
+    // Only the arrays of the method used are kept
+    closure.clear();
+    closure.shrink_to_fit();
+    outStarts.clear();
+    outLabels.clear();
+    inStarts.clear();
+    inLabels.clear();
+    if(used == CLOSURE) {
+        buildClosure(dag);
+    }
+    else {
+        buildLabels(dag);
+    }
+    auto stop = chrono::steady_clock::now();
+    buildTime = chrono::duration<double, milli>(stop - start).count();
+}
+
+//----------------------------------------------------------------------------
+// reaches
+// Preconditions:   build has been called, nodes are in range
+// Postconditions:  Returns true if there is a path from the first node to
+//                  the second
+bool ReachIndex::reaches(int from, int to) const {
+    int c = ids[from], d = ids[to];
+    if(c == d) {
+        return true;
+    }
+    if(c > d) {
+        return false;
+    }
+    if(used == CLOSURE) {
+        return (closure[(size_t)c * rowWords + (d >> 6)] >> (d & 63)) & 1;
+    }
+    return share(outLabels.data() + outStarts[c],
+                 outLabels.data() + outStarts[c + 1],
+                 inLabels.data() + inStarts[d],
+                 inLabels.data() + inStarts[d + 1]);
+}
+
+//----------------------------------------------------------------------------
+// method
+// Preconditions:   None
+// Postconditions:  Returns the method the last build used, AUTO if none
+ReachIndex::Method ReachIndex::method() const {
+    return used;
+}
+
+//----------------------------------------------------------------------------
+// buildMs, memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the milliseconds the last build took, and the
+//                  bytes the index holds
+double ReachIndex::buildMs() const {
+    return buildTime;
+}
+size_t ReachIndex::memoryBytes() const {
+    return ids.capacity() * sizeof(int) +
+           closure.capacity() * sizeof(uint64_t) +
+           (outStarts.capacity() + outLabels.capacity() +
+            inStarts.capacity() + inLabels.capacity()) * sizeof(int);
+}
+
+//----------------------------------------------------------------------------
+// buildClosure
+// Preconditions:   Components are numbered in topological order
+// Postconditions:  Closure row of every component is made
+void ReachIndex::buildClosure(const EdgeRows& dag) {
+    rowWords = dag.nodes / 64 + 1;
+    closure.assign((size_t)(dag.nodes + 1) * rowWords, 0);
+
+    // Edges only go to higher numbers, so every row a row is made from is
+    // already done
+    for(int c = dag.nodes; c >= 1; c--) {
+        uint64_t* row = closure.data() + (size_t)c * rowWords;
+        row[c >> 6] |= uint64_t(1) << (c & 63);
+        for(int e = dag.begin(c); e < dag.end(c); e++) {
+            int d = dag.targets[e];
+            const uint64_t* from = closure.data() + (size_t)d * rowWords;
+            for(int w = d >> 6; w < rowWords; w++) {
+                row[w] |= from[w];
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// buildLabels
+// Preconditions:   Components are numbered in topological order
+// Postconditions:  2-hop labels of every component are made
+void ReachIndex::buildLabels(const EdgeRows& dag) {
+    int n = dag.nodes;
+
+    // Reverse of the condensation, for the searches backward
+    vector<int> backStarts(n + 2, 0);
+    vector<int> back(dag.edgeCount());
+    for(int e = 0; e < dag.edgeCount(); e++) {
+        backStarts[dag.targets[e]]++;
+    }
+    for(int c = 1; c <= n + 1; c++) {
+        backStarts[c] += backStarts[c - 1];
+    }
+    for(int c = n; c >= 1; c--) {
+        for(int e = dag.end(c) - 1; e >= dag.begin(c); e--) {
+            back[--backStarts[dag.targets[e]]] = c;
+        }
+    }
+
+    // Components through which many paths pass are landmarks first, their
+    // labels answer the most queries and prune the later searches most
+    vector<int> order(n);
+    for(int c = 1; c <= n; c++) {
+        order[c - 1] = c;
+    }
+    auto weight = [&](int c) {
+        return (long)(backStarts[c + 1] - backStarts[c] + 1) *
+               (dag.degree(c) + 1);
+    };
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return weight(a) > weight(b);
+    });
+
+    // Landmarks are added in rank order, so every list stays sorted
+    vector<vector<int>> outs(n + 1);
+    vector<vector<int>> ins(n + 1);
+    auto answered = [&](int c, int d) {
+        return share(outs[c].data(), outs[c].data() + outs[c].size(),
+                     ins[d].data(), ins[d].data() + ins[d].size());
+    };
+    vector<int> mark(n + 1, -1);
+    vector<int> queue;
+    for(int rank = 0; rank < n; rank++) {
+        int k = order[rank];
+        queue.assign(1, k);
+        mark[k] = 2 * rank;
+        for(size_t q = 0; q < queue.size(); q++) {
+            int c = queue[q];
+            if(answered(k, c)) {
+                continue;
+            }
+            ins[c].push_back(rank);
+            for(int e = dag.begin(c); e < dag.end(c); e++) {
+                int d = dag.targets[e];
+                if(mark[d] != 2 * rank) {
+                    mark[d] = 2 * rank;
+                    queue.push_back(d);
+                }
+            }
+        }
+
+        queue.assign(1, k);
+        mark[k] = 2 * rank + 1;
+        for(size_t q = 0; q < queue.size(); q++) {
+            int c = queue[q];
+            if(answered(c, k)) {
+                continue;
+            }
+            outs[c].push_back(rank);
+            for(int e = backStarts[c]; e < backStarts[c + 1]; e++) {
+                int d = back[e];
+                if(mark[d] != 2 * rank + 1) {
+                    mark[d] = 2 * rank + 1;
+                    queue.push_back(d);
+                }
+            }
+        }
+    }
+
+    // Lists are laid end to end, as the edges of a GraphL are
+    outStarts.assign(n + 2, 0);
+    inStarts.assign(n + 2, 0);
+    for(int c = 1; c <= n; c++) {
+        outStarts[c + 1] = outStarts[c] + outs[c].size();
+        inStarts[c + 1] = inStarts[c] + ins[c].size();
+    }
+    outLabels.reserve(outStarts[n + 1]);
+    inLabels.reserve(inStarts[n + 1]);
+    for(int c = 1; c <= n; c++) {
+        outLabels.insert(outLabels.end(), outs[c].begin(), outs[c].end());
+        inLabels.insert(inLabels.end(), ins[c].begin(), ins[c].end());
+    }
+}
+
+//----------------------------------------------------------------------------
+// share
+// Preconditions:   Lists are sorted
+// Postconditions:  Returns true if the 2 lists hold a value in common
+bool ReachIndex::share(const int* a, const int* aEnd, const int* b,
+                       const int* bEnd) {
+    while(a != aEnd && b != bEnd) {
+        if(*a == *b) {
+            return true;
+        }
+        if(*a < *b) {
+            a++;
+        }
+        else {
+            b++;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,124 @@
+//----------------------------------------------------------------------------
+// REACHINDEX.H
+// Class for an index of which nodes of a directed graph reach which
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ReachIndex: answers whether one node can reach another with no search
+// and allows other features:
+//      --a transitive closure for small and medium graphs, or 2-hop labels
+//        for large ones, picked from the size of the condensation
+//      --the time it took to build and the memory it holds
+//
+// Implementation and assumptions:
+//      --built over the condensation of a Components, so nodes of the same
+//        component reach each other, a component numbered after another
+//        cannot reach it, and only the components are indexed
+//      --the closure holds a row of bits per component, bit d of row c set
+//        if c reaches d, rows are made from the last component back, each
+//        row the OR of the rows of the components its edges go to, a word
+//        at a time from the word of that component on, as bits before it
+//        are never set, a query is one bit
+//      --the closure takes components^2 / 8 bytes, AUTO uses it while that
+//        is at most CLOSURE_BYTES
+//      --2-hop labels give each component a list of landmarks it reaches and
+//        a list of landmarks that reach it, c reaches d if the lists share a
+//        landmark, the labels are made by pruned searches (Akiba, Iwata and
+//        Yoshida) from each component in order of edges in times edges out,
+//        a search stops at a component already answered by the labels made
+//        so far, a query merges 2 short sorted lists
+//      --node ids are in the range 1 to the node count of the graph
+//----------------------------------------------------------------------------
+
+#ifndef REACHINDEX_H
+#define REACHINDEX_H
+
+#include "components.h"
+#include "edgerows.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class ReachIndex {
+public:
+    enum Method {
+        AUTO,               // CLOSURE if it fits in CLOSURE_BYTES
+        CLOSURE,            // a row of bits per component
+        TWO_HOP             // landmark labels
+    };
+
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Index is empty, the method is AUTO
+    ReachIndex();
+
+//----------------------------------------------------------------------------
+// setMethod
+// Preconditions:   None
+// Postconditions:  Later calls to build use the given method, the default is
+//                  AUTO
+    void setMethod(Method);
+
+//----------------------------------------------------------------------------
+// build
+// Preconditions:   Components have been solved
+// Postconditions:  Index answers reaches for the graph of the components
+    void build(const Components&);
+
+//----------------------------------------------------------------------------
+// reaches
+// Preconditions:   build has been called, nodes are in range
+// Postconditions:  Returns true if there is a path from the first node to
+//                  the second
+    bool reaches(int, int) const;
+
+//----------------------------------------------------------------------------
+// method
+// Preconditions:   None
+// Postconditions:  Returns the method the last build used, AUTO if none
+    Method method() const;
+
+//----------------------------------------------------------------------------
+// buildMs, memoryBytes
+// Preconditions:   None
+// Postconditions:  Returns the milliseconds the last build took, and the
+//                  bytes the index holds
+    double buildMs() const;
+    size_t memoryBytes() const;
+
+private:
+    static const size_t CLOSURE_BYTES = (size_t)64 << 20;
+
+    Method chosen;                  // method asked for
+    Method used;                    // method of the last build
+    double buildTime;               // milliseconds the last build took
+    vector<int> ids;                // component of each node
+    int rowWords;                   // words of a closure row
+    vector<uint64_t> closure;       // row of bits per component
+    vector<int> outStarts;          // where each component's out labels begin
+    vector<int> outLabels;          // landmarks each component reaches
+    vector<int> inStarts;           // where each component's in labels begin
+    vector<int> inLabels;           // landmarks that reach each component
+
+//----------------------------------------------------------------------------
+// buildClosure
+// Preconditions:   Components are numbered in topological order
+// Postconditions:  Closure row of every component is made
+    void buildClosure(const EdgeRows&);
+
+//----------------------------------------------------------------------------
+// buildLabels
+// Preconditions:   Components are numbered in topological order
+// Postconditions:  2-hop labels of every component are made
+    void buildLabels(const EdgeRows&);
+
+//----------------------------------------------------------------------------
+// share
+// Preconditions:   Lists are sorted
+// Postconditions:  Returns true if the 2 lists hold a value in common
+    static bool share(const int*, const int*, const int*, const int*);
+};
+
+#endif
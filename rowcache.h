@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+// ROWCACHE.H
+// Template class for a bounded least-recently-used cache of table rows
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// RowCache: holds rows of a shortest path table keyed by source node
+// and allows other features:
+//      --lookup of the row for a source, marking it as most recently used
+//      --claiming a slot for a new row, evicting the least recently used row
+//        when the cache is full
+//      --counts of lookups that hit and missed
+//
+// Implementation and assumptions:
+//      --the number of slots comes from a memory budget divided by the bytes
+//        of one row, there is always at least 1 slot
+//      --slots are linked in use order through the newer and older arrays,
+//        an evicted slot keeps its row so its memory is reused by the next
+//        row put in it
+//      --a reference to a row is only valid until the next call to claim
+//----------------------------------------------------------------------------
+
+#ifndef ROWCACHE_H
+#define ROWCACHE_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+template <class Row>
+class RowCache {
+public:
+//----------------------------------------------------------------------------
+// Default constructor
+// Preconditions:   None
+// Postconditions:  Cache is empty with 1 slot
+    RowCache() {
+        reset(0, 1);
+    }
+
+//----------------------------------------------------------------------------
+// reset
+// Preconditions:   None
+// Postconditions:  Cache is emptied and sized to hold as many rows of the
+//                  given bytes as fit in the budget, at least 1
+    void reset(size_t budgetBytes, size_t rowBytes) {
+        size_t count = rowBytes == 0 ? 1 : budgetBytes / rowBytes;
+        capacity = count < 1 ? 1 : count;
+        rows.clear();
+        source.clear();
+        newer.clear();
+        older.clear();
+        slotOf.clear();
+        newest = oldest = -1;
+        hitCount = missCount = 0;
+    }
+
+//----------------------------------------------------------------------------
+// find
+// Preconditions:   None
+// Postconditions:  Returns the row for the source and marks it as most
+//                  recently used, nullptr if the row is not cached
+    Row* find(int key) {
+        typename unordered_map<int, int>::iterator it = slotOf.find(key);
+        if(it == slotOf.end()) {
+            missCount++;
+            return nullptr;
+        }
+        hitCount++;
+        unlink(it->second);
+        pushNewest(it->second);
+        return &rows[it->second];
+    }
+
+//----------------------------------------------------------------------------
+// claim
+// Preconditions:   Row for the source is not cached
+// Postconditions:  Returns the slot's row for the source, most recently used,
+//                  the row holds whatever the slot last held
+    Row& claim(int key) {
+        int slot;
+        if(rows.size() < capacity) {
+            slot = rows.size();
+            rows.push_back(Row());
+            source.push_back(key);
+            newer.push_back(-1);
+            older.push_back(-1);
+        }
+        else {
+            slot = oldest;
+            unlink(slot);
+            slotOf.erase(source[slot]);
+            source[slot] = key;
+        }
+        slotOf[key] = slot;
+        pushNewest(slot);
+        return rows[slot];
+    }
+
+//----------------------------------------------------------------------------
+// clear
+// Preconditions:   None
+// Postconditions:  Every row is dropped, the slot count stays the same
+    void clear() {
+        slotOf.clear();
+        rows.clear();
+        source.clear();
+        newer.clear();
+        older.clear();
+        newest = oldest = -1;
+    }
+
+//----------------------------------------------------------------------------
+// cached
+// Preconditions:   None
+// Postconditions:  Returns the sources of every cached row
+    vector<int> cached() const {
+        return vector<int>(source.begin(), source.end());
+    }
+
+//----------------------------------------------------------------------------
+// rowAt
+// Preconditions:   slot is less than size
+// Postconditions:  Returns the row held in the slot, the use order is not
+//                  changed
+    Row& rowAt(size_t slot) {
+        return rows[slot];
+    }
+
+//----------------------------------------------------------------------------
+// size, slots, hits, misses
+// Preconditions:   None
+// Postconditions:  Returns the number of rows held, the most rows that can be
+//                  held, and the lookups that found and did not find a row
+    size_t size() const { return rows.size(); }
+    size_t slots() const { return capacity; }
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+
+private:
+    size_t capacity;                // most rows held at once
+    vector<Row> rows;               // row of each slot
+    vector<int> source;             // source node of each slot
+    vector<int> newer;              // next more recently used slot
+    vector<int> older;              // next less recently used slot
+    unordered_map<int, int> slotOf; // slot holding each source
+    int newest;                     // most recently used slot, -1 if none
+    int oldest;                     // least recently used slot, -1 if none
+    size_t hitCount;                // finds that returned a row
+    size_t missCount;               // finds that returned nullptr
+
+//----------------------------------------------------------------------------
+// unlink
+// Preconditions:   Slot is in the use order list
+// Postconditions:  Slot is taken out of the use order list
+    void unlink(int slot) {
+        if(newer[slot] != -1) {
+            older[newer[slot]] = older[slot];
+        }
+        else {
+            newest = older[slot];
+        }
+        if(older[slot] != -1) {
+            newer[older[slot]] = newer[slot];
+        }
+        else {
+            oldest = newer[slot];
+        }
+        newer[slot] = older[slot] = -1;
+    }
+
+//----------------------------------------------------------------------------
+// pushNewest
+// Preconditions:   Slot is not in the use order list
+// Postconditions:  Slot is the most recently used
+    void pushNewest(int slot) {
+        older[slot] = newest;
+        newer[slot] = -1;
+        if(newest != -1) {
+            newer[newest] = slot;
+        }
+        newest = slot;
+        if(oldest == -1) {
+            oldest = slot;
+        }
+    }
+};
+
+#endif
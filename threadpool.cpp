@@ -0,0 +1,178 @@
+//----------------------------------------------------------------------------
+// THREADPOOL.CPP
+// Implementation for ThreadPool Class
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ThreadPool: runs independent pieces of work across threads
+// and allows other features:
+//      --running a task for every index of a range, spread over the threads,
+//        waiting until every index is done
+//      --passing each task the id of the worker running it, so callers can
+//        keep per-worker scratch space
+//
+// Implementation and assumptions:
+//      --the calling thread is worker 0, a pool of n threads starts n - 1
+//        background threads which sleep between jobs
+//      --a range is cut into chunks which are dealt round-robin to one queue
+//        per worker, a worker takes chunks from the back of its own queue and
+//        steals from the front of the other queues when it runs out
+//      --each queue sits on its own cache line so workers do not false-share
+//      --one job runs at a time, concurrent calls to parallelFor wait
+//      --tasks must not throw and must not call parallelFor on the same pool
+//      --must be compiled with -pthread
+//----------------------------------------------------------------------------
+
+#include "threadpool.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   None
+// Postconditions:  Pool of the given number of workers is started, 0 or less
+//                  uses the number of hardware threads
+ThreadPool::ThreadPool(int count)
+    : queues(count > 0 ? count : hardwareThreads()), job(nullptr), pending(0),
+      generation(0), busy(0), stopping(false) {
+    for(int id = 1; id < (int)queues.size(); id++) {
+        threads.push_back(thread(&ThreadPool::workerLoop, this, id));
+    }
+}
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   No job is running
+// Postconditions:  Background threads are stopped and joined
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(thread& t : threads) {
+        t.join();
+    }
+}
+
+//----------------------------------------------------------------------------
+// threadCount
+// Preconditions:   None
+// Postconditions:  Returns the number of workers, including the caller
+int ThreadPool::threadCount() const {
+    return queues.size();
+}
+
+//----------------------------------------------------------------------------
+// parallelFor
+// Preconditions:   None
+// Postconditions:  task(index, worker) has been called once for every index
+//                  from begin up to end, indices are handed out in chunks of
+//                  the grain size, worker is in the range 0 to threadCount
+void ThreadPool::parallelFor(int begin, int end, int grain,
+                             const function<void(int, int)>& task) {
+    if(begin >= end) {
+        return;
+    }
+    if(grain < 1) {
+        grain = 1;
+    }
+    lock_guard<mutex> oneJob(jobLock);
+
+    // Deal the chunks round-robin over the worker queues
+    int chunks = 0;
+    {
+        lock_guard<mutex> guard(lock);
+        job = &task;
+        for(int first = begin; first < end; first += grain) {
+            WorkQueue& queue = queues[chunks % queues.size()];
+            lock_guard<mutex> queueGuard(queue.lock);
+            queue.chunks.push_back(Range{first, min(first + grain, end)});
+            chunks++;
+        }
+        pending = chunks;
+        generation++;
+    }
+    wake.notify_all();
+
+    // The caller works as worker 0, then waits for the stragglers
+    work(0);
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this] { return pending == 0 && busy == 0; });
+    job = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// hardwareThreads
+// Preconditions:   None
+// Postconditions:  Returns the number of hardware threads, at least 1
+int ThreadPool::hardwareThreads() {
+    int count = thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+//----------------------------------------------------------------------------
+// workerLoop
+// Preconditions:   Called once per background thread
+// Postconditions:  Runs each job's chunks until the pool stops
+void ThreadPool::workerLoop(int id) {
+    int seen = 0;
+    for(;;) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if(stopping) {
+                return;
+            }
+            seen = generation;
+            busy++;
+        }
+        work(id);
+        {
+            lock_guard<mutex> guard(lock);
+            busy--;
+        }
+        done.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------
+// work
+// Preconditions:   A job is running
+// Postconditions:  Chunks are run until no queue has chunks left
+void ThreadPool::work(int id) {
+    Range range;
+    while(take(id, range)) {
+        for(int i = range.begin; i < range.end; i++) {
+            (*job)(i, id);
+        }
+        if(--pending == 0) {
+            lock_guard<mutex> guard(lock);
+            done.notify_all();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// take
+// Preconditions:   None
+// Postconditions:  Returns true and the next chunk for the worker, taken from
+//                  its own queue or stolen from another, false if none left
+bool ThreadPool::take(int id, Range& range) {
+    int count = queues.size();
+    for(int k = 0; k < count; k++) {
+        WorkQueue& queue = queues[(id + k) % count];
+        lock_guard<mutex> guard(queue.lock);
+        if(queue.chunks.empty()) {
+            continue;
+        }
+        if(k == 0) {
+            range = queue.chunks.back();        // own queue, newest first
+            queue.chunks.pop_back();
+        }
+        else {
+            range = queue.chunks.front();       // steal the oldest chunk
+            queue.chunks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------------
+// THREADPOOL.H
+// Class for a work-stealing pool of worker threads
+// Coded by: Austin Barracliffe
+//----------------------------------------------------------------------------
+// ThreadPool: runs independent pieces of work across threads
+// and allows other features:
+//      --running a task for every index of a range, spread over the threads,
+//        waiting until every index is done
+//      --passing each task the id of the worker running it, so callers can
+//        keep per-worker scratch space
+//
+// Implementation and assumptions:
+//      --the calling thread is worker 0, a pool of n threads starts n - 1
+//        background threads which sleep between jobs
+//      --a range is cut into chunks which are dealt round-robin to one queue
+//        per worker, a worker takes chunks from the back of its own queue and
+//        steals from the front of the other queues when it runs out
+//      --each queue sits on its own cache line so workers do not false-share
+//      --one job runs at a time, concurrent calls to parallelFor wait
+//      --tasks must not throw and must not call parallelFor on the same pool
+//      --must be compiled with -pthread
+//----------------------------------------------------------------------------
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool {
+public:
+//----------------------------------------------------------------------------
+// Constructor
+// Preconditions:   None
+// Postconditions:  Pool of the given number of workers is started, 0 or less
+//                  uses the number of hardware threads
+    explicit ThreadPool(int);
+
+//----------------------------------------------------------------------------
+// Destructor
+// Preconditions:   No job is running
+// Postconditions:  Background threads are stopped and joined
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+//----------------------------------------------------------------------------
+// threadCount
+// Preconditions:   None
+// Postconditions:  Returns the number of workers, including the caller
+    int threadCount() const;
+
+//----------------------------------------------------------------------------
+// parallelFor
+// Preconditions:   None
+// Postconditions:  task(index, worker) has been called once for every index
+//                  from begin up to end, indices are handed out in chunks of
+//                  the grain size, worker is in the range 0 to threadCount
+    void parallelFor(int, int, int, const function<void(int, int)>&);
+
+//----------------------------------------------------------------------------
+// hardwareThreads
+// Preconditions:   None
+// Postconditions:  Returns the number of hardware threads, at least 1
+    static int hardwareThreads();
+
+private:
+    struct Range {
+        int begin;      // first index of the chunk
+        int end;        // one past the last index of the chunk
+    };
+
+    struct alignas(64) WorkQueue {
+        mutex lock;             // guards chunks
+        deque<Range> chunks;    // chunks waiting to run
+    };
+
+    vector<thread> threads;             // background workers 1 to n - 1
+    vector<WorkQueue> queues;           // one queue per worker
+    const function<void(int, int)>* job;    // task of the running job
+    atomic<int> pending;                // chunks of the job not yet done
+    mutex lock;                         // guards generation, busy, stopping
+    mutex jobLock;                      // lets one parallelFor run at a time
+    condition_variable wake;            // signals workers that a job started
+    condition_variable done;            // signals the caller a job finished
+    int generation;                     // count of jobs started
+    int busy;                           // background workers inside a job
+    bool stopping;                      // set when the pool is destroyed
+
+//----------------------------------------------------------------------------
+// workerLoop
+// Preconditions:   Called once per background thread
+// Postconditions:  Runs each job's chunks until the pool stops
+    void workerLoop(int);
+
+//----------------------------------------------------------------------------
+// work
+// Preconditions:   A job is running
+// Postconditions:  Chunks are run until no queue has chunks left
+    void work(int);
+
+//----------------------------------------------------------------------------
+// take
+// Preconditions:   None
+// Postconditions:  Returns true and the next chunk for the worker, taken from
+//                  its own queue or stolen from another, false if none left
+    bool take(int, Range&);
+};
+
+#endif